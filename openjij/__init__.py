@@ -7,5 +7,5 @@ from .variable_type import SPIN, BINARY, cast_var_type, VariableType
 from .sampler import Response
 from .sampler import SASampler, SQASampler, CSQASampler
 from .sampler import GPUSQASampler, GPUSASampler, CMOSAnnealer
-from .model import BinaryQuadraticModel, KingGraph, ChimeraModel
+from .model import BinaryQuadraticModel, KingGraph, ChimeraModel, PreparedModel
 from .utils import solver_benchmark, convert_response
@@ -25,6 +25,7 @@
 #include <pybind11/stl.h>
 #include <pybind11/functional.h>
 #include <pybind11/eigen.h>
+#include <pybind11/numpy.h>
 
 namespace py = pybind11;
 
@@ -47,11 +48,26 @@ inline void declare_Graph(py::module& m){
 }
 
 //dense
+template<typename FloatType, typename T, int ExtraFlags>
+inline graph::Dense<FloatType> make_dense_from_array(const py::array_t<T, ExtraFlags>& matrix){
+    if(matrix.ndim() != 2 || matrix.shape(0) != matrix.shape(1)){
+        throw std::invalid_argument("matrix must be a two-dimensional square array.");
+    }
+    //read the buffer directly (C-contiguous)
+    return graph::Dense<FloatType>(static_cast<std::size_t>(matrix.shape(0)), matrix.data());
+}
+
 template<typename FloatType>
 inline void declare_Dense(py::module& m, const std::string& suffix){
     auto str = std::string("Dense") + suffix;
     py::class_<graph::Dense<FloatType>, graph::Graph>(m, str.c_str())
         .def(py::init<std::size_t>(), "num_spins"_a)
+        .def(py::init([](const py::array_t<double, py::array::c_style | py::array::forcecast>& matrix){
+                    return make_dense_from_array<FloatType>(matrix);
+                    }), "matrix"_a)
+        .def(py::init([](const py::array_t<float, py::array::c_style>& matrix){
+                    return make_dense_from_array<FloatType>(matrix);
+                    }), "matrix"_a)
         .def(py::init<const graph::Dense<FloatType>&>(), "other"_a)
         .def("adj_nodes", &graph::Dense<FloatType>::adj_nodes)
         .def("calc_energy", &graph::Dense<FloatType>::calc_energy, "spins"_a)
@@ -68,6 +84,16 @@ inline void declare_Sparse(py::module& m, const std::string& suffix){
     py::class_<graph::Sparse<FloatType>, graph::Graph>(m, str.c_str())
         .def(py::init<std::size_t, std::size_t>(), "num_spins"_a, "num_edges"_a)
         .def(py::init<std::size_t>(),  "num_spins"_a)
+        .def(py::init([](std::size_t num_spins,
+                        const py::array_t<std::int64_t, py::array::c_style | py::array::forcecast>& row,
+                        const py::array_t<std::int64_t, py::array::c_style | py::array::forcecast>& col,
+                        const py::array_t<double, py::array::c_style | py::array::forcecast>& value){
+                    if(row.ndim() != 1 || col.ndim() != 1 || value.ndim() != 1 || row.size() != col.size() || row.size() != value.size()){
+                        throw std::invalid_argument("row, col and value must be one-dimensional arrays of the same length.");
+                    }
+                    //sort and deduplicate natively (e.g. scipy.sparse.coo_matrix: row, col, data)
+                    return graph::Sparse<FloatType>(num_spins, row.data(), col.data(), value.data(), static_cast<std::size_t>(value.size()));
+                    }), "num_spins"_a, "row"_a, "col"_a, "value"_a)
         .def(py::init<const graph::Sparse<FloatType>&>(), "other"_a)
         .def("adj_nodes", &graph::Sparse<FloatType>::adj_nodes)
         .def("get_num_edges", &graph::Sparse<FloatType>::get_num_edges)
@@ -78,6 +104,196 @@ inline void declare_Sparse(py::module& m, const std::string& suffix){
         .def("__getitem__", [](const graph::Sparse<FloatType>& self, std::size_t key){return self.h(key);}, "key"_a);
 }
 
+//reordered sparse
+template<typename FloatType>
+inline void declare_ReorderedSparse(py::module& m, const std::string& suffix){
+    using ReorderedSparse = graph::ReorderedSparse<FloatType>;
+    auto str = std::string("ReorderedSparse") + suffix;
+    py::class_<ReorderedSparse, graph::Sparse<FloatType>>(m, str.c_str())
+        .def(py::init<const graph::Dense<FloatType>&>(), "graph"_a)
+        .def(py::init<const graph::Sparse<FloatType>&>(), "graph"_a)
+        .def(py::init<const graph::Sparse<FloatType>&, std::vector<graph::Index>>(), "graph"_a, "order"_a)
+        .def(py::init<const ReorderedSparse&>(), "other"_a)
+        .def("get_order", &ReorderedSparse::get_order)
+        .def("to_original", &ReorderedSparse::to_original, "spins"_a)
+        .def("to_reordered", &ReorderedSparse::to_reordered, "spins"_a);
+}
+
+//csr sparse
+template<typename FloatType>
+inline void declare_CSRSparse(py::module& m, const std::string& suffix){
+    auto str = std::string("CSRSparse") + suffix;
+    py::class_<graph::CSRSparse<FloatType>, graph::Graph>(m, str.c_str())
+        .def(py::init<const graph::Dense<FloatType>&>(), "graph"_a)
+        .def(py::init<const graph::Sparse<FloatType>&>(), "graph"_a)
+        .def(py::init<const graph::CSRSparse<FloatType>&>(), "other"_a)
+        .def("degree", &graph::CSRSparse<FloatType>::degree, "ind"_a)
+        .def("get_num_stored_edges", &graph::CSRSparse<FloatType>::get_num_stored_edges)
+        .def("calc_energy", &graph::CSRSparse<FloatType>::calc_energy, "spins"_a)
+        .def("__getitem__", [](const graph::CSRSparse<FloatType>& self, const std::pair<std::size_t, std::size_t>& key){return self.J(key.first, key.second);}, "key"_a)
+        .def("__getitem__", [](const graph::CSRSparse<FloatType>& self, std::size_t key){return self.h(key);}, "key"_a);
+
+    //binary format (the loaded graph views a read-only memory-mapped file)
+    m.def("save_binary", [](const graph::CSRSparse<FloatType>& graph, const std::string& path){graph::save_binary(graph, path);}, "graph"_a, "path"_a);
+    m.def((std::string("load_csr_sparse") + suffix).c_str(), &graph::load_csr_sparse<FloatType>, "path"_a);
+}
+
+//dense matrix
+template<typename FloatType>
+inline void declare_DenseMatrix(py::module& m, const std::string& suffix){
+    auto str = std::string("DenseMatrix") + suffix;
+    py::class_<graph::DenseMatrix<FloatType>, graph::Graph>(m, str.c_str())
+        .def(py::init<const graph::Dense<FloatType>&>(), "graph"_a)
+        .def(py::init([](const py::array_t<double, py::array::c_style | py::array::forcecast>& matrix){
+                    if(matrix.ndim() != 2 || matrix.shape(0) != matrix.shape(1)){
+                        throw std::invalid_argument("matrix must be a two-dimensional square array.");
+                    }
+                    return graph::DenseMatrix<FloatType>(static_cast<std::size_t>(matrix.shape(0)), matrix.data());
+                    }), "matrix"_a)
+        .def(py::init<const graph::DenseMatrix<FloatType>&>(), "other"_a)
+        .def("calc_energy", &graph::DenseMatrix<FloatType>::calc_energy, "spins"_a)
+        .def("__getitem__", [](const graph::DenseMatrix<FloatType>& self, const std::pair<std::size_t, std::size_t>& key){return self.J(key.first, key.second);}, "key"_a)
+        .def("__getitem__", [](const graph::DenseMatrix<FloatType>& self, std::size_t key){return self.h(key);}, "key"_a);
+
+    //binary format (the loaded graph views a read-only memory-mapped file)
+    m.def("save_binary", [](const graph::DenseMatrix<FloatType>& graph, const std::string& path){graph::save_binary(graph, path);}, "graph"_a, "path"_a);
+    m.def((std::string("load_dense_matrix") + suffix).c_str(), &graph::load_dense_matrix<FloatType>, "path"_a);
+}
+
+//quantized graphs
+template<typename IntType, typename FloatType>
+inline void declare_QuantizedDense(py::module& m, const std::string& suffix){
+    using QuantizedDense = graph::QuantizedDense<IntType, FloatType>;
+    auto str = std::string("QuantizedDense") + suffix;
+    py::class_<QuantizedDense, graph::Graph>(m, str.c_str())
+        .def(py::init<const graph::Dense<FloatType>&, FloatType>(), "graph"_a, "scale"_a=1)
+        .def(py::init<const graph::Sparse<FloatType>&, FloatType>(), "graph"_a, "scale"_a=1)
+        .def(py::init<const QuantizedDense&>(), "other"_a)
+        .def("get_scale", &QuantizedDense::get_scale)
+        .def("calc_energy", &QuantizedDense::calc_energy, "spins"_a)
+        .def("__getitem__", [](const QuantizedDense& self, const std::pair<std::size_t, std::size_t>& key){return self.J(key.first, key.second);}, "key"_a)
+        .def("__getitem__", [](const QuantizedDense& self, std::size_t key){return self.h(key);}, "key"_a);
+}
+
+template<typename IntType, typename FloatType>
+inline void declare_QuantizedSparse(py::module& m, const std::string& suffix){
+    using QuantizedSparse = graph::QuantizedSparse<IntType, FloatType>;
+    auto str = std::string("QuantizedSparse") + suffix;
+    py::class_<QuantizedSparse, graph::Graph>(m, str.c_str())
+        .def(py::init<const graph::Dense<FloatType>&, FloatType>(), "graph"_a, "scale"_a=1)
+        .def(py::init<const graph::Sparse<FloatType>&, FloatType>(), "graph"_a, "scale"_a=1)
+        .def(py::init<const QuantizedSparse&>(), "other"_a)
+        .def("get_scale", &QuantizedSparse::get_scale)
+        .def("degree", &QuantizedSparse::degree, "ind"_a)
+        .def("get_num_stored_edges", &QuantizedSparse::get_num_stored_edges)
+        .def("calc_energy", &QuantizedSparse::calc_energy, "spins"_a)
+        .def("__getitem__", [](const QuantizedSparse& self, const std::pair<std::size_t, std::size_t>& key){return self.J(key.first, key.second);}, "key"_a)
+        .def("__getitem__", [](const QuantizedSparse& self, std::size_t key){return self.h(key);}, "key"_a);
+}
+
+//text parser
+inline void declare_TextFormat(py::module& m){
+    py::enum_<graph::TextFormat>(m, "TextFormat")
+        .value("EdgeList", graph::TextFormat::EdgeList)
+        .value("Gset", graph::TextFormat::Gset);
+
+    py::register_exception<graph::ParseError>(m, "ParseError");
+}
+
+template<typename FloatType>
+inline void declare_parse_sparse(py::module& m, const std::string& suffix){
+    //the file is parsed by native threads without holding the GIL
+    m.def((std::string("parse_sparse") + suffix).c_str(), [](const std::string& path, graph::TextFormat format, std::size_t num_threads){
+            return graph::parse_sparse<FloatType>(path, format, num_threads);
+            }, "path"_a, "format"_a=graph::TextFormat::EdgeList, "num_threads"_a=0, py::call_guard<py::gil_scoped_release>());
+}
+
+//delta (changed interactions)
+template<typename FloatType>
+inline void declare_Delta(py::module& m, const std::string& suffix){
+    using Delta = graph::Delta<FloatType>;
+    auto str = std::string("Delta") + suffix;
+    py::class_<Delta>(m, str.c_str())
+        .def(py::init<>())
+        .def("set_J", &Delta::set_J, "i"_a, "j"_a, "value"_a)
+        .def("set_h", &Delta::set_h, "i"_a, "value"_a)
+        .def("__setitem__", [](Delta& self, const std::pair<std::size_t, std::size_t>& key, FloatType val){
+                if(key.first == key.second) self.set_h(key.first, val);
+                else self.set_J(key.first, key.second, val);
+                }, "key"_a, "val"_a)
+        .def("__setitem__", [](Delta& self, std::size_t key, FloatType val){self.set_h(key, val);}, "key"_a, "val"_a)
+        .def("__len__", &Delta::size)
+        .def("clear", &Delta::clear)
+        .def("apply", [](const Delta& self, graph::Dense<FloatType>& graph){self.apply(graph);}, "graph"_a)
+        .def("apply", [](const Delta& self, graph::Sparse<FloatType>& graph){self.apply(graph);}, "graph"_a);
+}
+
+//enum class Vartype
+inline void declare_Vartype(py::module& m){
+    py::enum_<graph::Vartype>(m, "Vartype")
+        .value("SPIN", graph::Vartype::SPIN)
+        .value("BINARY", graph::Vartype::BINARY);
+}
+
+//polynomial (higher-order) interactions
+template<typename FloatType>
+inline void declare_Polynomial(py::module& m, const std::string& suffix){
+    using Polynomial = graph::Polynomial<FloatType>;
+    auto str = std::string("Polynomial") + suffix;
+    py::class_<Polynomial, graph::Graph>(m, str.c_str())
+        //flat arrays: variables of term t are term_vars[term_offsets[t]:term_offsets[t+1]]
+        .def(py::init([](std::size_t num_spins,
+                        const py::array_t<std::int64_t, py::array::c_style | py::array::forcecast>& term_vars,
+                        const py::array_t<std::int64_t, py::array::c_style | py::array::forcecast>& term_offsets,
+                        const py::array_t<double, py::array::c_style | py::array::forcecast>& coeffs){
+                    if(term_vars.ndim() != 1 || term_offsets.ndim() != 1 || coeffs.ndim() != 1 || term_offsets.size() != coeffs.size()+1){
+                        throw std::invalid_argument("term_vars, term_offsets and coeffs must be one-dimensional arrays and term_offsets must have len(coeffs)+1 elements.");
+                    }
+                    if(term_offsets.data()[coeffs.size()] != term_vars.size()){
+                        throw std::invalid_argument("the last element of term_offsets must be len(term_vars).");
+                    }
+                    return Polynomial(num_spins, term_vars.data(), term_offsets.data(), coeffs.data(), static_cast<std::size_t>(coeffs.size()));
+                    }), "num_spins"_a, "term_vars"_a, "term_offsets"_a, "coeffs"_a)
+        //terms of the same degree: terms[t] is a row of a two-dimensional array
+        .def(py::init([](std::size_t num_spins,
+                        const py::array_t<std::int64_t, py::array::c_style | py::array::forcecast>& terms,
+                        const py::array_t<double, py::array::c_style | py::array::forcecast>& coeffs){
+                    if(terms.ndim() != 2 || coeffs.ndim() != 1 || terms.shape(0) != coeffs.size()){
+                        throw std::invalid_argument("terms must be a (len(coeffs), degree) array.");
+                    }
+                    const std::int64_t degree = terms.shape(1);
+                    std::vector<std::int64_t> term_offsets(static_cast<std::size_t>(coeffs.size())+1);
+                    for(std::size_t t=0; t<term_offsets.size(); t++){
+                        term_offsets[t] = static_cast<std::int64_t>(t)*degree;
+                    }
+                    return Polynomial(num_spins, terms.data(), term_offsets.data(), coeffs.data(), static_cast<std::size_t>(coeffs.size()));
+                    }), "num_spins"_a, "terms"_a, "coeffs"_a)
+        .def(py::init<std::size_t, const std::vector<std::vector<graph::Index>>&, const std::vector<FloatType>&>(), "num_spins"_a, "terms"_a, "coeffs"_a)
+        .def(py::init<const Polynomial&>(), "other"_a)
+        .def("get_num_terms", &Polynomial::get_num_terms)
+        .def("calc_energy", &Polynomial::calc_energy, "spins"_a);
+}
+
+//polynomial reduced to a quadratic model
+template<typename FloatType>
+inline void declare_ReducedPolynomial(py::module& m, const std::string& suffix){
+    using ReducedPolynomial = graph::ReducedPolynomial<FloatType>;
+    auto str = std::string("ReducedPolynomial") + suffix;
+    py::class_<ReducedPolynomial>(m, str.c_str())
+        .def_readonly("interaction", &ReducedPolynomial::interaction)
+        .def_readonly("offset", &ReducedPolynomial::offset)
+        .def_readonly("num_variables", &ReducedPolynomial::num_variables)
+        .def_readonly("vartype", &ReducedPolynomial::vartype)
+        .def_readonly("aux_pairs", &ReducedPolynomial::aux_pairs)
+        .def_readonly("penalties", &ReducedPolynomial::penalties)
+        .def("decode", &ReducedPolynomial::decode, "spins"_a);
+
+    //the reduction runs natively without holding the GIL
+    m.def((std::string("reduce_to_quadratic") + suffix).c_str(), [](const graph::Polynomial<FloatType>& polynomial, graph::Vartype vartype, FloatType strength){
+            return graph::reduce_to_quadratic(polynomial, vartype, strength);
+            }, "polynomial"_a, "vartype"_a, "strength"_a=0, py::call_guard<py::gil_scoped_release>());
+}
+
 //enum class Dir
 inline void declare_Dir(py::module& m){
     py::enum_<graph::Dir>(m, "Dir")
@@ -104,6 +320,56 @@ inline void declare_Square(py::module& m, const std::string& suffix){
         .def("__getitem__", [](const graph::Square<FloatType>& self, const std::pair<std::size_t, std::size_t>& key){return self.h(key.first, key.second);}, "key"_a);
 }
 
+//enum class KingDir
+inline void declare_KingDir(py::module& m){
+    py::enum_<graph::KingDir>(m, "KingDir")
+        .value("PLUS_R", graph::KingDir::PLUS_R)
+        .value("MINUS_R", graph::KingDir::MINUS_R)
+        .value("PLUS_C", graph::KingDir::PLUS_C)
+        .value("MINUS_C", graph::KingDir::MINUS_C)
+        .value("PLUS_R_PLUS_C", graph::KingDir::PLUS_R_PLUS_C)
+        .value("PLUS_R_MINUS_C", graph::KingDir::PLUS_R_MINUS_C)
+        .value("MINUS_R_PLUS_C", graph::KingDir::MINUS_R_PLUS_C)
+        .value("MINUS_R_MINUS_C", graph::KingDir::MINUS_R_MINUS_C);
+}
+
+//king graph
+template<typename FloatType>
+inline void declare_KingGraph(py::module& m, const std::string& suffix){
+    auto str = std::string("KingGraph") + suffix;
+    py::class_<graph::KingGraph<FloatType>, graph::Sparse<FloatType>>(m, str.c_str())
+        .def(py::init<std::size_t, std::size_t, FloatType>(), "num_row"_a, "num_column"_a, "init_val"_a=0)
+        .def(py::init<const graph::KingGraph<FloatType>&>(), "other"_a)
+        .def("to_ind", &graph::KingGraph<FloatType>::to_ind)
+        .def("to_rc", &graph::KingGraph<FloatType>::to_rc)
+        .def("get_num_row", &graph::KingGraph<FloatType>::get_num_row)
+        .def("get_num_column", &graph::KingGraph<FloatType>::get_num_column)
+        .def("__setitem__", [](graph::KingGraph<FloatType>& self, const std::tuple<std::size_t, std::size_t, graph::KingDir>& key, FloatType val){self.J(std::get<0>(key), std::get<1>(key), std::get<2>(key)) = val;}, "key"_a, "val"_a)
+        .def("__getitem__", [](const graph::KingGraph<FloatType>& self, const std::tuple<std::size_t, std::size_t, graph::KingDir>& key){return self.J(std::get<0>(key), std::get<1>(key), std::get<2>(key));}, "key"_a)
+        .def("__setitem__", [](graph::KingGraph<FloatType>& self, const std::pair<std::size_t, std::size_t>& key, FloatType val){self.h(key.first, key.second) = val;}, "key"_a, "val"_a)
+        .def("__getitem__", [](const graph::KingGraph<FloatType>& self, const std::pair<std::size_t, std::size_t>& key){return self.h(key.first, key.second);}, "key"_a);
+}
+
+//lattice with a compile-time stencil
+template<typename LatticeType>
+inline void declare_Lattice(py::module& m, const std::string& name){
+    using Coordinate = typename LatticeType::Coordinate;
+    using FloatType = typename LatticeType::value_type;
+    py::class_<LatticeType, graph::Graph>(m, name.c_str())
+        .def(py::init<const Coordinate&, FloatType>(), "shape"_a, "init_val"_a=0)
+        .def(py::init<const LatticeType&>(), "other"_a)
+        .def("get_shape", &LatticeType::get_shape)
+        .def("to_ind", &LatticeType::to_ind)
+        .def("to_coord", &LatticeType::to_coord)
+        .def("adj_nodes", &LatticeType::adj_nodes)
+        .def("calc_energy", &LatticeType::calc_energy, "spins"_a)
+        //J: lattice[coordinate, offset number], h: lattice[coordinate]
+        .def("__setitem__", [](LatticeType& self, const std::pair<Coordinate, std::size_t>& key, FloatType val){self.J(key.first, key.second) = val;}, "key"_a, "val"_a)
+        .def("__getitem__", [](const LatticeType& self, const std::pair<Coordinate, std::size_t>& key){return self.J(key.first, key.second);}, "key"_a)
+        .def("__setitem__", [](LatticeType& self, const Coordinate& key, FloatType val){self.h(key) = val;}, "key"_a, "val"_a)
+        .def("__getitem__", [](const LatticeType& self, const Coordinate& key){return self.h(key);}, "key"_a);
+}
+
 //enum class ChimeraDir
 inline void declare_ChimeraDir(py::module& m){
     py::enum_<graph::ChimeraDir>(m, "ChimeraDir")
@@ -137,6 +403,22 @@ inline void declare_Chimera(py::module& m, const std::string& suffix){
 
 //system
 
+//interaction of a system (returned by reference, never copied)
+//held by value: kept alive by the system
+template<typename Interaction>
+inline py::object get_interaction(const Interaction& interaction, py::handle self){
+    return py::cast(interaction, py::return_value_policy::reference_internal, self);
+}
+
+//shared between the copies of a system: kept alive by an owner of its own, since update_interaction swaps
+//the shared object of the system and the old one is freed with its last owner (pinning the system would not be enough)
+template<typename Interaction>
+inline py::object get_interaction(const system::SharedInteraction<Interaction>& interaction, py::handle){
+    auto owner = new system::SharedInteraction<Interaction>(interaction);
+    py::capsule keep_alive(owner, [](void* p){delete static_cast<system::SharedInteraction<Interaction>*>(p);});
+    return py::cast(**owner, py::return_value_policy::reference_internal, keep_alive);
+}
+
 //ClassicalIsing
 template<typename GraphType, bool eigen_impl>
 inline void declare_ClassicalIsing(py::module &m, const std::string& gtype_str, const std::string& eigen_str){
@@ -146,9 +428,13 @@ inline void declare_ClassicalIsing(py::module &m, const std::string& gtype_str,
     auto str = std::string("ClassicalIsing")+gtype_str+eigen_str;
     py::class_<ClassicalIsing>(m, str.c_str())
         .def(py::init<const graph::Spins&, const GraphType&>(), "init_spin"_a, "init_interaction"_a)
+        .def(py::init<const ClassicalIsing&>(), "other"_a) //copy sharing the interaction
         .def("reset_spins", [](ClassicalIsing& self, const graph::Spins& init_spin){self.reset_spins(init_spin);},"init_spin"_a)
-        .def_readwrite("spin", &ClassicalIsing::spin)
-        .def_readonly("interaction", &ClassicalIsing::interaction)
+        .def_property("spin", [](const ClassicalIsing& self){return self.spin;}, [](ClassicalIsing& self, const decltype(ClassicalIsing::spin)& spin){
+                self.spin = spin;
+                system::invalidate_local_fields(self);
+                })
+        .def_property_readonly("interaction", [](py::object self){return get_interaction(self.cast<const ClassicalIsing&>().interaction, self);})
         .def_readonly("num_spins", &ClassicalIsing::num_spins);
 
     //make_classical_ising
@@ -159,6 +445,158 @@ inline void declare_ClassicalIsing(py::module &m, const std::string& gtype_str,
 }
 
 
+//ClassicalIsingPolynomial
+template<typename GraphType>
+inline void declare_ClassicalIsingPolynomial(py::module &m, const std::string& gtype_str){
+    using ClassicalIsingPolynomial = system::ClassicalIsingPolynomial<GraphType>;
+
+    auto str = std::string("ClassicalIsingPolynomial")+gtype_str;
+    py::class_<ClassicalIsingPolynomial>(m, str.c_str())
+        .def(py::init<const graph::Spins&, const GraphType&, graph::Vartype>(), "init_spin"_a, "init_interaction"_a, "vartype"_a)
+        .def("reset_spins", [](ClassicalIsingPolynomial& self, const graph::Spins& init_spin){self.reset_spins(init_spin);},"init_spin"_a)
+        .def_readonly("spin", &ClassicalIsingPolynomial::spin)
+        .def_readonly("interaction", &ClassicalIsingPolynomial::interaction)
+        .def_readonly("vartype", &ClassicalIsingPolynomial::vartype)
+        .def_readonly("num_spins", &ClassicalIsingPolynomial::num_spins);
+
+    //make_classical_ising_polynomial
+    m.def("make_classical_ising_polynomial", [](const graph::Spins& init_spin, const GraphType& init_interaction, graph::Vartype vartype){
+            return system::make_classical_ising_polynomial(init_spin, init_interaction, vartype);
+            }, "init_spin"_a, "init_interaction"_a, "vartype"_a);
+}
+
+//ClassicalIsingPacked / TransverseIsingPacked (bit-packed spins, unpacked at the Python boundary)
+template<typename GraphType>
+inline void declare_PackedIsing(py::module &m, const std::string& gtype_str){
+    using ClassicalIsingPacked = system::ClassicalIsingPacked<GraphType>;
+    using TransverseIsingPacked = system::TransverseIsingPacked<GraphType>;
+    using FloatType = typename GraphType::value_type;
+
+    auto str = std::string("ClassicalIsingPacked")+gtype_str;
+    py::class_<ClassicalIsingPacked>(m, str.c_str())
+        .def(py::init<const graph::Spins&, const GraphType&>(), "init_spin"_a, "init_interaction"_a)
+        .def("reset_spins", [](ClassicalIsingPacked& self, const graph::Spins& init_spin){self.reset_spins(init_spin);},"init_spin"_a)
+        .def_property_readonly("spin", [](const ClassicalIsingPacked& self){return self.spin.to_spins();})
+        .def_readonly("interaction", &ClassicalIsingPacked::interaction)
+        .def_readonly("num_spins", &ClassicalIsingPacked::num_spins);
+
+    m.def("make_classical_ising_packed", [](const graph::Spins& init_spin, const GraphType& init_interaction){
+            return system::make_classical_ising_packed(init_spin, init_interaction);
+            }, "init_spin"_a, "init_interaction"_a);
+
+    str = std::string("TransverseIsingPacked")+gtype_str;
+    py::class_<TransverseIsingPacked>(m, str.c_str())
+        .def(py::init<const system::TrotterSpins&, const GraphType&, FloatType>(), "init_spin"_a, "init_interaction"_a, "gamma"_a)
+        .def(py::init<const graph::Spins&, const GraphType&, FloatType, size_t>(), "init_classical_spins"_a, "init_interaction"_a, "gamma"_a, "num_trotter_slices"_a)
+        .def("reset_spins", [](TransverseIsingPacked& self, const system::TrotterSpins& init_trotter_spins){self.reset_spins(init_trotter_spins);},"init_trotter_spins"_a)
+        .def("reset_spins", [](TransverseIsingPacked& self, const graph::Spins& classical_spins){self.reset_spins(classical_spins);},"classical_spins"_a)
+        .def_property_readonly("trotter_spins", [](const TransverseIsingPacked& self){
+                system::TrotterSpins ret;
+                for(auto&& spins : self.trotter_spins) ret.push_back(spins.to_spins());
+                return ret;
+                })
+        .def_readonly("interaction", &TransverseIsingPacked::interaction)
+        .def_readonly("num_classical_spins", &TransverseIsingPacked::num_classical_spins)
+        .def_readwrite("gamma", &TransverseIsingPacked::gamma);
+
+    m.def("make_transverse_ising_packed", [](const graph::Spins& classical_spins, const GraphType& init_interaction, double gamma, std::size_t num_trotter_slices){
+            return system::make_transverse_ising_packed(classical_spins, init_interaction, gamma, num_trotter_slices);
+            }, "classical_spins"_a, "init_interaction"_a, "gamma"_a, "num_trotter_slices"_a);
+}
+
+//MultiSpinClassicalIsing (64 replicas packed bitwise)
+template<typename GraphType>
+inline void declare_MultiSpinClassicalIsing(py::module &m, const std::string& gtype_str){
+    using MultiSpinClassicalIsing = system::MultiSpinClassicalIsing<GraphType>;
+
+    auto str = std::string("MultiSpinClassicalIsing")+gtype_str;
+    py::class_<MultiSpinClassicalIsing>(m, str.c_str())
+        .def(py::init<const std::vector<graph::Spins>&, const GraphType&>(), "init_spins"_a, "init_interaction"_a)
+        .def("reset_spins", [](MultiSpinClassicalIsing& self, const std::vector<graph::Spins>& init_spins){self.reset_spins(init_spins);},"init_spins"_a)
+        .def("get_replica", &MultiSpinClassicalIsing::get_replica, "replica"_a)
+        .def_readonly("interaction", &MultiSpinClassicalIsing::interaction)
+        .def_readonly("num_spins", &MultiSpinClassicalIsing::num_spins)
+        .def_property_readonly_static("num_replicas", [](py::object){return MultiSpinClassicalIsing::num_replicas;});
+
+    m.def("make_multi_spin_classical_ising", [](const std::vector<graph::Spins>& init_spins, const GraphType& init_interaction){
+            return system::make_multi_spin_classical_ising(init_spins, init_interaction);
+            }, "init_spins"_a, "init_interaction"_a);
+}
+
+//BatchedClassicalIsing (replicas in structure-of-arrays layout)
+template<typename GraphType>
+inline void declare_BatchedClassicalIsing(py::module &m, const std::string& gtype_str){
+    using BatchedClassicalIsing = system::BatchedClassicalIsing<GraphType>;
+
+    auto str = std::string("BatchedClassicalIsing")+gtype_str;
+    py::class_<BatchedClassicalIsing>(m, str.c_str())
+        .def(py::init<const std::vector<graph::Spins>&, const GraphType&>(), "init_spins"_a, "init_interaction"_a)
+        .def("reset_spins", [](BatchedClassicalIsing& self, const std::vector<graph::Spins>& init_spins){self.reset_spins(init_spins);},"init_spins"_a)
+        .def("get_replica", &BatchedClassicalIsing::get_replica, "replica"_a)
+        .def_readonly("num_spins", &BatchedClassicalIsing::num_spins)
+        .def_readonly("num_replicas", &BatchedClassicalIsing::num_replicas);
+
+    m.def("make_batched_classical_ising", [](const std::vector<graph::Spins>& init_spins, const GraphType& init_interaction){
+            return system::make_batched_classical_ising(init_spins, init_interaction);
+            }, "init_spins"_a, "init_interaction"_a);
+}
+
+//PreparedProblem (graph and its derived forms cached for repeated sampling)
+template<typename GraphType>
+inline void declare_PreparedProblem(py::module &m, const std::string& gtype_str){
+    using PreparedProblem = system::PreparedProblem<GraphType>;
+
+    auto str = std::string("PreparedProblem")+gtype_str;
+    py::class_<PreparedProblem>(m, str.c_str())
+        .def(py::init<const GraphType&>(), "graph"_a)
+        .def_property_readonly("graph", [](const PreparedProblem& self) -> const GraphType& {return *self.get_graph();},
+                py::return_value_policy::reference_internal)
+        .def("get_num_spins", &PreparedProblem::get_num_spins)
+        .def("beta_range", &PreparedProblem::get_beta_range)
+        .def("coloring", &PreparedProblem::get_coloring)
+        .def("num_colors", &PreparedProblem::get_num_colors)
+        .def("degree_statistics", [](const PreparedProblem& self){
+                const auto& statistics = self.get_degree_statistics();
+                return py::dict("min_degree"_a=statistics.min_degree, "max_degree"_a=statistics.max_degree, "mean_degree"_a=statistics.mean_degree);
+                });
+
+    m.def("make_prepared_problem", [](const GraphType& graph){
+            return std::unique_ptr<PreparedProblem>(new PreparedProblem(graph));
+            }, "graph"_a);
+
+    //systems sharing the interaction with the problem
+    m.def("make_classical_ising", [](const graph::Spins& init_spin, const PreparedProblem& problem){
+            return system::make_classical_ising(init_spin, problem);
+            }, "init_spin"_a, "problem"_a);
+
+    m.def("make_classical_ising_Eigen", [](const graph::Spins& init_spin, const PreparedProblem& problem){
+            return system::make_classical_ising<true>(init_spin, problem);
+            }, "init_spin"_a, "problem"_a);
+
+    m.def("make_classical_ising_CSRSparse", [](const graph::Spins& init_spin, const PreparedProblem& problem){
+            return system::make_classical_ising_csr(init_spin, problem);
+            }, "init_spin"_a, "problem"_a);
+}
+
+//trotter spins of TransverseIsing (std::vector based in Python, contiguous in C++)
+inline system::TrotterSpins get_trotter_spins(const system::ContiguousTrotterSpins& trotter_spins){
+    return trotter_spins.to_trotter_spins();
+}
+
+inline void set_trotter_spins(system::ContiguousTrotterSpins& dst, const system::TrotterSpins& src){
+    dst = system::ContiguousTrotterSpins(src);
+}
+
+template<typename TrotterMatrix>
+inline TrotterMatrix get_trotter_spins(const TrotterMatrix& trotter_spins){
+    return trotter_spins;
+}
+
+template<typename TrotterMatrix>
+inline void set_trotter_spins(TrotterMatrix& dst, const TrotterMatrix& src){
+    dst = src;
+}
+
 //TransverseIsing
 template<typename GraphType, bool eigen_impl>
 inline void declare_TransverseIsing(py::module &m, const std::string& gtype_str, const std::string& eigen_str){
@@ -170,10 +608,15 @@ inline void declare_TransverseIsing(py::module &m, const std::string& gtype_str,
     py::class_<TransverseIsing>(m, str.c_str())
         .def(py::init<const system::TrotterSpins&, const GraphType&, FloatType>(), "init_spin"_a, "init_interaction"_a, "gamma"_a)
         .def(py::init<const graph::Spins&, const GraphType&, FloatType, size_t>(), "init_classical_spins"_a, "init_interaction"_a, "gamma"_a, "num_trotter_slices"_a)
+        .def(py::init<const TransverseIsing&>(), "other"_a) //copy sharing the interaction
         .def("reset_spins", [](TransverseIsing& self, const system::TrotterSpins& init_trotter_spins){self.reset_spins(init_trotter_spins);},"init_trotter_spins"_a)
         .def("reset_spins", [](TransverseIsing& self, const graph::Spins& classical_spins){self.reset_spins(classical_spins);},"classical_spins"_a)
-        .def_readwrite("trotter_spins", &TransverseIsing::trotter_spins)
-        .def_readonly("interaction", &TransverseIsing::interaction)
+        .def_property("trotter_spins", [](const TransverseIsing& self){return get_trotter_spins(self.trotter_spins);},
+                [](TransverseIsing& self, const decltype(get_trotter_spins(std::declval<TransverseIsing&>().trotter_spins))& trotter_spins){
+                set_trotter_spins(self.trotter_spins, trotter_spins);
+                self.invalidate_local_fields();
+                })
+        .def_property_readonly("interaction", [](py::object self){return get_interaction(self.cast<const TransverseIsing&>().interaction, self);})
         .def_readonly("num_classical_spins", &TransverseIsing::num_classical_spins)
         .def_readwrite("gamma", &TransverseIsing::gamma);
 
@@ -200,10 +643,13 @@ inline void declare_ContinuousTimeIsing(py::module &m, const std::string& gtype_
     py::class_<TransverseIsing>(m, str.c_str())
         .def(py::init<const SpinConfiguration&, const GraphType&, FloatType>(), "init_spin_config"_a, "init_interaction"_a, "gamma"_a)
         .def(py::init<const graph::Spins&, const GraphType&, FloatType>(), "init_spins"_a, "init_interaction"_a, "gamma"_a)
+        .def(py::init<const TransverseIsing&>(), "other"_a) //copy sharing the interaction
         .def("reset_spins", [](TransverseIsing& self, const SpinConfiguration& init_spin_config){self.reset_spins(init_spin_config);},"init_spin_config"_a)
         .def("reset_spins", [](TransverseIsing& self, const graph::Spins& classical_spins){self.reset_spins(classical_spins);},"classical_spins"_a)
-        .def_readwrite("spin_config", &TransverseIsing::spin_config)
-        .def_readonly("interaction", &TransverseIsing::interaction)
+        .def_property("spin_config",
+                [](const TransverseIsing& self){return self.spin_config.to_spin_configuration();},
+                [](TransverseIsing& self, const SpinConfiguration& spin_config){self.spin_config = typename TransverseIsing::Timelines(spin_config);})
+        .def_property_readonly("interaction", [](py::object self){return get_interaction(self.cast<const TransverseIsing&>().interaction, self);})
         .def_readonly("num_spins", &TransverseIsing::num_spins)
         .def_readonly("gamma", &TransverseIsing::gamma);
 
@@ -305,6 +751,27 @@ inline void declare_Algorithm_run(py::module &m, const std::string& updater_str)
 
 }
 
+template<template<typename> class Updater, typename System, typename RandomNumberEngine>
+inline void declare_Algorithm_run_with_checkpoint(py::module &m, const std::string& updater_str){
+    auto str = std::string("Algorithm_")+updater_str+std::string("_run_with_checkpoint");
+    using SystemType = typename system::get_system_type<System>::type;
+    using TupleList = std::vector<std::pair<typename utility::UpdaterParameter<SystemType>::Tuple, std::size_t>>;
+
+    //the engine is seeded for a new run and restored from the checkpoint for a resumed run;
+    //the seed enters the fingerprint of the run, so a checkpoint written with another seed is rejected
+    m.def(str.c_str(), [](System& system, std::size_t seed, const utility::ScheduleList<SystemType>& schedule_list,
+                const std::string& checkpoint_path, std::size_t checkpoint_interval){
+            RandomNumberEngine rng(seed);
+            algorithm::Algorithm<Updater>::run_with_checkpoint(system, rng, schedule_list, checkpoint_path, checkpoint_interval);
+            }, "system"_a, "seed"_a, "schedule_list"_a, "checkpoint_path"_a, "checkpoint_interval"_a);
+
+    m.def(str.c_str(), [](System& system, std::size_t seed, const TupleList& tuplelist,
+                const std::string& checkpoint_path, std::size_t checkpoint_interval){
+            RandomNumberEngine rng(seed);
+            algorithm::Algorithm<Updater>::run_with_checkpoint(system, rng, utility::make_schedule_list<SystemType>(tuplelist), checkpoint_path, checkpoint_interval);
+            }, "system"_a, "seed"_a, "tuplelist"_a, "checkpoint_path"_a, "checkpoint_interval"_a);
+}
+
 //utility
 template<typename SystemType>
 inline std::string repr_impl(const utility::UpdaterParameter<SystemType>&);
@@ -338,6 +805,33 @@ inline void declare_Schedule(py::module &m, const std::string& systemtype_str){
 
 //result
 //get_solution
+//update_interaction
+template<typename System, typename FloatType>
+inline void declare_update_interaction(py::module &m){
+    m.def("update_interaction", [](System& system, const graph::Delta<FloatType>& delta){system::update_interaction(system, delta);}, "system"_a, "delta"_a);
+}
+
+//calc_energies
+template<typename GraphType>
+inline void declare_calc_energies(py::module &m){
+    using FloatType = typename GraphType::value_type;
+    //states (num_states x num_spins) are read in place if they are a C-contiguous int8 array
+    m.def("calc_energies", [](const GraphType& graph, const py::array_t<std::int8_t, py::array::c_style | py::array::forcecast>& states, std::size_t num_threads){
+            if(states.ndim() != 2 || static_cast<std::size_t>(states.shape(1)) != graph.get_num_spins()){
+                throw std::invalid_argument("states must be a two-dimensional array of shape (num_states, num_spins).");
+            }
+            const std::size_t num_states = static_cast<std::size_t>(states.shape(0));
+            py::array_t<FloatType> energies(num_states);
+            const std::int8_t* data = states.data();
+            FloatType* out = energies.mutable_data();
+            {
+                py::gil_scoped_release release;
+                result::calc_energies(graph, data, num_states, out, num_threads);
+            }
+            return energies;
+            }, "graph"_a, "states"_a, "num_threads"_a=0);
+}
+
 template<typename System>
 inline void declare_get_solution(py::module &m){
     m.def("get_solution", [](const System& system){return result::get_solution(system);}, "system"_a);
@@ -34,12 +34,29 @@ PYBIND11_MODULE(cxxjij, m){
 
     ::declare_Dir(m_graph);
     ::declare_ChimeraDir(m_graph);
+    ::declare_KingDir(m_graph);
+    ::declare_Vartype(m_graph);
+    ::declare_TextFormat(m_graph);
 
     //CPU version (FloatType)
     ::declare_Dense<FloatType>(m_graph, "");
     ::declare_Sparse<FloatType>(m_graph, "");
+    ::declare_ReorderedSparse<FloatType>(m_graph, "");
     ::declare_Square<FloatType>(m_graph, "");
     ::declare_Chimera<FloatType>(m_graph, "");
+    ::declare_KingGraph<FloatType>(m_graph, "");
+    ::declare_Lattice<graph::SquareLattice<FloatType>>(m_graph, "SquareLattice");
+    ::declare_Lattice<graph::CubicLattice<FloatType>>(m_graph, "CubicLattice");
+    ::declare_CSRSparse<FloatType>(m_graph, "");
+    ::declare_DenseMatrix<FloatType>(m_graph, "");
+    ::declare_QuantizedDense<std::int8_t, FloatType>(m_graph, "8");
+    ::declare_QuantizedDense<std::int16_t, FloatType>(m_graph, "16");
+    ::declare_QuantizedSparse<std::int8_t, FloatType>(m_graph, "8");
+    ::declare_QuantizedSparse<std::int16_t, FloatType>(m_graph, "16");
+    ::declare_parse_sparse<FloatType>(m_graph, "");
+    ::declare_Delta<FloatType>(m_graph, "");
+    ::declare_Polynomial<FloatType>(m_graph, "");
+    ::declare_ReducedPolynomial<FloatType>(m_graph, "");
 
     //GPU version (GPUFloatType)
     if(!std::is_same<FloatType, GPUFloatType>::value){
@@ -62,19 +79,65 @@ PYBIND11_MODULE(cxxjij, m){
     //ClassicalIsing (Dense, NoEigenImpl)
     ::declare_ClassicalIsing<graph::Dense<FloatType>, false>(m_system, "_Dense", "");
     ::declare_ClassicalIsing<graph::Dense<FloatType>, true>(m_system, "_Dense", "_Eigen");
+    //ReorderedSparse, Chimera, Square and KingGraph are declared before Sparse (their base class) so that make_* picks the derived class
+    ::declare_ClassicalIsing<graph::ReorderedSparse<FloatType>, false>(m_system, "_ReorderedSparse", "");
+    ::declare_ClassicalIsing<graph::Chimera<FloatType>, false>(m_system, "_Chimera", "");
+    ::declare_ClassicalIsing<graph::Square<FloatType>, false>(m_system, "_Square", "");
+    ::declare_ClassicalIsing<graph::KingGraph<FloatType>, false>(m_system, "_KingGraph", "");
     ::declare_ClassicalIsing<graph::Sparse<FloatType>, false>(m_system, "_Sparse", "");
+    ::declare_ClassicalIsing<graph::SquareLattice<FloatType>, false>(m_system, "_SquareLattice", "");
+    ::declare_ClassicalIsing<graph::CubicLattice<FloatType>, false>(m_system, "_CubicLattice", "");
     ::declare_ClassicalIsing<graph::Sparse<FloatType>, true>(m_system, "_Sparse", "_Eigen");
+    ::declare_ClassicalIsing<graph::CSRSparse<FloatType>, false>(m_system, "_CSRSparse", "");
+    ::declare_ClassicalIsing<graph::DenseMatrix<FloatType>, false>(m_system, "_DenseMatrix", "");
+    ::declare_ClassicalIsing<graph::QuantizedDense<std::int8_t, FloatType>, false>(m_system, "_QuantizedDense8", "");
+    ::declare_ClassicalIsing<graph::QuantizedDense<std::int16_t, FloatType>, false>(m_system, "_QuantizedDense16", "");
+    ::declare_ClassicalIsing<graph::QuantizedSparse<std::int8_t, FloatType>, false>(m_system, "_QuantizedSparse8", "");
+    ::declare_ClassicalIsing<graph::QuantizedSparse<std::int16_t, FloatType>, false>(m_system, "_QuantizedSparse16", "");
+
+    //ClassicalIsingPolynomial (higher-order interactions)
+    ::declare_ClassicalIsingPolynomial<graph::Polynomial<FloatType>>(m_system, "");
+
+    //ClassicalIsingPacked and TransverseIsingPacked (bit-packed spins)
+    ::declare_PackedIsing<graph::CSRSparse<FloatType>>(m_system, "_CSRSparse");
+
+    //MultiSpinClassicalIsing (64 replicas of a +-J model, derived graphs first)
+    ::declare_MultiSpinClassicalIsing<graph::Chimera<FloatType>>(m_system, "_Chimera");
+    ::declare_MultiSpinClassicalIsing<graph::Square<FloatType>>(m_system, "_Square");
+    ::declare_MultiSpinClassicalIsing<graph::Sparse<FloatType>>(m_system, "_Sparse");
+
+    //BatchedClassicalIsing (many replicas, structure-of-arrays layout)
+    ::declare_BatchedClassicalIsing<graph::Dense<FloatType>>(m_system, "_Dense");
+    ::declare_BatchedClassicalIsing<graph::Sparse<FloatType>>(m_system, "_Sparse");
+
+    //PreparedProblem (derived forms of a graph cached for repeated sampling)
+    ::declare_PreparedProblem<graph::Dense<FloatType>>(m_system, "_Dense");
+    ::declare_PreparedProblem<graph::Sparse<FloatType>>(m_system, "_Sparse");
 
     //TransverselIsing
     ::declare_TransverseIsing<graph::Dense<FloatType>, false>(m_system, "_Dense", "");
     ::declare_TransverseIsing<graph::Dense<FloatType>, true>(m_system, "_Dense", "_Eigen");
+    //ReorderedSparse is declared before Sparse (its base class) so that make_* keeps the ordering
+    ::declare_TransverseIsing<graph::ReorderedSparse<FloatType>, false>(m_system, "_ReorderedSparse", "");
     ::declare_TransverseIsing<graph::Sparse<FloatType>, false>(m_system, "_Sparse", "");
     ::declare_TransverseIsing<graph::Sparse<FloatType>, true>(m_system, "_Sparse", "_Eigen");
+    ::declare_TransverseIsing<graph::CSRSparse<FloatType>, false>(m_system, "_CSRSparse", "");
+    ::declare_TransverseIsing<graph::DenseMatrix<FloatType>, false>(m_system, "_DenseMatrix", "");
 
     //Continuous Time Transeverse Ising
     ::declare_ContinuousTimeIsing<graph::Dense<FloatType>, false>(m_system, "_Dense", "");
     ::declare_ContinuousTimeIsing<graph::Sparse<FloatType>, false>(m_system, "_Sparse", "");
 
+    //in-place update of interactions
+    ::declare_update_interaction<system::ClassicalIsing<graph::Dense<FloatType>, false>, FloatType>(m_system);
+    ::declare_update_interaction<system::ClassicalIsing<graph::Dense<FloatType>, true>, FloatType>(m_system);
+    ::declare_update_interaction<system::ClassicalIsing<graph::Sparse<FloatType>, false>, FloatType>(m_system);
+    ::declare_update_interaction<system::ClassicalIsing<graph::Sparse<FloatType>, true>, FloatType>(m_system);
+    ::declare_update_interaction<system::TransverseIsing<graph::Dense<FloatType>, false>, FloatType>(m_system);
+    ::declare_update_interaction<system::TransverseIsing<graph::Dense<FloatType>, true>, FloatType>(m_system);
+    ::declare_update_interaction<system::TransverseIsing<graph::Sparse<FloatType>, false>, FloatType>(m_system);
+    ::declare_update_interaction<system::TransverseIsing<graph::Sparse<FloatType>, true>, FloatType>(m_system);
+
 #ifdef USE_CUDA
     //ChimeraTransverseGPU
     ::declare_ChimeraTranseverseGPU<GPUFloatType, BLOCK_ROW, BLOCK_COL, BLOCK_TROT>(m_system);
@@ -96,10 +159,39 @@ PYBIND11_MODULE(cxxjij, m){
     ::declare_Algorithm_run<updater::SingleSpinFlip, system::TransverseIsing<graph::Dense<FloatType>, true>,   RandomEngine>(m_algorithm, "SingleSpinFlip");
     ::declare_Algorithm_run<updater::SingleSpinFlip, system::TransverseIsing<graph::Sparse<FloatType>, false>, RandomEngine>(m_algorithm, "SingleSpinFlip");
     ::declare_Algorithm_run<updater::SingleSpinFlip, system::TransverseIsing<graph::Sparse<FloatType>, true>,  RandomEngine>(m_algorithm, "SingleSpinFlip");
+    ::declare_Algorithm_run<updater::SingleSpinFlip, system::ClassicalIsing<graph::ReorderedSparse<FloatType>, false>,  RandomEngine>(m_algorithm, "SingleSpinFlip");
+    ::declare_Algorithm_run<updater::SingleSpinFlip, system::ClassicalIsing<graph::Chimera<FloatType>, false>,  RandomEngine>(m_algorithm, "SingleSpinFlip");
+    ::declare_Algorithm_run<updater::SingleSpinFlip, system::ClassicalIsing<graph::Square<FloatType>, false>,  RandomEngine>(m_algorithm, "SingleSpinFlip");
+    ::declare_Algorithm_run<updater::SingleSpinFlip, system::ClassicalIsing<graph::KingGraph<FloatType>, false>,  RandomEngine>(m_algorithm, "SingleSpinFlip");
+    ::declare_Algorithm_run<updater::SingleSpinFlip, system::ClassicalIsing<graph::SquareLattice<FloatType>, false>,  RandomEngine>(m_algorithm, "SingleSpinFlip");
+    ::declare_Algorithm_run<updater::SingleSpinFlip, system::ClassicalIsing<graph::CubicLattice<FloatType>, false>,  RandomEngine>(m_algorithm, "SingleSpinFlip");
+    ::declare_Algorithm_run<updater::SingleSpinFlip, system::TransverseIsing<graph::ReorderedSparse<FloatType>, false>, RandomEngine>(m_algorithm, "SingleSpinFlip");
+    ::declare_Algorithm_run<updater::SingleSpinFlip, system::ClassicalIsing<graph::CSRSparse<FloatType>, false>,  RandomEngine>(m_algorithm, "SingleSpinFlip");
+    ::declare_Algorithm_run<updater::SingleSpinFlip, system::TransverseIsing<graph::CSRSparse<FloatType>, false>, RandomEngine>(m_algorithm, "SingleSpinFlip");
+    ::declare_Algorithm_run<updater::SingleSpinFlip, system::ClassicalIsing<graph::DenseMatrix<FloatType>, false>,  RandomEngine>(m_algorithm, "SingleSpinFlip");
+    ::declare_Algorithm_run<updater::SingleSpinFlip, system::TransverseIsing<graph::DenseMatrix<FloatType>, false>, RandomEngine>(m_algorithm, "SingleSpinFlip");
+    ::declare_Algorithm_run<updater::SingleSpinFlip, system::ClassicalIsing<graph::QuantizedDense<std::int8_t, FloatType>, false>,   RandomEngine>(m_algorithm, "SingleSpinFlip");
+    ::declare_Algorithm_run<updater::SingleSpinFlip, system::ClassicalIsing<graph::QuantizedDense<std::int16_t, FloatType>, false>,  RandomEngine>(m_algorithm, "SingleSpinFlip");
+    ::declare_Algorithm_run<updater::SingleSpinFlip, system::ClassicalIsing<graph::QuantizedSparse<std::int8_t, FloatType>, false>,  RandomEngine>(m_algorithm, "SingleSpinFlip");
+    ::declare_Algorithm_run<updater::SingleSpinFlip, system::ClassicalIsing<graph::QuantizedSparse<std::int16_t, FloatType>, false>, RandomEngine>(m_algorithm, "SingleSpinFlip");
+    ::declare_Algorithm_run<updater::SingleSpinFlip, system::ClassicalIsingPolynomial<graph::Polynomial<FloatType>>, RandomEngine>(m_algorithm, "SingleSpinFlip");
+    ::declare_Algorithm_run<updater::SingleSpinFlip, system::ClassicalIsingPacked<graph::CSRSparse<FloatType>>, RandomEngine>(m_algorithm, "SingleSpinFlip");
+    ::declare_Algorithm_run<updater::SingleSpinFlip, system::TransverseIsingPacked<graph::CSRSparse<FloatType>>, RandomEngine>(m_algorithm, "SingleSpinFlip");
+    ::declare_Algorithm_run<updater::SingleSpinFlip, system::MultiSpinClassicalIsing<graph::Chimera<FloatType>>, RandomEngine>(m_algorithm, "SingleSpinFlip");
+    ::declare_Algorithm_run<updater::SingleSpinFlip, system::MultiSpinClassicalIsing<graph::Square<FloatType>>, RandomEngine>(m_algorithm, "SingleSpinFlip");
+    ::declare_Algorithm_run<updater::SingleSpinFlip, system::MultiSpinClassicalIsing<graph::Sparse<FloatType>>, RandomEngine>(m_algorithm, "SingleSpinFlip");
+    ::declare_Algorithm_run<updater::SingleSpinFlip, system::BatchedClassicalIsing<graph::Dense<FloatType>>, RandomEngine>(m_algorithm, "SingleSpinFlip");
+    ::declare_Algorithm_run<updater::SingleSpinFlip, system::BatchedClassicalIsing<graph::Sparse<FloatType>>, RandomEngine>(m_algorithm, "SingleSpinFlip");
 
     //swendsen-wang
     ::declare_Algorithm_run<updater::SwendsenWang, system::ClassicalIsing<graph::Dense<FloatType>, false>,  RandomEngine>(m_algorithm, "SwendsenWang");
     ::declare_Algorithm_run<updater::SwendsenWang, system::ClassicalIsing<graph::Sparse<FloatType>, false>, RandomEngine>(m_algorithm, "SwendsenWang");
+    ::declare_Algorithm_run<updater::SwendsenWang, system::ClassicalIsing<graph::Chimera<FloatType>, false>, RandomEngine>(m_algorithm, "SwendsenWang");
+    ::declare_Algorithm_run<updater::SwendsenWang, system::ClassicalIsing<graph::Square<FloatType>, false>, RandomEngine>(m_algorithm, "SwendsenWang");
+    ::declare_Algorithm_run<updater::SwendsenWang, system::ClassicalIsing<graph::KingGraph<FloatType>, false>, RandomEngine>(m_algorithm, "SwendsenWang");
+    ::declare_Algorithm_run<updater::SwendsenWang, system::ClassicalIsing<graph::SquareLattice<FloatType>, false>, RandomEngine>(m_algorithm, "SwendsenWang");
+    ::declare_Algorithm_run<updater::SwendsenWang, system::ClassicalIsing<graph::CubicLattice<FloatType>, false>, RandomEngine>(m_algorithm, "SwendsenWang");
+    ::declare_Algorithm_run<updater::SwendsenWang, system::ClassicalIsing<graph::CSRSparse<FloatType>, false>, RandomEngine>(m_algorithm, "SwendsenWang");
 
     //swendsen-wang (with Eigen implementation on a Sparse graph)
     ::declare_Algorithm_run<updater::SwendsenWang, system::ClassicalIsing<graph::Sparse<FloatType>, true>, RandomEngine>(m_algorithm, "SwendsenWang");
@@ -108,6 +200,22 @@ PYBIND11_MODULE(cxxjij, m){
     ::declare_Algorithm_run<updater::ContinuousTimeSwendsenWang, system::ContinuousTimeIsing<graph::Dense<FloatType>, false>, RandomEngine>(m_algorithm, "ContinuousTimeSwendsenWang");
     ::declare_Algorithm_run<updater::ContinuousTimeSwendsenWang, system::ContinuousTimeIsing<graph::Sparse<FloatType>, false>, RandomEngine>(m_algorithm, "ContinuousTimeSwendsenWang");
 
+    //checkpointed runs (systems with system::save_state/load_state)
+    ::declare_Algorithm_run_with_checkpoint<updater::SingleSpinFlip, system::ClassicalIsing<graph::Dense<FloatType>, false>,   RandomEngine>(m_algorithm, "SingleSpinFlip");
+    ::declare_Algorithm_run_with_checkpoint<updater::SingleSpinFlip, system::ClassicalIsing<graph::Dense<FloatType>, true>,    RandomEngine>(m_algorithm, "SingleSpinFlip");
+    ::declare_Algorithm_run_with_checkpoint<updater::SingleSpinFlip, system::ClassicalIsing<graph::Sparse<FloatType>, false>,  RandomEngine>(m_algorithm, "SingleSpinFlip");
+    ::declare_Algorithm_run_with_checkpoint<updater::SingleSpinFlip, system::ClassicalIsing<graph::Sparse<FloatType>, true>,   RandomEngine>(m_algorithm, "SingleSpinFlip");
+    ::declare_Algorithm_run_with_checkpoint<updater::SingleSpinFlip, system::ClassicalIsing<graph::CSRSparse<FloatType>, false>,  RandomEngine>(m_algorithm, "SingleSpinFlip");
+    ::declare_Algorithm_run_with_checkpoint<updater::SingleSpinFlip, system::TransverseIsing<graph::Dense<FloatType>, false>,  RandomEngine>(m_algorithm, "SingleSpinFlip");
+    ::declare_Algorithm_run_with_checkpoint<updater::SingleSpinFlip, system::TransverseIsing<graph::Dense<FloatType>, true>,   RandomEngine>(m_algorithm, "SingleSpinFlip");
+    ::declare_Algorithm_run_with_checkpoint<updater::SingleSpinFlip, system::TransverseIsing<graph::Sparse<FloatType>, false>, RandomEngine>(m_algorithm, "SingleSpinFlip");
+    ::declare_Algorithm_run_with_checkpoint<updater::SingleSpinFlip, system::TransverseIsing<graph::Sparse<FloatType>, true>,  RandomEngine>(m_algorithm, "SingleSpinFlip");
+    ::declare_Algorithm_run_with_checkpoint<updater::SingleSpinFlip, system::TransverseIsing<graph::CSRSparse<FloatType>, false>, RandomEngine>(m_algorithm, "SingleSpinFlip");
+    ::declare_Algorithm_run_with_checkpoint<updater::SwendsenWang, system::ClassicalIsing<graph::Dense<FloatType>, false>,  RandomEngine>(m_algorithm, "SwendsenWang");
+    ::declare_Algorithm_run_with_checkpoint<updater::SwendsenWang, system::ClassicalIsing<graph::Sparse<FloatType>, false>, RandomEngine>(m_algorithm, "SwendsenWang");
+    ::declare_Algorithm_run_with_checkpoint<updater::ContinuousTimeSwendsenWang, system::ContinuousTimeIsing<graph::Dense<FloatType>, false>, RandomEngine>(m_algorithm, "ContinuousTimeSwendsenWang");
+    ::declare_Algorithm_run_with_checkpoint<updater::ContinuousTimeSwendsenWang, system::ContinuousTimeIsing<graph::Sparse<FloatType>, false>, RandomEngine>(m_algorithm, "ContinuousTimeSwendsenWang");
+
 #ifdef USE_CUDA
     //GPU
     ::declare_Algorithm_run<updater::GPU, system::ChimeraTransverseGPU<GPUFloatType, BLOCK_ROW, BLOCK_COL, BLOCK_TROT>, utility::cuda::CurandWrapper<GPUFloatType, GPURandomEngine>>(m_algorithm, "GPU");
@@ -163,8 +271,37 @@ PYBIND11_MODULE(cxxjij, m){
     ::declare_get_solution<system::TransverseIsing<graph::Dense<FloatType>, true>>(m_result);
     ::declare_get_solution<system::TransverseIsing<graph::Sparse<FloatType>, false>>(m_result);
     ::declare_get_solution<system::TransverseIsing<graph::Sparse<FloatType>, true>>(m_result);
+    ::declare_get_solution<system::ClassicalIsing<graph::ReorderedSparse<FloatType>, false>>(m_result);
+    ::declare_get_solution<system::ClassicalIsing<graph::Chimera<FloatType>, false>>(m_result);
+    ::declare_get_solution<system::ClassicalIsing<graph::Square<FloatType>, false>>(m_result);
+    ::declare_get_solution<system::ClassicalIsing<graph::KingGraph<FloatType>, false>>(m_result);
+    ::declare_get_solution<system::ClassicalIsing<graph::SquareLattice<FloatType>, false>>(m_result);
+    ::declare_get_solution<system::ClassicalIsing<graph::CubicLattice<FloatType>, false>>(m_result);
+    ::declare_get_solution<system::TransverseIsing<graph::ReorderedSparse<FloatType>, false>>(m_result);
+    ::declare_get_solution<system::ClassicalIsing<graph::CSRSparse<FloatType>, false>>(m_result);
+    ::declare_get_solution<system::TransverseIsing<graph::CSRSparse<FloatType>, false>>(m_result);
+    ::declare_get_solution<system::ClassicalIsing<graph::DenseMatrix<FloatType>, false>>(m_result);
+    ::declare_get_solution<system::TransverseIsing<graph::DenseMatrix<FloatType>, false>>(m_result);
+    ::declare_get_solution<system::ClassicalIsing<graph::QuantizedDense<std::int8_t, FloatType>, false>>(m_result);
+    ::declare_get_solution<system::ClassicalIsing<graph::QuantizedDense<std::int16_t, FloatType>, false>>(m_result);
+    ::declare_get_solution<system::ClassicalIsing<graph::QuantizedSparse<std::int8_t, FloatType>, false>>(m_result);
+    ::declare_get_solution<system::ClassicalIsing<graph::QuantizedSparse<std::int16_t, FloatType>, false>>(m_result);
+    ::declare_get_solution<system::ClassicalIsingPolynomial<graph::Polynomial<FloatType>>>(m_result);
+    ::declare_get_solution<system::ClassicalIsingPacked<graph::CSRSparse<FloatType>>>(m_result);
+    ::declare_get_solution<system::TransverseIsingPacked<graph::CSRSparse<FloatType>>>(m_result);
+    ::declare_get_solution<system::MultiSpinClassicalIsing<graph::Chimera<FloatType>>>(m_result);
+    ::declare_get_solution<system::MultiSpinClassicalIsing<graph::Square<FloatType>>>(m_result);
+    ::declare_get_solution<system::MultiSpinClassicalIsing<graph::Sparse<FloatType>>>(m_result);
+    ::declare_get_solution<system::BatchedClassicalIsing<graph::Dense<FloatType>>>(m_result);
+    ::declare_get_solution<system::BatchedClassicalIsing<graph::Sparse<FloatType>>>(m_result);
     ::declare_get_solution<system::ContinuousTimeIsing<graph::Dense<FloatType>, false>>(m_result);
     ::declare_get_solution<system::ContinuousTimeIsing<graph::Sparse<FloatType>, false>>(m_result);
+
+    //batched energies
+    ::declare_calc_energies<graph::Dense<FloatType>>(m_result);
+    ::declare_calc_energies<graph::Sparse<FloatType>>(m_result);
+    ::declare_calc_energies<graph::CSRSparse<FloatType>>(m_result);
+
 #ifdef USE_CUDA
     ::declare_get_solution<system::ChimeraTransverseGPU<GPUFloatType, BLOCK_ROW, BLOCK_COL, BLOCK_TROT>>(m_result);
     ::declare_get_solution<system::ChimeraClassicalGPU<GPUFloatType, BLOCK_ROW, BLOCK_COL>>(m_result);
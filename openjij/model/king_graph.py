@@ -13,6 +13,7 @@
 # limitations under the License.
 
 import openjij
+import cxxjij
 from .model import BinaryQuadraticModel
 
 
@@ -110,6 +111,43 @@ class KingGraph(BinaryQuadraticModel):
     def get_ising_king_graph(self):
         return self._ising_king_graph
 
+    def get_cxxjij_king_graph(self):
+        """
+        Convert to cxxjij.graph.KingGraph spanning the coordinates in use
+        (row = y, column = x), which keeps the 8-neighbor lattice structure
+        Returns:
+            cxxjij.graph.KingGraph
+        """
+        xs, ys = zip(*self.king_indices())
+        king_graph = cxxjij.graph.KingGraph(max(ys)+1, max(xs)+1)
+        directions = {
+            (1, 0): cxxjij.graph.KingDir.PLUS_R,
+            (-1, 0): cxxjij.graph.KingDir.MINUS_R,
+            (0, 1): cxxjij.graph.KingDir.PLUS_C,
+            (0, -1): cxxjij.graph.KingDir.MINUS_C,
+            (1, 1): cxxjij.graph.KingDir.PLUS_R_PLUS_C,
+            (1, -1): cxxjij.graph.KingDir.PLUS_R_MINUS_C,
+            (-1, 1): cxxjij.graph.KingDir.MINUS_R_PLUS_C,
+            (-1, -1): cxxjij.graph.KingDir.MINUS_R_MINUS_C,
+        }
+        for x1, y1, x2, y2, value in self._ising_king_graph:
+            if (x1, y1) == (x2, y2):
+                king_graph[y1, x1] += value
+            else:
+                key = (y1, x1, directions[(y2-y1, x2-x1)])
+                king_graph[key] += value
+        return king_graph
+
+    def lattice_positions(self, king_graph):
+        """
+        Global indices in cxxjij.graph.KingGraph of the variables (in the order of self.indices)
+        Args:
+            king_graph (cxxjij.graph.KingGraph): graph from get_cxxjij_king_graph
+        Returns:
+            list of int
+        """
+        return [king_graph.to_ind(y, x) for x, y in self.king_indices()]
+
     def king_indices(self):
         if isinstance(self.indices[0], tuple):
             return self.indices
@@ -59,23 +59,17 @@ class BinaryQuadraticModel(dimod.BinaryQuadraticModel):
             openjij.graph.Dense openjij.graph.Sparse
         """
 
-        if not sparse:
-            GraphClass = cxxjij.graph.Dense
-        else:
-            GraphClass = cxxjij.graph.Sparse
-
-        cxxjij_graph = GraphClass(self.size)
-
         ising_int = self.ising_interactions()
-        # cxxjij.graph.dense
-        for i in range(self.size):
-            if ising_int[i, i] != 0.0:
-                cxxjij_graph[i, i] = ising_int[i, i]
-            for j in range(i+1, self.size):
-                if ising_int[i, j] != 0.0:
-                    cxxjij_graph[i, j] = ising_int[i, j]
 
-        return cxxjij_graph
+        if not sparse:
+            # the upper triangle is read natively in one pass
+            return cxxjij.graph.Dense(
+                np.ascontiguousarray(ising_int, dtype=np.float64))
+
+        # nonzero elements of the upper triangle in COO format
+        row, col = np.nonzero(np.triu(ising_int))
+        return cxxjij.graph.Sparse(
+            self.size, row, col, ising_int[row, col])
 
     def ising_interactions(self):
         """ Interactions in the Ising representation
@@ -186,6 +180,36 @@ class BinaryQuadraticModel(dimod.BinaryQuadraticModel):
                    var_type=openjij.BINARY, **kwargs)
 
 
+class PreparedModel:
+    """BinaryQuadraticModel prepared once for repeated sampling
+
+    The native prepared problem owns the cxxjij graph of the model and caches
+    its derived forms (Eigen matrix, CSR layout, coloring, default beta range
+    and degree statistics), so that sampling the same model many times
+    does not repeat the setup.
+    Other attributes (indices, size, var_type, ...) are those of the model.
+
+    Args:
+        model (openjij.BinaryQuadraticModel): model to be sampled
+        sparse (bool): build cxxjij.graph.Sparse instead of Dense
+
+    Attributes:
+        model (openjij.BinaryQuadraticModel): model
+        problem (cxxjij.system.PreparedProblem_Dense or PreparedProblem_Sparse): native problem
+    """
+
+    def __init__(self, model, sparse=False):
+        self.model = model
+        self.problem = cxxjij.system.make_prepared_problem(
+            model.get_cxxjij_ising_graph(sparse=sparse))
+
+    def get_cxxjij_ising_graph(self):
+        return self.problem.graph
+
+    def __getattr__(self, name):
+        return getattr(self.model, name)
+
+
 # class BinaryQuadraticModel:
 #     """Represents Binary quadratic model
 #     Attributes:
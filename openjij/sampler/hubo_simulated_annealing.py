@@ -3,6 +3,7 @@ import numpy as np
 from openjij.model import BinaryHigherOrderModel
 from openjij import SPIN, BINARY, cast_var_type
 import openjij
+import cxxjij
 
 
 def default_schedule(bhom, beta_min, beta_max, num_sweeps):
@@ -38,35 +39,71 @@ def _default_beta_schedule(hubo):
     return beta_min, beta_max
 
 
-def hubo_simulated_annealing(bhom: BinaryHigherOrderModel, state: list,
-                             schedule: list, var_type):
+def _make_cxxjij_polynomial(bhom: BinaryHigherOrderModel):
+    """convert BinaryHigherOrderModel to cxxjij.graph.Polynomial
+
+    Args:
+        bhom (BinaryHigherOrderModel): higher order model
+
+    Returns:
+        cxxjij.graph.Polynomial: polynomial interactions (variables are numbered in the order of bhom.indices)
+    """
+    position = {ind: k for k, ind in enumerate(bhom.indices)}
+    # flat arrays (no per-term lists are passed to C++)
+    term_vars, term_offsets, coeffs = [], [0], []
+    for i, hi in bhom.interactions[0].items():
+        if hi != 0:
+            term_vars.append(position[i])
+            term_offsets.append(len(term_vars))
+            coeffs.append(hi)
+    for coeff in bhom.interactions[1:]:
+        for _inds, value in coeff.items():
+            term_vars.extend(position[i] for i in _inds)
+            term_offsets.append(len(term_vars))
+            coeffs.append(value)
+    return cxxjij.graph.Polynomial(len(bhom.indices),
+                                   np.array(term_vars, dtype=np.int64),
+                                   np.array(term_offsets, dtype=np.int64),
+                                   np.array(coeffs, dtype=np.float64))
 
-    adj_dict = bhom.adj_dict()
-    state = np.array(state)
 
+def hubo_simulated_annealing(bhom: BinaryHigherOrderModel, state: list,
+                             schedule: list, var_type, seed=None,
+                             polynomial=None):
+    """run simulated annealing of the higher order model in C++
+
+    Args:
+        bhom (BinaryHigherOrderModel): higher order model
+        state (list): initial state (SPIN: -1/+1, BINARY: 0/1)
+        schedule (list): list of [beta, mc_steps]
+        var_type (str, openjij.VarType): "SPIN" or "BINARY"
+        seed (int, optional): seed of the random number engine. Defaults to None.
+        polynomial (cxxjij.graph.Polynomial, optional): converted interactions (reused over reads). Defaults to None.
+
+    Returns:
+        numpy.ndarray: final state
+    """
     if SPIN == cast_var_type(var_type):
-        for beta, mc_steps in schedule:
-            for _ in range(mc_steps):
-                for i in bhom.indices:
-                    de = -2*state[i]*np.sum([d*np.prod(state[_inds])
-                                             for _inds, d in adj_dict[i]])
-                    de += -2*state[i]*bhom.interactions[0][i]
-                    if de < 0 or np.random.uniform(0, 1) < np.exp(-beta*de):
-                        state[i] *= -1
-        return state
+        vartype = cxxjij.graph.Vartype.SPIN
     elif BINARY == cast_var_type(var_type):
-        for beta, mc_steps in schedule:
-            for _ in range(mc_steps):
-                for i in bhom.indices:
-                    de = (1-2*state[i])*np.sum([d*np.prod(state[_inds])
-                                                for _inds, d in adj_dict[i]])
-                    de += (1-2*state[i])*bhom.interactions[0][i]
-                    if de <= 0 or np.random.uniform(0, 1) < np.exp(-beta*de):
-                        state[i] = 0 if state[i] == 1 else 1
-        return state
+        vartype = cxxjij.graph.Vartype.BINARY
     else:
         raise ValueError("var_type should be SPIN or BINARY")
 
+    if polynomial is None:
+        polynomial = _make_cxxjij_polynomial(bhom)
+
+    system = cxxjij.system.make_classical_ising_polynomial(
+        [int(s) for s in state], polynomial, vartype)
+    schedule = [(float(beta), int(mc_steps)) for beta, mc_steps in schedule]
+
+    if seed is None:
+        cxxjij.algorithm.Algorithm_SingleSpinFlip_run(system, schedule)
+    else:
+        cxxjij.algorithm.Algorithm_SingleSpinFlip_run(system, seed, schedule)
+
+    return np.array(cxxjij.result.get_solution(system))
+
 
 def measure_time(func):
     def wrapper(*args, **kargs):
@@ -85,8 +122,12 @@ def hubo_sa_sampling(bhom, var_type,
                      num_sweeps=100, num_reads=1,
                      init_state=None, seed=None):
 
-    init_state = init_state if init_state else np.random.choice(
-        [1, -1], len(bhom.indices))
+    if SPIN == cast_var_type(var_type):
+        values = [1, -1]
+    else:
+        values = [1, 0]
+    random_state = np.random.RandomState(seed)
+    polynomial = _make_cxxjij_polynomial(bhom)
 
     response = openjij.Response(
         var_type=var_type, indices=bhom.indices
@@ -96,9 +137,13 @@ def hubo_sa_sampling(bhom, var_type,
     @measure_time
     def exec_sampling():
         for _ in range(num_reads):
+            _init_state = init_state if init_state else random_state.choice(
+                values, len(bhom.indices))
+            _seed = None if seed is None else random_state.randint(2**31)
             _exec_time, state = measure_time(
-                hubo_simulated_annealing)(bhom, init_state, schedule,
-                                          var_type=var_type)
+                hubo_simulated_annealing)(bhom, _init_state, schedule,
+                                          var_type=var_type, seed=_seed,
+                                          polynomial=polynomial)
             execution_time.append(_exec_time)
             response.states.append(state)
             response.energies.append(bhom.calc_energy(state))
@@ -95,8 +95,17 @@ class SASampler(BaseSampler):
 
         self._make_system = {
             'singlespinflip': cxxjij.system.make_classical_ising_Eigen,
-            'swendsenwang': cxxjij.system.make_classical_ising
+            # freeze the graph into CSR layout so that the naive updater does not hash (i, j) pairs
+            'swendsenwang': lambda init_spin, graph: cxxjij.system.make_classical_ising(
+                init_spin, cxxjij.graph.CSRSparse(graph))
         }
+        # systems sharing the cached derived forms of a prepared problem
+        self._make_prepared_system = {
+            'singlespinflip': cxxjij.system.make_classical_ising_Eigen,
+            'swendsenwang': cxxjij.system.make_classical_ising_CSRSparse
+        }
+        # global indices of the variables when sampling on a native King's graph
+        self._lattice_positions = None
         self._algorithm = {
             'singlespinflip': cxxjij.algorithm.Algorithm_SingleSpinFlip_run,
             'swendsenwang': cxxjij.algorithm.Algorithm_SwendsenWang_run
@@ -142,12 +151,62 @@ class SASampler(BaseSampler):
                               initial_state, updater,
                               reinitialize_state, seed, **kwargs)
 
+    def sample_king_graph(self, king_graph, beta_min=None, beta_max=None,
+                          num_sweeps=None, num_reads=1, schedule=None,
+                          initial_state=None, updater='single spin flip',
+                          reinitialize_state=True, seed=None,
+                          **kwargs):
+        """sampling from a King's graph model on the native King's graph
+
+        Args:
+            king_graph (openjij.KingGraph): King's graph model
+            others: same as sample_ising
+
+        Returns:
+            :class:`openjij.sampler.response.Response`
+        """
+        return self._sampling(king_graph, beta_min, beta_max,
+                              num_sweeps, num_reads, schedule,
+                              initial_state, updater,
+                              reinitialize_state, seed, **kwargs)
+
+    def sample_prepared(self, prepared, beta_min=None, beta_max=None,
+                        num_sweeps=None, num_reads=1, schedule=None,
+                        initial_state=None, updater='single spin flip',
+                        reinitialize_state=True, seed=None,
+                        **kwargs):
+        """sampling from a prepared model (the setup of the model is shared by the calls)
+
+        Args:
+            prepared (openjij.PreparedModel): prepared model
+            others: same as sample_ising
+
+        Returns:
+            :class:`openjij.sampler.response.Response`
+        """
+        return self._sampling(prepared, beta_min, beta_max,
+                              num_sweeps, num_reads, schedule,
+                              initial_state, updater,
+                              reinitialize_state, seed, **kwargs)
+
     def _sampling(self, model, beta_min=None, beta_max=None,
                      num_sweeps=None, num_reads=1, schedule=None,
                      initial_state=None, updater='single spin flip',
                      reinitialize_state=True, seed=None,
                      **kwargs):
-        ising_graph = model.get_cxxjij_ising_graph()
+        problem = None
+        if isinstance(model, openjij.PreparedModel):
+            problem = model.problem
+            ising_graph = problem.graph
+            self._lattice_positions = None
+        elif isinstance(model, openjij.KingGraph):
+            # keep the lattice structure (variables are placed at model.lattice_positions)
+            ising_graph = model.get_cxxjij_king_graph()
+            self._lattice_positions = np.array(
+                model.lattice_positions(ising_graph))
+        else:
+            ising_graph = model.get_cxxjij_ising_graph()
+            self._lattice_positions = None
 
         self._setting_overwrite(
             beta_min=beta_min, beta_max=beta_max,
@@ -180,13 +239,18 @@ class SASampler(BaseSampler):
             def _generate_init_state(): return ising_graph.gen_spin()
         else:
             # validate initial_state size
-            if len(initial_state) != ising_graph.size():
+            if len(initial_state) != model.size:
                 raise ValueError(
                     "the size of the initial state should be {}"
-                    .format(ising_graph.size()))
+                    .format(model.size))
             if isinstance(initial_state, dict):
                 initial_state = [initial_state[k] for k in model.indices]
             _init_state = np.array(initial_state)
+            if self._lattice_positions is not None:
+                # sites without variables are decoupled; any spin will do
+                _lattice_state = np.ones(ising_graph.size(), dtype=_init_state.dtype)
+                _lattice_state[self._lattice_positions] = _init_state
+                _init_state = _lattice_state
             def _generate_init_state(): return np.array(_init_state)
         # -------------------------------- make init state generator
 
@@ -195,7 +259,15 @@ class SASampler(BaseSampler):
         if _updater_name not in self._make_system:
             raise ValueError('updater is one of "single spin flip or swendsen wang"')
         algorithm = self._algorithm[_updater_name]
-        sa_system = self._make_system[_updater_name](_generate_init_state(), ising_graph)
+        if self._lattice_positions is not None:
+            sa_system = cxxjij.system.make_classical_ising(
+                _generate_init_state(), ising_graph)
+        elif problem is not None:
+            sa_system = self._make_prepared_system[_updater_name](
+                _generate_init_state(), problem)
+        else:
+            sa_system = self._make_system[_updater_name](
+                _generate_init_state(), ising_graph)
         # ------------------------------------------- choose updater
         response = self._cxxjij_sampling(
             model, _generate_init_state,
@@ -207,6 +279,12 @@ class SASampler(BaseSampler):
 
         return response
 
+    def _get_result(self, system, model):
+        result, sys_info = super()._get_result(system, model)
+        if self._lattice_positions is not None:
+            result = np.array(result)[self._lattice_positions]
+        return result, sys_info
+
     def sample_hubo(self, interactions: list, var_type,
                     beta_min=None, beta_max=None, schedule=None,
                     num_sweeps=100, num_reads=1,
@@ -267,7 +345,7 @@ def geometric_ising_beta_schedule(model: openjij.model.BinaryQuadraticModel,
     """make geometric cooling beta schedule
 
     Args:
-        model (openjij.BinaryQuadraticModel)
+        model (openjij.BinaryQuadraticModel or openjij.PreparedModel)
         beta_max (float, optional): [description]. Defaults to None.
         beta_min (float, optional): [description]. Defaults to None.
         num_sweeps (int, optional): [description]. Defaults to 1000.
@@ -275,14 +353,21 @@ def geometric_ising_beta_schedule(model: openjij.model.BinaryQuadraticModel,
         list of cxxjij.utility.ClassicalSchedule, list of beta range [max, min]
     """
     if beta_min is None or beta_max is None:
-        ising_interaction = np.abs(model.ising_interactions())
-        abs_bias = np.sum(ising_interaction, axis=1)
+        if isinstance(model, openjij.PreparedModel):
+            # cached in the native problem
+            default_beta_min, default_beta_max = model.problem.beta_range()
+        else:
+            ising_interaction = np.abs(model.ising_interactions())
+            abs_bias = np.sum(ising_interaction, axis=1)
+
+            min_delta_energy = np.min(ising_interaction[ising_interaction > 0])
+            max_delta_energy = np.max(abs_bias[abs_bias > 0])
 
-        min_delta_energy = np.min(ising_interaction[ising_interaction > 0])
-        max_delta_energy = np.max(abs_bias[abs_bias > 0])
+            default_beta_min = np.log(2) / max_delta_energy
+            default_beta_max = np.log(100) / min_delta_energy
 
-    beta_min = np.log(2) / max_delta_energy if beta_min is None else beta_min
-    beta_max = np.log(100) / min_delta_energy if beta_max is None else beta_max
+        beta_min = default_beta_min if beta_min is None else beta_min
+        beta_max = default_beta_max if beta_max is None else beta_max
 
     num_sweeps_per_beta = max(1, num_sweeps // 1000)
 
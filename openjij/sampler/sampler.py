@@ -89,7 +89,7 @@ class BaseSampler(dimod.Sampler):
         execution_time = []
 
         # define sampling execution function ---------------
-        states, energies = [], []
+        states = []
         system_info = {'system': []}
         @measure_time
         def exec_sampling():
@@ -108,9 +108,8 @@ class BaseSampler(dimod.Sampler):
                 # ex. _sys_info save trotterized quantum state.
                 result_state, _sys_info = self._get_result(system, model)
 
-                # store result (state and energy)
+                # store result (energies are evaluated after sampling)
                 states.append(result_state)
-                energies.append(model.calc_energy(result_state))
 
                 if _sys_info:
                     system_info['system'].append(_sys_info)
@@ -119,6 +118,8 @@ class BaseSampler(dimod.Sampler):
         # Execute sampling function
         sampling_time = exec_sampling()
 
+        energies = self._calc_energies(model, states)
+
         # construct response instance
         response = openjij.Response.from_samples(
             (states, model.indices), self.var_type, energies,
@@ -144,6 +145,28 @@ class BaseSampler(dimod.Sampler):
                 'var_type should be openjij.SPIN or openjij.BINARY')
         return bqm
 
+    def _calc_energies(self, model, states):
+        """energies of the sampled states
+
+        Energies of SPIN models are evaluated natively for all the states at once.
+
+        Args:
+            model (openjij.BinaryQuadraticModel): model
+            states (list): sampled states
+        Returns:
+            list or numpy.ndarray: energies
+        """
+        if model.var_type != openjij.SPIN or len(states) == 0:
+            return [model.calc_energy(state) for state in states]
+        if isinstance(model, openjij.PreparedModel):
+            # graph of the prepared problem is in the order of model.indices
+            graph = model.problem.graph
+        else:
+            # Dense graph in the order of model.indices (derived models may build other graphs)
+            graph = openjij.BinaryQuadraticModel.get_cxxjij_ising_graph(model)
+        return cxxjij.result.calc_energies(
+            graph, np.array(states, dtype=np.int8))
+
     def _get_result(self, system, model):
         result = cxxjij.result.get_solution(system)
         sys_info = {}
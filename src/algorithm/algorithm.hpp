@@ -16,8 +16,11 @@
 #define SYSTEM_ALGORITHM_ALGORITHM_HPP__
 
 #include <functional>
+#include <stdexcept>
+#include <string>
 #include <system/system.hpp>
 #include <utility/schedule_list.hpp>
+#include <algorithm/checkpoint.hpp>
 
 namespace openjij {
     namespace algorithm {
@@ -46,6 +49,49 @@ namespace openjij {
                     }
                 }
             }
+
+            /**
+             * @brief run the schedule list, writing a checkpoint every checkpoint_interval schedules and after the last one
+             *
+             * If checkpoint_path already exists, the system and the random number engine are restored from it
+             * and the run resumes after the last finished schedule; the result is bit-identical to an uninterrupted run.
+             * A checkpoint of another run (interaction, schedule list or initial state of the engine) is rejected.
+             *
+             * @param system system (must have the same interaction as the checkpointed one)
+             * @param random_number_engine random number engine in the initial state of the run (must support operator<< and operator>>)
+             * @param schedule_list schedule list
+             * @param checkpoint_path path of the checkpoint file
+             * @param checkpoint_interval number of schedules between checkpoints
+             * @param callback callback called after each update
+             */
+            template<typename System, typename RandomNumberEngine>
+            static void run_with_checkpoint(System& system,
+                            RandomNumberEngine& random_number_engine,
+                            const utility::ScheduleList<typename system::get_system_type<System>::type>& schedule_list,
+                            const std::string& checkpoint_path,
+                            std::size_t checkpoint_interval,
+                            const std::function<void(const System&, const utility::UpdaterParameter<typename system::get_system_type<System>::type>&)>& callback = nullptr) {
+                if(checkpoint_interval == 0){
+                    throw std::invalid_argument("checkpoint_interval must be positive.");
+                }
+                //computed before the engine is restored, from its initial state
+                const auto fingerprint = make_run_fingerprint(system, random_number_engine, schedule_list);
+                std::size_t position = 0;
+                if(checkpoint_exists(checkpoint_path)){
+                    position = load_checkpoint(checkpoint_path, system, random_number_engine, fingerprint, schedule_list.size());
+                }
+                while(position < schedule_list.size()){
+                    const auto& schedule = schedule_list[position];
+                    for (std::size_t i = 0; i < schedule.one_mc_step; ++i) {
+                        Updater<System>::update(system, random_number_engine, schedule.updater_parameter);
+                        if(callback) callback(system, schedule.updater_parameter);
+                    }
+                    position++;
+                    if(position % checkpoint_interval == 0 || position == schedule_list.size()){
+                        save_checkpoint(checkpoint_path, system, random_number_engine, fingerprint, schedule_list.size(), position);
+                    }
+                }
+            }
         };
 
         //type alias (Monte Carlo method)
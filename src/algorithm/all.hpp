@@ -16,5 +16,6 @@
 #define OPENJIJ_ALGORITHM_ALL_HPP__
 
 #include <algorithm/algorithm.hpp>
+#include <algorithm/checkpoint.hpp>
 
 #endif
@@ -0,0 +1,300 @@
+//    Copyright 2019 Jij Inc.
+
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+
+//        http://www.apache.org/licenses/LICENSE-2.0
+
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+
+#ifndef OPENJIJ_ALGORITHM_CHECKPOINT_HPP__
+#define OPENJIJ_ALGORITHM_CHECKPOINT_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include <graph/graph.hpp>
+#include <system/system.hpp>
+#include <system/state_io.hpp>
+#include <utility/random.hpp>
+#include <utility/schedule_list.hpp>
+
+namespace openjij {
+    namespace algorithm {
+
+        /**
+         * @brief header of the checkpoint file (version 2)
+         *
+         * The header is followed by the system state (system::save_state)
+         * and the state of the random number engine (length (uint64) and the text written by operator<<).
+         */
+        struct CheckpointHeader{
+            char magic[8];                      /**< "OJCKPT" */
+            std::uint32_t version;              /**< format version */
+            std::uint32_t byte_order;           /**< 0x01020304 written in native byte order */
+            std::uint64_t fingerprint;          /**< fingerprint of the run (make_run_fingerprint) */
+            std::uint64_t num_schedules;        /**< size of the schedule list of the run */
+            std::uint64_t schedule_position;    /**< number of the finished schedules */
+        };
+
+        /**
+         * @brief current version of the checkpoint format
+         */
+        constexpr std::uint32_t checkpoint_format_version = 2;
+
+        namespace checkpoint_impl{
+
+            /**
+             * @brief FNV-1a hash
+             */
+            class Fingerprint{
+                private:
+                    std::uint64_t _hash = 14695981039346656037ull;
+
+                public:
+                    void add_bytes(const void* data, std::size_t size){
+                        const auto bytes = static_cast<const unsigned char*>(data);
+                        for(std::size_t k=0; k<size; k++){
+                            _hash = (_hash ^ bytes[k]) * 1099511628211ull;
+                        }
+                    }
+
+                    template<typename T>
+                    void add(const T& value){
+                        static_assert(std::is_arithmetic<T>::value, "only arithmetic values are hashed.");
+                        add_bytes(&value, sizeof(T));
+                    }
+
+                    std::uint64_t value() const{
+                        return _hash;
+                    }
+            };
+
+            /**
+             * @brief number of probe configurations of the interaction checksum
+             */
+            constexpr std::size_t num_probes = 4;
+
+            template<typename Interaction>
+                inline const Interaction& interaction_of(const Interaction& interaction){
+                    return interaction;
+                }
+
+            template<typename Interaction>
+                inline const Interaction& interaction_of(const system::SharedInteraction<Interaction>& interaction){
+                    return *interaction;
+                }
+
+            /**
+             * @brief checksum of a graph: number of spins and energies of fixed pseudo-random configurations
+             */
+            template<typename GraphType>
+                inline void add_interaction(Fingerprint& fingerprint, const GraphType& graph, std::true_type){
+                    const std::size_t num_spins = graph.get_num_spins();
+                    fingerprint.add<std::uint64_t>(num_spins);
+                    auto rng = utility::Xorshift(static_cast<unsigned>(num_spins));
+                    graph::Spins spins(num_spins);
+                    for(std::size_t probe=0; probe<num_probes; probe++){
+                        for(auto& spin : spins){
+                            spin = (rng() & 1u) ? 1 : -1;
+                        }
+                        fingerprint.add(graph.calc_energy(spins));
+                    }
+                }
+
+            /**
+             * @brief checksum of an Eigen interaction matrix: shape and s^T M s of fixed pseudo-random vectors
+             */
+            template<typename Matrix>
+                inline void add_interaction(Fingerprint& fingerprint, const Matrix& matrix, std::false_type){
+                    using Vector = Eigen::Matrix<typename Matrix::Scalar, Eigen::Dynamic, 1>;
+                    fingerprint.add<std::uint64_t>(matrix.rows());
+                    fingerprint.add<std::uint64_t>(matrix.cols());
+                    auto rng = utility::Xorshift(static_cast<unsigned>(matrix.cols()));
+                    Vector spins(matrix.cols());
+                    for(std::size_t probe=0; probe<num_probes; probe++){
+                        for(Eigen::Index i=0; i<spins.size(); i++){
+                            spins(i) = (rng() & 1u) ? 1 : -1;
+                        }
+                        const Vector field = matrix * spins;
+                        fingerprint.add(spins.dot(field));
+                    }
+                }
+
+            inline void add_parameter(Fingerprint& fingerprint, double beta){
+                fingerprint.add(beta);
+            }
+
+            inline void add_parameter(Fingerprint& fingerprint, const std::pair<double, double>& parameter){
+                fingerprint.add(parameter.first);
+                fingerprint.add(parameter.second);
+            }
+        } // namespace checkpoint_impl
+
+        /**
+         * @brief fingerprint identifying a run: interaction of the system, schedule list and initial state of the engine
+         *
+         * A checkpoint is resumed only by the run with the same fingerprint,
+         * so the engine must be in its initial state (e.g. constructed with the same seed) when it is computed.
+         * The interaction enters as a checksum (energies of a few fixed configurations), not bit for bit.
+         *
+         * @param system system
+         * @param random_number_engine random number engine in the initial state of the run
+         * @param schedule_list schedule list
+         *
+         * @return fingerprint
+         */
+        template<typename System, typename RandomNumberEngine>
+            inline std::uint64_t make_run_fingerprint(const System& system, const RandomNumberEngine& random_number_engine,
+                    const utility::ScheduleList<typename system::get_system_type<System>::type>& schedule_list){
+                checkpoint_impl::Fingerprint fingerprint;
+
+                const auto& interaction = checkpoint_impl::interaction_of(system.interaction);
+                using Interaction = typename std::decay<decltype(interaction)>::type;
+                checkpoint_impl::add_interaction(fingerprint, interaction, std::is_base_of<graph::Graph, Interaction>());
+
+                fingerprint.add<std::uint64_t>(schedule_list.size());
+                for(auto&& schedule : schedule_list){
+                    checkpoint_impl::add_parameter(fingerprint, schedule.updater_parameter.get_tuple());
+                    fingerprint.add<std::uint64_t>(schedule.one_mc_step);
+                }
+
+                std::ostringstream rng_state;
+                rng_state << random_number_engine;
+                const std::string rng_text = rng_state.str();
+                fingerprint.add_bytes(rng_text.data(), rng_text.size());
+
+                return fingerprint.value();
+            }
+
+        /**
+         * @brief write a checkpoint; the file is replaced only after the new one is written completely
+         *
+         * @param path path of the checkpoint file
+         * @param system system
+         * @param random_number_engine random number engine (must support operator<<)
+         * @param fingerprint fingerprint of the run (make_run_fingerprint)
+         * @param num_schedules size of the schedule list of the run
+         * @param schedule_position number of the finished schedules
+         */
+        template<typename System, typename RandomNumberEngine>
+            inline void save_checkpoint(const std::string& path, const System& system, const RandomNumberEngine& random_number_engine,
+                    std::uint64_t fingerprint, std::size_t num_schedules, std::size_t schedule_position){
+                CheckpointHeader header;
+                std::memset(&header, 0, sizeof(header));
+                std::memcpy(header.magic, "OJCKPT", 7);
+                header.version = checkpoint_format_version;
+                header.byte_order = 0x01020304u;
+                header.fingerprint = fingerprint;
+                header.num_schedules = num_schedules;
+                header.schedule_position = schedule_position;
+
+                std::ostringstream rng_state;
+                rng_state << random_number_engine;
+                const std::string rng_text = rng_state.str();
+                const std::uint64_t rng_length = rng_text.size();
+
+                const std::string temporary_path = path + ".tmp";
+                {
+                    std::ofstream ofs(temporary_path, std::ios::binary | std::ios::trunc);
+                    if(!ofs){
+                        throw std::runtime_error("save_checkpoint: cannot open " + temporary_path);
+                    }
+                    ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+                    system::save_state(ofs, system);
+                    ofs.write(reinterpret_cast<const char*>(&rng_length), sizeof(rng_length));
+                    ofs.write(rng_text.data(), static_cast<std::streamsize>(rng_text.size()));
+                    ofs.flush();
+                    if(!ofs){
+                        throw std::runtime_error("save_checkpoint: cannot write " + temporary_path);
+                    }
+                }
+                if(std::rename(temporary_path.c_str(), path.c_str()) != 0){
+                    //rename does not replace an existing file on some platforms
+                    std::remove(path.c_str());
+                    if(std::rename(temporary_path.c_str(), path.c_str()) != 0){
+                        throw std::runtime_error("save_checkpoint: cannot replace " + path);
+                    }
+                }
+            }
+
+        /**
+         * @brief restore the system and the random number engine from a checkpoint
+         *
+         * @param path path of the checkpoint file
+         * @param system system with the same interaction as the saved one
+         * @param random_number_engine random number engine (must support operator>>)
+         * @param fingerprint fingerprint of the run (must be equal to the saved one)
+         * @param num_schedules size of the schedule list of the run (must be equal to the saved one)
+         *
+         * @return number of the finished schedules
+         */
+        template<typename System, typename RandomNumberEngine>
+            inline std::size_t load_checkpoint(const std::string& path, System& system, RandomNumberEngine& random_number_engine,
+                    std::uint64_t fingerprint, std::size_t num_schedules){
+                std::ifstream ifs(path, std::ios::binary);
+                if(!ifs){
+                    throw std::runtime_error("load_checkpoint: cannot open " + path);
+                }
+                CheckpointHeader header;
+                if(!ifs.read(reinterpret_cast<char*>(&header), sizeof(header))){
+                    throw std::runtime_error("load_checkpoint: file is too short");
+                }
+                if(std::memcmp(header.magic, "OJCKPT", 7) != 0){
+                    throw std::runtime_error("load_checkpoint: not a checkpoint file");
+                }
+                if(header.version != checkpoint_format_version){
+                    throw std::runtime_error("load_checkpoint: unsupported version");
+                }
+                if(header.byte_order != 0x01020304u){
+                    throw std::runtime_error("load_checkpoint: byte order mismatch");
+                }
+                if(header.fingerprint != fingerprint || header.num_schedules != num_schedules || header.schedule_position > header.num_schedules){
+                    throw std::runtime_error("load_checkpoint: checkpoint of another run (interaction, schedule list or seed differs)");
+                }
+
+                system::load_state(ifs, system);
+
+                std::uint64_t rng_length = 0;
+                if(!ifs.read(reinterpret_cast<char*>(&rng_length), sizeof(rng_length))){
+                    throw std::runtime_error("load_checkpoint: file is too short");
+                }
+                std::string rng_text(rng_length, '\0');
+                if(!ifs.read(&rng_text[0], static_cast<std::streamsize>(rng_length))){
+                    throw std::runtime_error("load_checkpoint: file is too short");
+                }
+                std::istringstream rng_state(rng_text);
+                if(!(rng_state >> random_number_engine)){
+                    throw std::runtime_error("load_checkpoint: invalid state of the random number engine");
+                }
+                return static_cast<std::size_t>(header.schedule_position);
+            }
+
+        /**
+         * @brief check whether a checkpoint file exists
+         *
+         * @param path path of the checkpoint file
+         *
+         * @return true if the file can be opened
+         */
+        inline bool checkpoint_exists(const std::string& path){
+            return static_cast<bool>(std::ifstream(path, std::ios::binary));
+        }
+
+    } // namespace algorithm
+} // namespace openjij
+
+#endif
@@ -16,9 +16,21 @@
 #define OPENJIJ_GRAPH_ALL_HPP__
 
 #include <graph/graph.hpp>
+#include <graph/packed_spins.hpp>
 #include <graph/dense.hpp>
 #include <graph/sparse.hpp>
 #include <graph/square.hpp>
 #include <graph/chimera.hpp>
+#include <graph/king_graph.hpp>
+#include <graph/lattice.hpp>
+#include <graph/csr_sparse.hpp>
+#include <graph/dense_matrix.hpp>
+#include <graph/quantized.hpp>
+#include <graph/reorder.hpp>
+#include <graph/binary_format.hpp>
+#include <graph/parser.hpp>
+#include <graph/delta.hpp>
+#include <graph/polynomial.hpp>
+#include <graph/reduction.hpp>
 
 #endif
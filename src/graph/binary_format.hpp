@@ -0,0 +1,291 @@
+//    Copyright 2019 Jij Inc.
+
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+
+//        http://www.apache.org/licenses/LICENSE-2.0
+
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+
+#ifndef OPENJIJ_GRAPH_BINARY_FORMAT_HPP__
+#define OPENJIJ_GRAPH_BINARY_FORMAT_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include <graph/csr_sparse.hpp>
+#include <graph/dense_matrix.hpp>
+#include <utility/mapped_file.hpp>
+
+namespace openjij {
+    namespace graph {
+
+        /**
+         * @brief kind of graph stored in a binary file
+         */
+        enum class BinaryKind : std::uint32_t{
+            CSR = 0,   /**< CSRSparse: row offsets, edges and local fields */
+            DENSE = 1, /**< DenseMatrix: full symmetric row-major matrix (padded rows) and local fields */
+        };
+
+        /**
+         * @brief header of the binary graph format (version 1)
+         *
+         * The header is followed by sections, each starting at the offset recorded in section_offsets (aligned to 64 bytes).
+         * CSR: [0] row offsets (num_spins+1 indices), [1] edges (num_elements edges), [2] local fields (num_spins floats).
+         * DENSE: [0] interactions (num_spins x num_elements floats), [1] local fields (num_spins floats).
+         * Arrays are stored in the native representation; the header records the byte order and the sizes of the types.
+         */
+        struct BinaryHeader{
+            char magic[8];                      /**< "OPENJIJ" */
+            std::uint32_t version;              /**< format version */
+            std::uint32_t byte_order;           /**< 0x01020304 written in native byte order */
+            BinaryKind kind;                    /**< kind of graph */
+            std::uint32_t index_size;           /**< sizeof(Index) */
+            std::uint32_t float_size;           /**< sizeof(FloatType) */
+            std::uint32_t element_size;         /**< sizeof(CSRSparse::Edge) (CSR) or sizeof(FloatType) (DENSE) */
+            std::uint64_t num_spins;            /**< number of spins */
+            std::uint64_t num_elements;         /**< number of stored edges (CSR) or row stride (DENSE) */
+            std::uint64_t section_offsets[3];   /**< byte offsets of the sections from the beginning of the file */
+        };
+
+        /**
+         * @brief current version of the binary format
+         */
+        constexpr std::uint32_t binary_format_version = 1;
+
+        /**
+         * @brief alignment of each section in bytes
+         */
+        constexpr std::size_t binary_section_alignment = 64;
+
+        namespace binary_format_impl{
+
+            inline BinaryHeader make_header(BinaryKind kind, std::uint32_t float_size, std::uint32_t element_size, std::uint64_t num_spins, std::uint64_t num_elements){
+                BinaryHeader header;
+                std::memset(&header, 0, sizeof(header));
+                std::memcpy(header.magic, "OPENJIJ", 8);
+                header.version = binary_format_version;
+                header.byte_order = 0x01020304u;
+                header.kind = kind;
+                header.index_size = sizeof(Index);
+                header.float_size = float_size;
+                header.element_size = element_size;
+                header.num_spins = num_spins;
+                header.num_elements = num_elements;
+                return header;
+            }
+
+            inline std::uint64_t align(std::uint64_t offset){
+                return (offset + binary_section_alignment - 1) / binary_section_alignment * binary_section_alignment;
+            }
+
+            /**
+             * @brief assign aligned offsets to sections of the given sizes
+             */
+            inline void set_offsets(BinaryHeader& header, const std::uint64_t* sizes, std::size_t num_sections){
+                std::uint64_t offset = align(sizeof(BinaryHeader));
+                for(std::size_t k=0; k<num_sections; k++){
+                    header.section_offsets[k] = offset;
+                    offset = align(offset + sizes[k]);
+                }
+            }
+
+            inline void write_sections(const std::string& path, const BinaryHeader& header, const char* const* sections, const std::uint64_t* sizes, std::size_t num_sections){
+                std::ofstream ofs(path, std::ios::binary | std::ios::trunc);
+                if(!ofs){
+                    throw std::runtime_error("save_binary: cannot open " + path);
+                }
+                ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+                std::uint64_t pos = sizeof(header);
+                const char zeros[binary_section_alignment] = {};
+                for(std::size_t k=0; k<num_sections; k++){
+                    ofs.write(zeros, static_cast<std::streamsize>(header.section_offsets[k] - pos));
+                    ofs.write(sections[k], static_cast<std::streamsize>(sizes[k]));
+                    pos = header.section_offsets[k] + sizes[k];
+                }
+                if(!ofs){
+                    throw std::runtime_error("save_binary: cannot write " + path);
+                }
+            }
+
+            /**
+             * @brief map a file and validate its header
+             */
+            inline std::shared_ptr<utility::MappedFile> open(const std::string& path, BinaryKind kind, std::uint32_t float_size, std::uint32_t element_size, BinaryHeader& header){
+                auto file = std::make_shared<utility::MappedFile>(path);
+                if(file->size() < sizeof(BinaryHeader)){
+                    throw std::runtime_error("load_binary: file is too small: " + path);
+                }
+                std::memcpy(&header, file->data(), sizeof(header));
+                if(std::memcmp(header.magic, "OPENJIJ", 8) != 0){
+                    throw std::runtime_error("load_binary: not an OpenJij binary graph: " + path);
+                }
+                if(header.version != binary_format_version){
+                    throw std::runtime_error("load_binary: unsupported format version: " + std::to_string(header.version));
+                }
+                if(header.byte_order != 0x01020304u){
+                    throw std::runtime_error("load_binary: byte order mismatch");
+                }
+                if(header.kind != kind){
+                    throw std::runtime_error("load_binary: graph kind mismatch");
+                }
+                if(header.index_size != sizeof(Index) || header.float_size != float_size || header.element_size != element_size){
+                    throw std::runtime_error("load_binary: type size mismatch");
+                }
+                return file;
+            }
+
+            inline void check_section(const utility::MappedFile& file, std::uint64_t offset, std::uint64_t size){
+                if(offset % binary_section_alignment != 0 || offset > file.size() || size > file.size() - offset){
+                    throw std::runtime_error("load_binary: truncated or corrupted file");
+                }
+            }
+
+            /**
+             * @brief size in bytes of count elements (a product that overflows is rejected instead of wrapping around)
+             */
+            inline std::uint64_t section_size(std::uint64_t count, std::uint64_t element_size){
+                if(element_size != 0 && count > std::numeric_limits<std::uint64_t>::max() / element_size){
+                    throw std::runtime_error("load_binary: truncated or corrupted file");
+                }
+                return count*element_size;
+            }
+
+            /**
+             * @brief number of spins in the header (num_spins+1 must be representable by std::size_t)
+             */
+            inline std::size_t num_spins(const BinaryHeader& header){
+                if(header.num_spins >= std::numeric_limits<std::size_t>::max()){
+                    throw std::runtime_error("load_binary: truncated or corrupted file");
+                }
+                return static_cast<std::size_t>(header.num_spins);
+            }
+        } // namespace binary_format_impl
+
+        /**
+         * @brief save CSRSparse graph in the binary format
+         *
+         * @tparam FloatType floating-point type
+         * @param graph graph to be saved
+         * @param path output path
+         */
+        template<typename FloatType>
+            inline void save_binary(const CSRSparse<FloatType>& graph, const std::string& path){
+                using Edge = typename CSRSparse<FloatType>::Edge;
+                auto header = binary_format_impl::make_header(BinaryKind::CSR, sizeof(FloatType), sizeof(Edge), graph.get_num_spins(), graph.get_num_stored_edges());
+                const std::uint64_t sizes[3] = {
+                    (graph.get_num_spins()+1)*sizeof(std::size_t),
+                    graph.get_num_stored_edges()*sizeof(Edge),
+                    graph.get_num_spins()*sizeof(FloatType)
+                };
+                const char* sections[3] = {
+                    reinterpret_cast<const char*>(graph.row_offsets()),
+                    reinterpret_cast<const char*>(graph.edges()),
+                    reinterpret_cast<const char*>(graph.fields())
+                };
+                binary_format_impl::set_offsets(header, sizes, 3);
+                binary_format_impl::write_sections(path, header, sections, sizes, 3);
+            }
+
+        /**
+         * @brief save DenseMatrix graph in the binary format
+         *
+         * @tparam FloatType floating-point type
+         * @param graph graph to be saved
+         * @param path output path
+         */
+        template<typename FloatType>
+            inline void save_binary(const DenseMatrix<FloatType>& graph, const std::string& path){
+                auto header = binary_format_impl::make_header(BinaryKind::DENSE, sizeof(FloatType), sizeof(FloatType), graph.get_num_spins(), graph.get_stride());
+                const std::uint64_t sizes[2] = {
+                    graph.get_num_spins()*graph.get_stride()*sizeof(FloatType),
+                    graph.get_num_spins()*sizeof(FloatType)
+                };
+                const char* sections[2] = {
+                    reinterpret_cast<const char*>(graph.get_num_spins() > 0 ? graph.row(0) : graph.fields()),
+                    reinterpret_cast<const char*>(graph.fields())
+                };
+                binary_format_impl::set_offsets(header, sizes, 2);
+                binary_format_impl::write_sections(path, header, sections, sizes, 2);
+            }
+
+        /**
+         * @brief load CSRSparse graph from the binary format (memory-mapped, read-only, no copy)
+         *
+         * @tparam FloatType floating-point type
+         * @param path input path
+         *
+         * @return graph viewing the mapped file (the mapping is released when the graph and all its copies are destroyed)
+         */
+        template<typename FloatType>
+            inline CSRSparse<FloatType> load_csr_sparse(const std::string& path){
+                using Edge = typename CSRSparse<FloatType>::Edge;
+                BinaryHeader header;
+                auto file = binary_format_impl::open(path, BinaryKind::CSR, sizeof(FloatType), sizeof(Edge), header);
+                const std::size_t num_spins = binary_format_impl::num_spins(header);
+                binary_format_impl::check_section(*file, header.section_offsets[0], binary_format_impl::section_size(num_spins+1, sizeof(std::size_t)));
+                binary_format_impl::check_section(*file, header.section_offsets[1], binary_format_impl::section_size(header.num_elements, sizeof(Edge)));
+                binary_format_impl::check_section(*file, header.section_offsets[2], binary_format_impl::section_size(num_spins, sizeof(FloatType)));
+
+                //the updaters index the arrays without bounds checks, so that the whole structure is validated here
+                const auto row_offsets = reinterpret_cast<const std::size_t*>(file->data() + header.section_offsets[0]);
+                if(row_offsets[0] != 0 || row_offsets[num_spins] != header.num_elements){
+                    throw std::runtime_error("load_binary: inconsistent row offsets");
+                }
+                for(std::size_t i=0; i<num_spins; i++){
+                    if(row_offsets[i] > row_offsets[i+1]){
+                        throw std::runtime_error("load_binary: inconsistent row offsets");
+                    }
+                }
+                const auto edges = reinterpret_cast<const Edge*>(file->data() + header.section_offsets[1]);
+                for(std::size_t k=0; k<header.num_elements; k++){
+                    if(!(edges[k].index < num_spins)){
+                        throw std::runtime_error("load_binary: edge index out of range");
+                    }
+                }
+                return CSRSparse<FloatType>(num_spins, row_offsets, edges,
+                        reinterpret_cast<const FloatType*>(file->data() + header.section_offsets[2]),
+                        file);
+            }
+
+        /**
+         * @brief load DenseMatrix graph from the binary format (memory-mapped, read-only, no copy)
+         *
+         * @tparam FloatType floating-point type
+         * @param path input path
+         *
+         * @return graph viewing the mapped file (the mapping is released when the graph and all its copies are destroyed)
+         */
+        template<typename FloatType>
+            inline DenseMatrix<FloatType> load_dense_matrix(const std::string& path){
+                BinaryHeader header;
+                auto file = binary_format_impl::open(path, BinaryKind::DENSE, sizeof(FloatType), sizeof(FloatType), header);
+                const std::size_t num_spins = binary_format_impl::num_spins(header);
+                binary_format_impl::check_section(*file, header.section_offsets[1], binary_format_impl::section_size(num_spins, sizeof(FloatType)));
+                //the rows must be padded to the stride of num_spins (in particular, stride >= num_spins)
+                if(header.num_elements != DenseMatrix<FloatType>::calc_stride(num_spins)){
+                    throw std::runtime_error("load_binary: invalid row stride");
+                }
+                binary_format_impl::check_section(*file, header.section_offsets[0],
+                        binary_format_impl::section_size(num_spins, binary_format_impl::section_size(header.num_elements, sizeof(FloatType))));
+                return DenseMatrix<FloatType>(num_spins, header.num_elements,
+                        reinterpret_cast<const FloatType*>(file->data() + header.section_offsets[0]),
+                        reinterpret_cast<const FloatType*>(file->data() + header.section_offsets[1]),
+                        file);
+            }
+    } // namespace graph
+} // namespace openjij
+
+#endif
@@ -15,10 +15,12 @@
 #ifndef OPENJIJ_GRAPH_CHIMERA_HPP__
 #define OPENJIJ_GRAPH_CHIMERA_HPP__
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <type_traits>
 #include <tuple>
+#include <vector>
 
 #include <graph/sparse.hpp>
 
@@ -262,6 +264,12 @@ namespace openjij {
                  */
                 std::size_t get_num_in_chimera() const{return _num_in_chimera;}
 
+                /**
+                 * @brief access J_{ij} and h_{i} by global indices (as in Sparse)
+                 */
+                using Sparse<FloatType>::J;
+                using Sparse<FloatType>::h;
+
                 /**
                  * @brief access J(row, colum, in-chimera, direction)
                  *
@@ -412,6 +420,145 @@ namespace openjij {
                     return spins[to_ind(r, c, i)];
                 }
         };
+
+        /**
+         * @brief couplings of a chimera graph stored in per-direction arrays (same layout as the GPU ChimeraInteractions)
+         *
+         * Every array is indexed by the global index of the spin.
+         * J_out_p (J_out_n) is the coupling to the previous (next) unit: the row direction for in-chimera index 0-3
+         * and the column direction for 4-7.
+         * J_in_04..J_in_37 are the couplings to the in-chimera partners 0or4..3or7.
+         * A coupling is zero if the bond does not exist (e.g. open boundary). On small periodic lattices where the
+         * previous and the next units coincide, the bond is counted once (in J_out_p).
+         *
+         * @tparam FloatType floating-point type
+         */
+        template<typename FloatType>
+        struct ChimeraCouplings{
+            using value_type = FloatType;
+
+            std::vector<FloatType> J_out_p; //previous
+            std::vector<FloatType> J_out_n; //next
+            std::vector<FloatType> J_in_04;
+            std::vector<FloatType> J_in_15;
+            std::vector<FloatType> J_in_26;
+            std::vector<FloatType> J_in_37;
+            std::vector<FloatType> h;
+
+            /**
+             * @brief number of spins in a row of units (num_column * 8)
+             */
+            std::size_t row_stride;
+
+            /**
+             * @brief number of columns
+             */
+            std::size_t num_column;
+
+            /**
+             * @brief total number of spins
+             */
+            std::size_t num_spins;
+
+            /**
+             * @brief ChimeraCouplings constructor
+             *
+             * @param graph chimera graph
+             */
+            explicit ChimeraCouplings(const Chimera<FloatType>& graph)
+                : J_out_p(graph.get_num_spins(), 0), J_out_n(graph.get_num_spins(), 0),
+                J_in_04(graph.get_num_spins(), 0), J_in_15(graph.get_num_spins(), 0),
+                J_in_26(graph.get_num_spins(), 0), J_in_37(graph.get_num_spins(), 0),
+                h(graph.get_num_spins(), 0),
+                row_stride(graph.get_num_column()*graph.get_num_in_chimera()), num_column(graph.get_num_column()), num_spins(graph.get_num_spins()){
+
+                    //coupling of an existing bond (zero otherwise)
+                    auto bond = [&graph](Index from, Index to) -> FloatType{
+                        if(from == to) return 0;
+                        const auto& nodes = graph.adj_nodes(from);
+                        return (std::find(nodes.begin(), nodes.end(), to) != nodes.end()) ? graph.J(from, to) : 0;
+                    };
+
+                    for(std::size_t ind=0; ind<num_spins; ind++){
+                        const Index p = prev(ind);
+                        const Index n = next(ind);
+                        J_out_p[ind] = bond(ind, p);
+                        J_out_n[ind] = (n != p) ? bond(ind, n) : 0;
+
+                        const Index other = partner(ind);
+                        J_in_04[ind] = graph.J(ind, other+0);
+                        J_in_15[ind] = graph.J(ind, other+1);
+                        J_in_26[ind] = graph.J(ind, other+2);
+                        J_in_37[ind] = graph.J(ind, other+3);
+
+                        h[ind] = graph.h(ind);
+                    }
+                }
+
+            /**
+             * @brief index of the first in-chimera partner (0 or 4 in the same unit)
+             *
+             * @param ind global index
+             *
+             * @return global index of the partner 0or4 (the others follow contiguously)
+             */
+            Index partner(Index ind) const{
+                return (ind & ~Index(7)) + ((ind & 4) ^ 4);
+            }
+
+            /**
+             * @brief index of the spin in the previous unit (periodic)
+             *
+             * @param ind global index
+             *
+             * @return global index
+             */
+            Index prev(Index ind) const{
+                if((ind & 4) == 0){
+                    //row direction
+                    return (ind >= row_stride) ? ind - row_stride : ind + num_spins - row_stride;
+                }
+                //column direction
+                return ((ind / 8) % num_column != 0) ? ind - 8 : ind + row_stride - 8;
+            }
+
+            /**
+             * @brief index of the spin in the next unit (periodic)
+             *
+             * @param ind global index
+             *
+             * @return global index
+             */
+            Index next(Index ind) const{
+                if((ind & 4) == 0){
+                    //row direction
+                    return (ind + row_stride < num_spins) ? ind + row_stride : ind + row_stride - num_spins;
+                }
+                //column direction
+                return ((ind / 8) % num_column != num_column-1) ? ind + 8 : ind + 8 - row_stride;
+            }
+
+            /**
+             * @brief calculate local field of a spin (h_i + \sum_j J_{ij} s_j) with fixed neighbor offsets
+             *
+             * @param ind global index
+             * @param spins spin configuration
+             *
+             * @return local field
+             */
+            FloatType local_field(Index ind, const Spins& spins) const{
+                assert(spins.size() == num_spins);
+                const Spin* s = spins.data();
+                const Index other = partner(ind);
+                return h[ind]
+                    + J_in_04[ind] * s[other+0]
+                    + J_in_15[ind] * s[other+1]
+                    + J_in_26[ind] * s[other+2]
+                    + J_in_37[ind] * s[other+3]
+                    + J_out_p[ind] * s[prev(ind)]
+                    + J_out_n[ind] * s[next(ind)];
+            }
+        };
     } // namespace graph
 } // namespace openjij
 
@@ -0,0 +1,319 @@
+//    Copyright 2019 Jij Inc.
+
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+
+//        http://www.apache.org/licenses/LICENSE-2.0
+
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+
+#ifndef OPENJIJ_GRAPH_CSR_SPARSE_HPP__
+#define OPENJIJ_GRAPH_CSR_SPARSE_HPP__
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include <graph/graph.hpp>
+
+namespace openjij {
+    namespace graph {
+
+        /**
+         * @brief immutable sparse graph in compressed sparse row (CSR) layout
+         *
+         * The adjacent nodes of each site are stored contiguously and sorted by index,
+         * with the coupling interleaved next to the neighbor index.
+         * Local fields are kept in a separate array, so that the rows contain only two-body interactions.
+         * Build a Dense or Sparse graph first and freeze it into this class before running updaters.
+         *
+         * @tparam FloatType floating-point type
+         */
+        template<typename FloatType>
+            class CSRSparse : public Graph{
+                static_assert(std::is_floating_point<FloatType>::value, "FloatType must be floating-point type.");
+                public:
+
+                    /**
+                     * @brief float type
+                     */
+                    using value_type = FloatType;
+
+                    /**
+                     * @brief element of a row (adjacent node and corresponding coupling)
+                     */
+                    struct Edge{
+                        /**
+                         * @brief index of adjacent node
+                         */
+                        Index index;
+
+                        /**
+                         * @brief coupling J_{ij}
+                         */
+                        FloatType value;
+                    };
+
+                    /**
+                     * @brief range of edges in a row
+                     */
+                    class Row{
+                        private:
+                            const Edge* _begin;
+                            const Edge* _end;
+                        public:
+                            /**
+                             * @brief Row constructor
+                             *
+                             * @param begin pointer to the first edge
+                             * @param end pointer to the past-the-end edge
+                             */
+                            Row(const Edge* begin, const Edge* end) : _begin(begin), _end(end){}
+
+                            /**
+                             * @brief first edge
+                             */
+                            const Edge* begin() const{ return _begin; }
+
+                            /**
+                             * @brief past-the-end edge
+                             */
+                            const Edge* end() const{ return _end; }
+
+                            /**
+                             * @brief number of edges in the row
+                             */
+                            std::size_t size() const{ return static_cast<std::size_t>(_end - _begin); }
+                    };
+
+                private:
+
+                    /**
+                     * @brief owner of the arrays below (heap buffers or a memory-mapped file)
+                     */
+                    std::shared_ptr<const void> _storage;
+
+                    /**
+                     * @brief offsets of each row in _edges (size: num_spins+1)
+                     */
+                    const std::size_t* _row_offsets;
+
+                    /**
+                     * @brief adjacent nodes and couplings (row-major, sorted by index in each row)
+                     */
+                    const Edge* _edges;
+
+                    /**
+                     * @brief local fields
+                     */
+                    const FloatType* _h;
+
+                    /**
+                     * @brief arrays owned by a CSRSparse built in memory
+                     */
+                    struct Buffers{
+                        std::vector<std::size_t> row_offsets;
+                        std::vector<Edge> edges;
+                        std::vector<FloatType> h;
+                    };
+
+                public:
+
+                    /**
+                     * @brief CSRSparse constructor (freeze Dense, Sparse or derived class of them)
+                     *
+                     * @tparam GraphType type of graph
+                     * @param graph graph to be converted
+                     */
+                    template<typename GraphType>
+                        explicit CSRSparse(const GraphType& graph)
+                        : Graph(graph.get_num_spins()){
+                            const std::size_t num_spins = graph.get_num_spins();
+                            auto buffers = std::make_shared<Buffers>();
+                            auto& row_offsets = buffers->row_offsets;
+                            auto& edges = buffers->edges;
+                            auto& h = buffers->h;
+                            row_offsets.assign(num_spins+1, 0);
+                            h.assign(num_spins, 0);
+
+                            //count the number of off-diagonal elements in each row
+                            for(std::size_t i=0; i<num_spins; i++){
+                                std::size_t count = 0;
+                                for(auto&& adj_ind : graph.adj_nodes(i)){
+                                    if(adj_ind != i) count++;
+                                }
+                                row_offsets[i+1] = row_offsets[i] + count;
+                            }
+
+                            edges.resize(row_offsets[num_spins]);
+
+                            for(std::size_t i=0; i<num_spins; i++){
+                                std::size_t pos = row_offsets[i];
+                                for(auto&& adj_ind : graph.adj_nodes(i)){
+                                    if(adj_ind != i){
+                                        edges[pos++] = Edge{adj_ind, graph.J(i, adj_ind)};
+                                    }
+                                    else{
+                                        h[i] = graph.h(i);
+                                    }
+                                }
+                                std::sort(edges.begin()+row_offsets[i], edges.begin()+row_offsets[i+1],
+                                        [](const Edge& a, const Edge& b){return a.index < b.index;});
+                            }
+
+                            _row_offsets = row_offsets.data();
+                            _edges = edges.data();
+                            _h = h.data();
+                            _storage = std::move(buffers);
+                        }
+
+                    /**
+                     * @brief CSRSparse constructor viewing external arrays (e.g. a memory-mapped file) without copying
+                     *
+                     * @param num_spins number of spins
+                     * @param row_offsets offsets of each row (size: num_spins+1)
+                     * @param edges adjacent nodes and couplings (sorted by index in each row)
+                     * @param h local fields
+                     * @param storage owner of the arrays (kept alive as long as this graph or its copies exist)
+                     */
+                    CSRSparse(std::size_t num_spins, const std::size_t* row_offsets, const Edge* edges, const FloatType* h, std::shared_ptr<const void> storage)
+                        : Graph(num_spins), _storage(std::move(storage)), _row_offsets(row_offsets), _edges(edges), _h(h){}
+
+                    /**
+                     * @brief CSRSparse copy constructor (the immutable arrays are shared, not copied)
+                     *
+                     */
+                    CSRSparse(const CSRSparse<FloatType>&) = default;
+
+                    /**
+                     * @brief CSRSparse move constructor
+                     *
+                     */
+                    CSRSparse(CSRSparse<FloatType>&&) = default;
+
+                    /**
+                     * @brief edges (adjacent nodes and couplings) of a site, local field excluded
+                     *
+                     * @param ind Node index
+                     *
+                     * @return range of edges
+                     */
+                    Row adj_edges(Index ind) const{
+                        assert(ind < get_num_spins());
+                        return Row(_edges + _row_offsets[ind], _edges + _row_offsets[ind+1]);
+                    }
+
+                    /**
+                     * @brief number of adjacent nodes of a site (local field excluded)
+                     *
+                     * @param ind Node index
+                     *
+                     * @return degree
+                     */
+                    std::size_t degree(Index ind) const{
+                        assert(ind < get_num_spins());
+                        return _row_offsets[ind+1] - _row_offsets[ind];
+                    }
+
+                    /**
+                     * @brief get total number of stored (directed) edges
+                     *
+                     * @return number of edges
+                     */
+                    std::size_t get_num_stored_edges() const{
+                        return _row_offsets[get_num_spins()];
+                    }
+
+                    /**
+                     * @brief row offsets (size: num_spins+1)
+                     *
+                     * @return pointer to the row offsets
+                     */
+                    const std::size_t* row_offsets() const{
+                        return _row_offsets;
+                    }
+
+                    /**
+                     * @brief all edges (size: get_num_stored_edges())
+                     *
+                     * @return pointer to the first edge
+                     */
+                    const Edge* edges() const{
+                        return _edges;
+                    }
+
+                    /**
+                     * @brief local fields (size: num_spins)
+                     *
+                     * @return pointer to the local fields
+                     */
+                    const FloatType* fields() const{
+                        return _h;
+                    }
+
+                    /**
+                     * @brief calculate total energy
+                     *
+                     * @param spins
+                     *
+                     * @return corresponding energy
+                     */
+                    FloatType calc_energy(const Spins& spins) const{
+                        assert(spins.size() == get_num_spins());
+                        FloatType ret = 0;
+                        for(std::size_t ind=0; ind<this->get_num_spins(); ind++){
+                            FloatType local = 0;
+                            for(auto&& edge : adj_edges(ind)){
+                                local += edge.value * spins[edge.index];
+                            }
+                            ret += ((1./2) * local + _h[ind]) * spins[ind];
+                        }
+                        return ret;
+                    }
+
+                    /**
+                     * @brief access J_{ij} (binary search in the row)
+                     *
+                     * @param i Index i
+                     * @param j Index j
+                     *
+                     * @return J_{ij}
+                     */
+                    const FloatType& J(Index i, Index j) const{
+                        assert(i < get_num_spins());
+                        assert(j < get_num_spins());
+                        if(i == j) return _h[i];
+                        const auto row = adj_edges(i);
+                        const Edge* it = std::lower_bound(row.begin(), row.end(), j,
+                                [](const Edge& e, Index ind){return e.index < ind;});
+                        if(it == row.end() || it->index != j){
+                            throw std::out_of_range("CSRSparse::J: the interaction does not exist.");
+                        }
+                        return it->value;
+                    }
+
+                    /**
+                     * @brief access h_{i} (local field)
+                     *
+                     * @param i Index i
+                     *
+                     * @return h_{i}
+                     */
+                    const FloatType& h(Index i) const{
+                        assert(i < get_num_spins());
+                        return _h[i];
+                    }
+            };
+    } // namespace graph
+} // namespace openjij
+
+#endif
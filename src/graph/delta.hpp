@@ -0,0 +1,141 @@
+//    Copyright 2019 Jij Inc.
+
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+
+//        http://www.apache.org/licenses/LICENSE-2.0
+
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+
+#ifndef OPENJIJ_GRAPH_DELTA_HPP__
+#define OPENJIJ_GRAPH_DELTA_HPP__
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <graph/graph.hpp>
+
+namespace openjij {
+    namespace graph {
+
+        /**
+         * @brief list of changed interactions (dirty entries) to be applied to a graph or a system in place
+         *
+         * Entries are applied in the recorded order, so that a later assignment to the same element wins.
+         *
+         * @tparam FloatType floating-point type
+         */
+        template<typename FloatType>
+        class Delta{
+            static_assert(std::is_floating_point<FloatType>::value, "FloatType must be floating-point type.");
+            public:
+
+                using value_type = FloatType;
+
+                /**
+                 * @brief changed element (i == j denotes the local field h_i)
+                 */
+                struct Entry{
+                    Index i;
+                    Index j;
+                    FloatType value;
+                };
+
+            private:
+
+                /**
+                 * @brief recorded entries
+                 */
+                std::vector<Entry> _entries;
+
+            public:
+
+                /**
+                 * @brief record J_{ij} = value
+                 *
+                 * @param i index
+                 * @param j index (must be different from i)
+                 * @param value new interaction
+                 */
+                void set_J(Index i, Index j, FloatType value){
+                    assert(i != j);
+                    _entries.push_back(Entry{std::min(i, j), std::max(i, j), value});
+                }
+
+                /**
+                 * @brief record h_i = value
+                 *
+                 * @param i index
+                 * @param value new local field
+                 */
+                void set_h(Index i, FloatType value){
+                    _entries.push_back(Entry{i, i, value});
+                }
+
+                /**
+                 * @brief get recorded entries
+                 *
+                 * @return entries in the recorded order
+                 */
+                const std::vector<Entry>& entries() const{
+                    return _entries;
+                }
+
+                /**
+                 * @brief get number of recorded entries
+                 *
+                 * @return number of entries
+                 */
+                std::size_t size() const{
+                    return _entries.size();
+                }
+
+                /**
+                 * @brief check if nothing is recorded
+                 *
+                 * @return true if no entry is recorded
+                 */
+                bool empty() const{
+                    return _entries.empty();
+                }
+
+                /**
+                 * @brief discard recorded entries
+                 */
+                void clear(){
+                    _entries.clear();
+                }
+
+                /**
+                 * @brief apply the entries to a graph
+                 *
+                 * @tparam GraphType type of graph (assume Dense, Sparse or derived class of them)
+                 * @param graph graph to be modified
+                 */
+                template<typename GraphType>
+                    void apply(GraphType& graph) const{
+                        for(auto&& e : _entries){
+                            assert(e.i < graph.get_num_spins() && e.j < graph.get_num_spins());
+                            if(e.i == e.j){
+                                graph.h(e.i) = e.value;
+                            }
+                            else{
+                                graph.J(e.i, e.j) = e.value;
+                            }
+                        }
+                    }
+        };
+
+    } // namespace graph
+} // namespace openjij
+
+#endif
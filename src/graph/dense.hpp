@@ -111,6 +111,41 @@ namespace openjij {
                         }
 
 
+                    /**
+                     * @brief Dense constructor from a row-major num_spins x num_spins matrix
+                     *
+                     * Only the upper triangle (i <= j) of the matrix is read; the diagonal is regarded as local fields.
+                     * Nonzero elements are registered as adjacent nodes in a single pass.
+                     *
+                     * @tparam T element type of the matrix
+                     * @param num_spins the number of spins
+                     * @param matrix pointer to the first element of the contiguous matrix
+                     */
+                    template<typename T>
+                    Dense(std::size_t num_spins, const T* matrix)
+                        : Graph(num_spins), _J(num_spins*(num_spins+1)/2), _list_adj_nodes(num_spins){
+                            //initialize list_adj_nodes
+                            for(auto& elem : _list_adj_nodes){
+                                elem.reserve(num_spins);
+                            }
+
+                            //the packed triangular layout is row-major as well, so that _J is filled sequentially
+                            std::size_t pos = 0;
+                            for(std::size_t i=0; i<num_spins; i++){
+                                const T* row = matrix + i*num_spins;
+                                for(std::size_t j=i; j<num_spins; j++, pos++){
+                                    assert(pos == convert_index(i, j));
+                                    const FloatType val = static_cast<FloatType>(row[j]);
+                                    _J[pos] = val;
+                                    if(val != 0){
+                                        //each pair is visited once, so that no search is needed
+                                        _list_adj_nodes[i].push_back(j);
+                                        if(i != j) _list_adj_nodes[j].push_back(i);
+                                    }
+                                }
+                            }
+                        }
+
                     /**
                      * @brief Dense copy constructor
                      */
@@ -0,0 +1,283 @@
+//    Copyright 2019 Jij Inc.
+
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+
+//        http://www.apache.org/licenses/LICENSE-2.0
+
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+
+#ifndef OPENJIJ_GRAPH_DENSE_MATRIX_HPP__
+#define OPENJIJ_GRAPH_DENSE_MATRIX_HPP__
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include <graph/graph.hpp>
+#include <graph/dense.hpp>
+#include <utility/memory.hpp>
+
+namespace openjij {
+    namespace graph {
+
+        /**
+         * @brief immutable all-to-all interactions stored as a full symmetric row-major matrix
+         *
+         * Unlike Dense, no adjacency list is materialized (every pair of spins is regarded as adjacent).
+         * Each row is aligned and padded to a cache line, so that a local field is a contiguous dot product.
+         * The diagonal of the matrix is zero and local fields are kept in a separate array.
+         *
+         * @tparam FloatType floating-point type
+         */
+        template<typename FloatType>
+            class DenseMatrix : public Graph{
+                static_assert(std::is_floating_point<FloatType>::value, "FloatType must be floating-point type.");
+                public:
+
+                    /**
+                     * @brief float type
+                     */
+                    using value_type = FloatType;
+
+                    /**
+                     * @brief alignment of each row in bytes
+                     */
+                    static constexpr std::size_t alignment = 64;
+
+                    /**
+                     * @brief interaction type
+                     */
+                    using Interactions = std::vector<FloatType, utility::AlignedAllocator<FloatType, alignment>>;
+
+                private:
+
+                    /**
+                     * @brief number of elements per row (num_spins rounded up to the alignment)
+                     */
+                    std::size_t _stride;
+
+                    /**
+                     * @brief owner of the arrays below (heap buffers or a memory-mapped file)
+                     */
+                    std::shared_ptr<const void> _storage;
+
+                    /**
+                     * @brief interactions (num_spins x stride, row-major, symmetric)
+                     */
+                    const FloatType* _J;
+
+                    /**
+                     * @brief local fields
+                     */
+                    const FloatType* _h;
+
+                    /**
+                     * @brief arrays owned by a DenseMatrix built in memory
+                     */
+                    struct Buffers{
+                        Interactions J;
+                        std::vector<FloatType> h;
+                    };
+
+                    /**
+                     * @brief allocate zero-initialized buffers and set pointers
+                     *
+                     * @return buffers to be filled
+                     */
+                    std::shared_ptr<Buffers> allocate(){
+                        auto buffers = std::make_shared<Buffers>();
+                        buffers->J.assign(get_num_spins()*_stride, 0);
+                        buffers->h.assign(get_num_spins(), 0);
+                        _J = buffers->J.data();
+                        _h = buffers->h.data();
+                        _storage = buffers;
+                        return buffers;
+                    }
+
+                public:
+
+                    /**
+                     * @brief DenseMatrix constructor from Dense graph
+                     *
+                     * @param graph Dense graph
+                     */
+                    explicit DenseMatrix(const Dense<FloatType>& graph)
+                        : Graph(graph.get_num_spins()), _stride(calc_stride(graph.get_num_spins())){
+                            const std::size_t num_spins = graph.get_num_spins();
+                            auto buffers = allocate();
+                            auto& J = buffers->J;
+                            auto& h = buffers->h;
+                            for(std::size_t i=0; i<num_spins; i++){
+                                h[i] = graph.h(i);
+                                for(std::size_t j=i+1; j<num_spins; j++){
+                                    J[i*_stride+j] = J[j*_stride+i] = graph.J(i, j);
+                                }
+                            }
+                        }
+
+                    /**
+                     * @brief DenseMatrix constructor from a row-major num_spins x num_spins matrix
+                     *
+                     * Only the upper triangle (i <= j) of the matrix is read; the diagonal is regarded as local fields.
+                     *
+                     * @tparam T element type of the matrix
+                     * @param num_spins the number of spins
+                     * @param matrix pointer to the first element of the contiguous matrix
+                     */
+                    template<typename T>
+                        DenseMatrix(std::size_t num_spins, const T* matrix)
+                        : Graph(num_spins), _stride(calc_stride(num_spins)){
+                            auto buffers = allocate();
+                            auto& J = buffers->J;
+                            auto& h = buffers->h;
+                            for(std::size_t i=0; i<num_spins; i++){
+                                const T* row = matrix + i*num_spins;
+                                h[i] = static_cast<FloatType>(row[i]);
+                                for(std::size_t j=i+1; j<num_spins; j++){
+                                    J[i*_stride+j] = J[j*_stride+i] = static_cast<FloatType>(row[j]);
+                                }
+                            }
+                        }
+
+                    /**
+                     * @brief DenseMatrix constructor viewing external arrays (e.g. a memory-mapped file) without copying
+                     *
+                     * @param num_spins the number of spins
+                     * @param stride number of elements per row (must be equal to the stride calculated for num_spins)
+                     * @param J interactions (num_spins x stride, row-major, symmetric, aligned rows)
+                     * @param h local fields
+                     * @param storage owner of the arrays (kept alive as long as this graph or its copies exist)
+                     */
+                    DenseMatrix(std::size_t num_spins, std::size_t stride, const FloatType* J, const FloatType* h, std::shared_ptr<const void> storage)
+                        : Graph(num_spins), _stride(stride), _storage(std::move(storage)), _J(J), _h(h){
+                            if(stride != calc_stride(num_spins)){
+                                throw std::invalid_argument("DenseMatrix: invalid stride.");
+                            }
+                        }
+
+                    /**
+                     * @brief DenseMatrix copy constructor (the immutable arrays are shared, not copied)
+                     */
+                    DenseMatrix(const DenseMatrix<FloatType>&) = default;
+
+                    /**
+                     * @brief DenseMatrix move constructor
+                     */
+                    DenseMatrix(DenseMatrix<FloatType>&&) = default;
+
+                    /**
+                     * @brief pointer to the first element of a row (aligned, J_{ii} = 0)
+                     *
+                     * @param i Index i
+                     *
+                     * @return pointer to J_{i0}
+                     */
+                    const FloatType* row(Index i) const{
+                        assert(i < get_num_spins());
+                        return _J + i*_stride;
+                    }
+
+                    /**
+                     * @brief number of elements per row including padding
+                     *
+                     * @return stride
+                     */
+                    std::size_t get_stride() const{
+                        return _stride;
+                    }
+
+                    /**
+                     * @brief calculate row stride for the given number of spins
+                     *
+                     * @param num_spins number of spins
+                     *
+                     * @return stride
+                     */
+                    inline static std::size_t calc_stride(std::size_t num_spins){
+                        constexpr std::size_t block = alignment / sizeof(FloatType);
+                        return (num_spins + block - 1) / block * block;
+                    }
+
+                    /**
+                     * @brief local fields (size: num_spins)
+                     *
+                     * @return pointer to the local fields
+                     */
+                    const FloatType* fields() const{
+                        return _h;
+                    }
+
+                    /**
+                     * @brief calculate local field of a spin (h_i + \sum_j J_{ij} s_j)
+                     *
+                     * @param i Index i
+                     * @param spins spin configuration
+                     *
+                     * @return local field
+                     */
+                    FloatType local_field(Index i, const Spins& spins) const{
+                        assert(spins.size() == get_num_spins());
+                        const FloatType* r = row(i);
+                        const Spin* s = spins.data();
+                        FloatType ret = 0;
+                        for(std::size_t j=0, num_spins=get_num_spins(); j<num_spins; j++){
+                            ret += r[j] * s[j];
+                        }
+                        return ret + _h[i];
+                    }
+
+                    /**
+                     * @brief calculate total energy
+                     *
+                     * @param spins
+                     *
+                     * @return corresponding energy
+                     */
+                    FloatType calc_energy(const Spins& spins) const{
+                        assert(spins.size() == get_num_spins());
+                        FloatType ret = 0;
+                        for(std::size_t i=0; i<this->get_num_spins(); i++){
+                            ret += ((1./2) * (local_field(i, spins) - _h[i]) + _h[i]) * spins[i];
+                        }
+                        return ret;
+                    }
+
+                    /**
+                     * @brief access J_{ij}
+                     *
+                     * @param i Index i
+                     * @param j Index j
+                     *
+                     * @return J_{ij} (h_{i} if i == j)
+                     */
+                    const FloatType& J(Index i, Index j) const{
+                        assert(i < get_num_spins());
+                        assert(j < get_num_spins());
+                        return (i == j) ? _h[i] : _J[i*_stride+j];
+                    }
+
+                    /**
+                     * @brief access h_{i} (local field)
+                     *
+                     * @param i Index i
+                     *
+                     * @return h_{i}
+                     */
+                    const FloatType& h(Index i) const{
+                        assert(i < get_num_spins());
+                        return _h[i];
+                    }
+            };
+    } // namespace graph
+} // namespace openjij
+
+#endif
@@ -0,0 +1,455 @@
+//    Copyright 2019 Jij Inc.
+
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+
+//        http://www.apache.org/licenses/LICENSE-2.0
+
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+
+#ifndef OPENJIJ_GRAPH_KING_GRAPH_HPP__
+#define OPENJIJ_GRAPH_KING_GRAPH_HPP__
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <graph/sparse.hpp>
+#include <graph/square.hpp>
+
+namespace openjij {
+    namespace graph {
+
+        /**
+         * @brief direction in King's graph
+         */
+        enum class KingDir{
+
+            /**
+             * @brief plus-row direction: (r, c) -> (r+1, c)
+             */
+            PLUS_R,
+
+            /**
+             * @brief minus-row direction: (r, c) -> (r-1, c)
+             */
+            MINUS_R,
+
+            /**
+             * @brief plus-column direction: (r, c) -> (r, c+1)
+             */
+            PLUS_C,
+
+            /**
+             * @brief minus-column direction: (r, c) -> (r, c-1)
+             */
+            MINUS_C,
+
+            /**
+             * @brief plus-row plus-column direction: (r, c) -> (r+1, c+1)
+             */
+            PLUS_R_PLUS_C,
+
+            /**
+             * @brief plus-row minus-column direction: (r, c) -> (r+1, c-1)
+             */
+            PLUS_R_MINUS_C,
+
+            /**
+             * @brief minus-row plus-column direction: (r, c) -> (r-1, c+1)
+             */
+            MINUS_R_PLUS_C,
+
+            /**
+             * @brief minus-row minus-column direction: (r, c) -> (r-1, c-1)
+             */
+            MINUS_R_MINUS_C,
+        };
+
+        /**
+         * @brief King's graph (square lattice with diagonal bonds, open boundary)
+         *
+         * Global index of (r, c) is r*num_column + c, which agrees with openjij.model.KingGraph (r = y, c = x).
+         *
+         * @tparam FloatType floating-point type
+         */
+        template<typename FloatType>
+        class KingGraph : public Sparse<FloatType>{
+            static_assert( std::is_floating_point<FloatType>::value, "argument must be an arithmetic type" );
+            private:
+
+                /**
+                 * @brief initial value to be set to interactions
+                 */
+                FloatType _init_val;
+
+                /**
+                 * @brief number of rows
+                 */
+                std::size_t _num_row;
+
+                /**
+                 * @brief number of columns
+                 */
+                std::size_t _num_column;
+
+                /**
+                 * @brief row and column offsets of a direction
+                 *
+                 * @param dir direction
+                 *
+                 * @return (row offset, column offset)
+                 */
+                static std::pair<std::int64_t, std::int64_t> offset(KingDir dir){
+                    switch (dir) {
+                        case KingDir::PLUS_R:          return std::make_pair( 1,  0);
+                        case KingDir::MINUS_R:         return std::make_pair(-1,  0);
+                        case KingDir::PLUS_C:          return std::make_pair( 0,  1);
+                        case KingDir::MINUS_C:         return std::make_pair( 0, -1);
+                        case KingDir::PLUS_R_PLUS_C:   return std::make_pair( 1,  1);
+                        case KingDir::PLUS_R_MINUS_C:  return std::make_pair( 1, -1);
+                        case KingDir::MINUS_R_PLUS_C:  return std::make_pair(-1,  1);
+                        case KingDir::MINUS_R_MINUS_C: return std::make_pair(-1, -1);
+                        default:
+                            assert(false);
+                            return std::make_pair(0, 0);
+                    }
+                }
+
+                /**
+                 * @brief global index of the neighbor in the direction (the bond must exist)
+                 */
+                Index neighbor(std::size_t r, std::size_t c, KingDir dir) const{
+                    const auto d = offset(dir);
+                    const std::int64_t nr = static_cast<std::int64_t>(r) + d.first;
+                    const std::int64_t nc = static_cast<std::int64_t>(c) + d.second;
+                    assert(0 <= nr && nr < static_cast<std::int64_t>(_num_row));
+                    assert(0 <= nc && nc < static_cast<std::int64_t>(_num_column));
+                    return to_ind(nr, nc);
+                }
+
+            public:
+
+                /**
+                 * @brief convert from (row x column) index to global index
+                 *
+                 * @param r row index
+                 * @param c column index
+                 *
+                 * @return corresponding global index
+                 */
+                Index to_ind(std::size_t r, std::size_t c) const{
+                    assert(r < _num_row);
+                    assert(c < _num_column);
+
+                    return _num_column * r + c;
+                }
+
+                /**
+                 * @brief convert from global index to (row x column) index
+                 *
+                 * @param ind global index
+                 *
+                 * @return corresponding (row x column) index (RowColumn type)
+                 */
+                RowColumn to_rc(Index ind) const{
+                    assert(ind < this->get_num_spins());
+                    return std::make_pair(ind/_num_column, ind%_num_column);
+                }
+
+                /**
+                 * @brief King's graph constructor
+                 *
+                 * @param num_row number of rows
+                 * @param num_column number of columns
+                 * @param init_val initial value set to interaction (default: 0)
+                 */
+                KingGraph(std::size_t num_row, std::size_t num_column, FloatType init_val=0)
+                    : Sparse<FloatType>(num_row*num_column, 8+1), _init_val(init_val), _num_row(num_row), _num_column(num_column){
+                        assert(num_row >= 1);
+                        assert(num_column >= 1);
+
+                        for(std::size_t r=0; r<_num_row; r++){
+                            for(std::size_t c=0; c<_num_column; c++){
+                                //open boundary (each bond is set from both ends, which is harmless)
+                                for(std::int64_t dr=-1; dr<=1; dr++){
+                                    for(std::int64_t dc=-1; dc<=1; dc++){
+                                        const std::int64_t nr = static_cast<std::int64_t>(r) + dr;
+                                        const std::int64_t nc = static_cast<std::int64_t>(c) + dc;
+                                        if(nr < 0 || nr >= static_cast<std::int64_t>(_num_row)) continue;
+                                        if(nc < 0 || nc >= static_cast<std::int64_t>(_num_column)) continue;
+                                        //(dr, dc) = (0, 0) is the local field
+                                        this->Sparse<FloatType>::J(to_ind(r,c), to_ind(nr,nc)) = _init_val;
+                                    }
+                                }
+                            }
+                        }
+                    }
+
+                /**
+                 * @brief King's graph copy constructor
+                 *
+                 */
+                KingGraph(const KingGraph<FloatType>&) = default;
+
+                /**
+                 * @brief King's graph move constructor
+                 *
+                 */
+                KingGraph(KingGraph<FloatType>&&) = default;
+
+                /**
+                 * @brief get number of rows
+                 *
+                 * @return number of rows
+                 */
+                std::size_t get_num_row() const{return _num_row;}
+
+                /**
+                 * @brief get number of columns
+                 *
+                 * @return number of columns
+                 */
+                std::size_t get_num_column() const{return _num_column;}
+
+                /**
+                 * @brief access J_{ij} and h_{i} by global indices (as in Sparse)
+                 */
+                using Sparse<FloatType>::J;
+                using Sparse<FloatType>::h;
+
+                /**
+                 * @brief access J(row, colum, direction)
+                 *
+                 * @param r row index
+                 * @param c column index
+                 * @param dir direction
+                 *
+                 * @return corresponding interaction value
+                 */
+                FloatType& J(std::size_t r, std::size_t c, KingDir dir){
+                    return this->Sparse<FloatType>::J(to_ind(r,c), neighbor(r,c,dir));
+                }
+
+                /**
+                 * @brief access J(row, colum, direction)
+                 *
+                 * @param r row index
+                 * @param c column index
+                 * @param dir direction
+                 *
+                 * @return corresponding interaction value
+                 */
+                const FloatType& J(std::size_t r, std::size_t c, KingDir dir) const{
+                    return this->Sparse<FloatType>::J(to_ind(r,c), neighbor(r,c,dir));
+                }
+
+                /**
+                 * @brief access h(row, colum) (local field)
+                 *
+                 * @param r row index
+                 * @param c column index
+                 *
+                 * @return corresponding interaction value
+                 */
+                FloatType& h(std::size_t r, std::size_t c){
+                    return this->Sparse<FloatType>::h(to_ind(r,c));
+                }
+
+                /**
+                 * @brief access h(row, colum) (local field)
+                 *
+                 * @param r row index
+                 * @param c column index
+                 *
+                 * @return corresponding interaction value
+                 */
+                const FloatType& h(std::size_t r, std::size_t c) const{
+                    return this->Sparse<FloatType>::h(to_ind(r,c));
+                }
+
+                /**
+                 * @brief derive spin value at the index (row x column)
+                 *
+                 * @param spins spin array
+                 * @param r row index
+                 * @param c column index
+                 *
+                 * @return corresponding spin
+                 */
+                Spin& spin(Spins& spins, std::size_t r, std::size_t c) const{
+                    return spins[to_ind(r, c)];
+                }
+
+                /**
+                 * @brief derive spin value at the index (row x column)
+                 *
+                 * @param spins spin array
+                 * @param r row index
+                 * @param c column index
+                 *
+                 * @return corresponding spin
+                 */
+                const Spin& spin(const Spins& spins, std::size_t r, std::size_t c) const{
+                    return spins[to_ind(r, c)];
+                }
+        };
+
+        /**
+         * @brief couplings of a King's graph stored in one array per direction (row-major, indexed by global index)
+         *
+         * A coupling is zero if the bond crosses the open boundary, so that a neighbor outside of the lattice
+         * can be replaced by any in-range spin (the site itself is used below) without changing the local field.
+         *
+         * @tparam FloatType floating-point type
+         */
+        template<typename FloatType>
+        struct KingCouplings{
+            using value_type = FloatType;
+
+            std::vector<FloatType> J_minus_r;
+            std::vector<FloatType> J_plus_r;
+            std::vector<FloatType> J_minus_c;
+            std::vector<FloatType> J_plus_c;
+            std::vector<FloatType> J_minus_r_minus_c;
+            std::vector<FloatType> J_minus_r_plus_c;
+            std::vector<FloatType> J_plus_r_minus_c;
+            std::vector<FloatType> J_plus_r_plus_c;
+            std::vector<FloatType> h;
+
+            /**
+             * @brief number of rows
+             */
+            std::size_t num_row;
+
+            /**
+             * @brief number of columns
+             */
+            std::size_t num_column;
+
+            /**
+             * @brief KingCouplings constructor
+             *
+             * @param graph King's graph
+             */
+            explicit KingCouplings(const KingGraph<FloatType>& graph)
+                : J_minus_r(graph.get_num_spins(), 0), J_plus_r(graph.get_num_spins(), 0),
+                J_minus_c(graph.get_num_spins(), 0), J_plus_c(graph.get_num_spins(), 0),
+                J_minus_r_minus_c(graph.get_num_spins(), 0), J_minus_r_plus_c(graph.get_num_spins(), 0),
+                J_plus_r_minus_c(graph.get_num_spins(), 0), J_plus_r_plus_c(graph.get_num_spins(), 0),
+                h(graph.get_num_spins(), 0),
+                num_row(graph.get_num_row()), num_column(graph.get_num_column()){
+
+                    for(std::size_t r=0; r<num_row; r++){
+                        const bool has_mr = (r > 0);
+                        const bool has_pr = (r+1 < num_row);
+                        for(std::size_t c=0; c<num_column; c++){
+                            const bool has_mc = (c > 0);
+                            const bool has_pc = (c+1 < num_column);
+                            const Index ind = r*num_column + c;
+                            if(has_mr)           J_minus_r[ind]         = graph.J(r, c, KingDir::MINUS_R);
+                            if(has_pr)           J_plus_r[ind]          = graph.J(r, c, KingDir::PLUS_R);
+                            if(has_mc)           J_minus_c[ind]         = graph.J(r, c, KingDir::MINUS_C);
+                            if(has_pc)           J_plus_c[ind]          = graph.J(r, c, KingDir::PLUS_C);
+                            if(has_mr && has_mc) J_minus_r_minus_c[ind] = graph.J(r, c, KingDir::MINUS_R_MINUS_C);
+                            if(has_mr && has_pc) J_minus_r_plus_c[ind]  = graph.J(r, c, KingDir::MINUS_R_PLUS_C);
+                            if(has_pr && has_mc) J_plus_r_minus_c[ind]  = graph.J(r, c, KingDir::PLUS_R_MINUS_C);
+                            if(has_pr && has_pc) J_plus_r_plus_c[ind]   = graph.J(r, c, KingDir::PLUS_R_PLUS_C);
+                            h[ind] = graph.h(ind);
+                        }
+                    }
+                }
+
+            /**
+             * @brief calculate local fields (h_i + \sum_j J_{ij} s_j) of the sites (r, c_begin), (r, c_begin+2), ... in a row
+             *
+             * The sites are mutually non-adjacent, and the interior ones are computed in a branch-free loop
+             * over contiguous arrays that the compiler can vectorize.
+             *
+             * @param r row index
+             * @param c_begin first column (0 or 1)
+             * @param spins spin configuration
+             * @param out output (out[k] is the local field of (r, c_begin+2k))
+             */
+            void row_local_fields(std::size_t r, std::size_t c_begin, const Spins& spins, FloatType* out) const{
+                assert(spins.size() == num_row*num_column);
+                const std::size_t base = r*num_column;
+                const Spin* row = spins.data() + base;
+                //rows outside of the lattice are replaced by the row itself (their couplings are zero)
+                const Spin* row_m = (r > 0) ? row - num_column : row;
+                const Spin* row_p = (r+1 < num_row) ? row + num_column : row;
+
+                std::size_t c = c_begin;
+                std::size_t k = 0;
+                if(c == 0){
+                    out[k++] = local_field(r, c, spins);
+                    c += 2;
+                }
+                //interior columns: both column neighbors exist
+                const FloatType* hr    = h.data() + base;
+                const FloatType* jmr   = J_minus_r.data() + base;
+                const FloatType* jpr   = J_plus_r.data() + base;
+                const FloatType* jmc   = J_minus_c.data() + base;
+                const FloatType* jpc   = J_plus_c.data() + base;
+                const FloatType* jmrmc = J_minus_r_minus_c.data() + base;
+                const FloatType* jmrpc = J_minus_r_plus_c.data() + base;
+                const FloatType* jprmc = J_plus_r_minus_c.data() + base;
+                const FloatType* jprpc = J_plus_r_plus_c.data() + base;
+                for(; c+1 < num_column; c += 2, ++k){
+                    out[k] = hr[c]
+                        + jmr[c]   * row_m[c]
+                        + jpr[c]   * row_p[c]
+                        + jmc[c]   * row[c-1]
+                        + jpc[c]   * row[c+1]
+                        + jmrmc[c] * row_m[c-1]
+                        + jmrpc[c] * row_m[c+1]
+                        + jprmc[c] * row_p[c-1]
+                        + jprpc[c] * row_p[c+1];
+                }
+                if(c < num_column){
+                    out[k] = local_field(r, c, spins);
+                }
+            }
+
+            /**
+             * @brief calculate local field of a spin (h_i + \sum_j J_{ij} s_j) with the nine-point stencil
+             *
+             * @param r row index
+             * @param c column index
+             * @param spins spin configuration
+             *
+             * @return local field
+             */
+            FloatType local_field(std::size_t r, std::size_t c, const Spins& spins) const{
+                assert(spins.size() == num_row*num_column);
+                const Spin* row = spins.data() + r*num_column;
+                //neighbors outside of the lattice are replaced by the site itself (their couplings are zero)
+                const Spin* row_m = (r > 0) ? row - num_column : row;
+                const Spin* row_p = (r+1 < num_row) ? row + num_column : row;
+                const std::size_t cm = (c > 0) ? c-1 : c;
+                const std::size_t cp = (c+1 < num_column) ? c+1 : c;
+                const Index ind = r*num_column + c;
+                return h[ind]
+                    + J_minus_r[ind]         * row_m[c]
+                    + J_plus_r[ind]          * row_p[c]
+                    + J_minus_c[ind]         * row[cm]
+                    + J_plus_c[ind]          * row[cp]
+                    + J_minus_r_minus_c[ind] * row_m[cm]
+                    + J_minus_r_plus_c[ind]  * row_m[cp]
+                    + J_plus_r_minus_c[ind]  * row_p[cm]
+                    + J_plus_r_plus_c[ind]   * row_p[cp];
+            }
+        };
+
+    } // namespace graph
+} // namespace openjij
+
+#endif
@@ -0,0 +1,478 @@
+//    Copyright 2019 Jij Inc.
+
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+
+//        http://www.apache.org/licenses/LICENSE-2.0
+
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+
+#ifndef OPENJIJ_GRAPH_LATTICE_HPP__
+#define OPENJIJ_GRAPH_LATTICE_HPP__
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include <graph/graph.hpp>
+
+namespace openjij {
+    namespace graph {
+
+        /**
+         * @brief displacement to a neighbor in a lattice (one component per dimension)
+         *
+         * @tparam Ds components of the displacement
+         */
+        template<std::int64_t... Ds>
+        struct Offset{
+            /**
+             * @brief number of dimensions
+             */
+            static constexpr std::size_t dims = sizeof...(Ds);
+
+            /**
+             * @brief components of the displacement
+             */
+            static std::array<std::int64_t, sizeof...(Ds)> value(){
+                return {{Ds...}};
+            }
+        };
+
+        /**
+         * @brief periodic hypercubic lattice whose stencil is fixed at compile time
+         *
+         * Each bond is stored once, at the site it starts from: Offsets is the forward half of the stencil,
+         * and the backward neighbors are obtained by negating the offsets (the offsets must be distinct and
+         * must not contain a pair x, -x). Couplings are stored in one array per offset, so that local fields
+         * are computed by a loop of constant length over contiguous arrays.
+         * The global index is row-major (the last dimension is contiguous).
+         * Diluted lattices are represented by zero couplings.
+         *
+         * @tparam FloatType floating-point type
+         * @tparam Dims number of dimensions
+         * @tparam Offsets forward neighbor offsets (Offset<...> with Dims components)
+         */
+        template<typename FloatType, std::size_t Dims, typename... Offsets>
+        class Lattice : public Graph{
+            static_assert(std::is_floating_point<FloatType>::value, "FloatType must be floating-point type.");
+            static_assert(Dims >= 1, "Dims must be positive.");
+            static_assert(sizeof...(Offsets) >= 1, "at least one offset is required.");
+
+            public:
+
+                using value_type = FloatType;
+
+                /**
+                 * @brief coordinate of a site
+                 */
+                using Coordinate = std::array<std::size_t, Dims>;
+
+                /**
+                 * @brief number of forward offsets (a site has twice as many neighbors)
+                 */
+                static constexpr std::size_t num_offsets = sizeof...(Offsets);
+
+            private:
+
+                using OffsetTable = std::array<std::array<std::int64_t, Dims>, num_offsets>;
+
+                /**
+                 * @brief number of sites in each dimension
+                 */
+                Coordinate _shape;
+
+                /**
+                 * @brief stride of each dimension in the global index
+                 */
+                Coordinate _stride;
+
+                /**
+                 * @brief offsets as an array
+                 */
+                OffsetTable _offsets;
+
+                /**
+                 * @brief largest |offset| in each dimension
+                 */
+                Coordinate _margin;
+
+                /**
+                 * @brief displacement of the global index for each offset (valid away from the boundary)
+                 */
+                std::array<std::int64_t, num_offsets> _delta;
+
+                /**
+                 * @brief couplings (_J[k][i] is the bond between i and its forward neighbor k)
+                 */
+                std::array<std::vector<FloatType>, num_offsets> _J;
+
+                /**
+                 * @brief local fields
+                 */
+                std::vector<FloatType> _h;
+
+                static std::size_t product(const Coordinate& shape){
+                    std::size_t ret = 1;
+                    for(auto&& l : shape) ret *= l;
+                    return ret;
+                }
+
+                static OffsetTable offset_table(){
+                    static_assert(all_dims<Offsets...>::value, "each offset must have Dims components.");
+                    return {{Offsets::value()...}};
+                }
+
+                template<typename... Os>
+                struct all_dims : std::true_type{};
+
+                template<typename O, typename... Os>
+                struct all_dims<O, Os...> : std::integral_constant<bool, O::dims == Dims && all_dims<Os...>::value>{};
+
+                /**
+                 * @brief coordinate x + sign*offset (periodic)
+                 */
+                std::size_t shifted(std::size_t x, std::size_t d, std::int64_t o) const{
+                    const std::int64_t l = static_cast<std::int64_t>(_shape[d]);
+                    const std::int64_t y = static_cast<std::int64_t>(x) + o;
+                    return static_cast<std::size_t>(y < 0 ? y + l : (y >= l ? y - l : y));
+                }
+
+                /**
+                 * @brief neighbor of a site in the direction sign*offset k (periodic)
+                 */
+                Index neighbor(const Coordinate& x, std::size_t k, std::int64_t sign) const{
+                    Index ret = 0;
+                    for(std::size_t d=0; d<Dims; d++){
+                        ret += shifted(x[d], d, sign*_offsets[k][d]) * _stride[d];
+                    }
+                    return ret;
+                }
+
+            public:
+
+                /**
+                 * @brief Lattice constructor
+                 *
+                 * @param shape number of sites in each dimension (must exceed twice the largest offset in that dimension)
+                 * @param init_val initial value set to couplings and local fields (default: 0)
+                 */
+                explicit Lattice(const Coordinate& shape, FloatType init_val=0)
+                    : Graph(product(shape)), _shape(shape), _offsets(offset_table()){
+                        for(std::size_t d=0; d<Dims; d++){
+                            _margin[d] = 0;
+                            for(std::size_t k=0; k<num_offsets; k++){
+                                _margin[d] = std::max<std::size_t>(_margin[d], std::abs(_offsets[k][d]));
+                            }
+                            if(_shape[d] <= 2*_margin[d]){
+                                throw std::invalid_argument("Lattice: each side must be longer than twice the largest offset.");
+                            }
+                        }
+                        _stride[Dims-1] = 1;
+                        for(std::size_t d=Dims-1; d>0; d--){
+                            _stride[d-1] = _stride[d] * _shape[d];
+                        }
+                        for(std::size_t k=0; k<num_offsets; k++){
+                            _delta[k] = 0;
+                            for(std::size_t d=0; d<Dims; d++){
+                                _delta[k] += _offsets[k][d] * static_cast<std::int64_t>(_stride[d]);
+                            }
+                            _J[k].assign(get_num_spins(), init_val);
+                        }
+                        _h.assign(get_num_spins(), init_val);
+                    }
+
+                /**
+                 * @brief Lattice copy constructor
+                 */
+                Lattice(const Lattice&) = default;
+
+                /**
+                 * @brief Lattice move constructor
+                 */
+                Lattice(Lattice&&) = default;
+
+                /**
+                 * @brief get number of sites in each dimension
+                 *
+                 * @return shape
+                 */
+                const Coordinate& get_shape() const{
+                    return _shape;
+                }
+
+                /**
+                 * @brief get largest |offset| in each dimension
+                 *
+                 * @return margin (sites closer to the boundary than this have wrapped neighbors)
+                 */
+                const Coordinate& get_margin() const{
+                    return _margin;
+                }
+
+                /**
+                 * @brief convert from coordinate to global index
+                 *
+                 * @param x coordinate
+                 *
+                 * @return global index
+                 */
+                Index to_ind(const Coordinate& x) const{
+                    Index ret = 0;
+                    for(std::size_t d=0; d<Dims; d++){
+                        assert(x[d] < _shape[d]);
+                        ret += x[d] * _stride[d];
+                    }
+                    return ret;
+                }
+
+                /**
+                 * @brief convert from global index to coordinate
+                 *
+                 * @param ind global index
+                 *
+                 * @return coordinate
+                 */
+                Coordinate to_coord(Index ind) const{
+                    assert(ind < get_num_spins());
+                    Coordinate ret;
+                    for(std::size_t d=0; d<Dims; d++){
+                        ret[d] = ind / _stride[d];
+                        ind %= _stride[d];
+                    }
+                    return ret;
+                }
+
+                /**
+                 * @brief forward neighbor of a site (periodic)
+                 *
+                 * @param ind global index
+                 * @param k offset number
+                 *
+                 * @return global index of the neighbor
+                 */
+                Index forward(Index ind, std::size_t k) const{
+                    assert(k < num_offsets);
+                    return neighbor(to_coord(ind), k, 1);
+                }
+
+                /**
+                 * @brief backward neighbor of a site (periodic)
+                 *
+                 * @param ind global index
+                 * @param k offset number
+                 *
+                 * @return global index of the neighbor
+                 */
+                Index backward(Index ind, std::size_t k) const{
+                    assert(k < num_offsets);
+                    return neighbor(to_coord(ind), k, -1);
+                }
+
+                /**
+                 * @brief access the bond between a site and its forward neighbor k
+                 *
+                 * @param x coordinate
+                 * @param k offset number
+                 *
+                 * @return corresponding interaction value
+                 */
+                FloatType& J(const Coordinate& x, std::size_t k){
+                    assert(k < num_offsets);
+                    return _J[k][to_ind(x)];
+                }
+
+                /**
+                 * @brief access the bond between a site and its forward neighbor k
+                 *
+                 * @param x coordinate
+                 * @param k offset number
+                 *
+                 * @return corresponding interaction value
+                 */
+                const FloatType& J(const Coordinate& x, std::size_t k) const{
+                    assert(k < num_offsets);
+                    return _J[k][to_ind(x)];
+                }
+
+                /**
+                 * @brief access h(coordinate) (local field)
+                 *
+                 * @param x coordinate
+                 *
+                 * @return corresponding local field
+                 */
+                FloatType& h(const Coordinate& x){
+                    return _h[to_ind(x)];
+                }
+
+                /**
+                 * @brief access h(coordinate) (local field)
+                 *
+                 * @param x coordinate
+                 *
+                 * @return corresponding local field
+                 */
+                const FloatType& h(const Coordinate& x) const{
+                    return _h[to_ind(x)];
+                }
+
+                /**
+                 * @brief get J_{ij} by global indices (zero if i and j are not adjacent, h_i if i == j)
+                 *
+                 * @param i global index
+                 * @param j global index
+                 *
+                 * @return corresponding interaction value
+                 */
+                FloatType J(Index i, Index j) const{
+                    if(i == j) return _h[i];
+                    const Coordinate xi = to_coord(i);
+                    const Coordinate xj = to_coord(j);
+                    for(std::size_t k=0; k<num_offsets; k++){
+                        if(neighbor(xi, k, 1) == j) return _J[k][i];
+                        if(neighbor(xj, k, 1) == i) return _J[k][j];
+                    }
+                    return 0;
+                }
+
+                /**
+                 * @brief access h_i (local field)
+                 *
+                 * @param ind global index
+                 *
+                 * @return corresponding local field
+                 */
+                FloatType& h(Index ind){
+                    return _h[ind];
+                }
+
+                /**
+                 * @brief access h_i (local field)
+                 *
+                 * @param ind global index
+                 *
+                 * @return corresponding local field
+                 */
+                const FloatType& h(Index ind) const{
+                    return _h[ind];
+                }
+
+                /**
+                 * @brief list of adjacent nodes (the site itself first, as it carries the local field)
+                 *
+                 * @param ind global index
+                 *
+                 * @return adjacent nodes
+                 */
+                Nodes adj_nodes(Index ind) const{
+                    const Coordinate x = to_coord(ind);
+                    Nodes ret;
+                    ret.reserve(2*num_offsets+1);
+                    ret.push_back(ind);
+                    for(std::size_t k=0; k<num_offsets; k++){
+                        ret.push_back(neighbor(x, k, 1));
+                        ret.push_back(neighbor(x, k, -1));
+                    }
+                    return ret;
+                }
+
+                /**
+                 * @brief calculate local field of a spin (h_i + \sum_j J_{ij} s_j), wrapping around the boundary
+                 *
+                 * @param x coordinate
+                 * @param spins spin configuration
+                 *
+                 * @return local field
+                 */
+                FloatType local_field(const Coordinate& x, const Spins& spins) const{
+                    assert(spins.size() == get_num_spins());
+                    const Index ind = to_ind(x);
+                    FloatType ret = _h[ind];
+                    for(std::size_t k=0; k<num_offsets; k++){
+                        const Index b = neighbor(x, k, -1);
+                        ret += _J[k][ind] * spins[neighbor(x, k, 1)] + _J[k][b] * spins[b];
+                    }
+                    return ret;
+                }
+
+                /**
+                 * @brief calculate local field of a spin away from the boundary (no wrapping)
+                 *
+                 * The site must be at least get_margin() away from the boundary in every dimension.
+                 * The loop has a constant trip count and no branches.
+                 *
+                 * @param ind global index
+                 * @param spins spin configuration
+                 *
+                 * @return local field
+                 */
+                FloatType interior_local_field(Index ind, const Spins& spins) const{
+                    assert(spins.size() == get_num_spins());
+                    FloatType ret = _h[ind];
+                    for(std::size_t k=0; k<num_offsets; k++){
+                        const Index f = ind + _delta[k];
+                        const Index b = ind - _delta[k];
+                        ret += _J[k][ind] * spins[f] + _J[k][b] * spins[b];
+                    }
+                    return ret;
+                }
+
+                /**
+                 * @brief calculate total energy
+                 *
+                 * @param spins spin configuration
+                 *
+                 * @return total energy
+                 */
+                FloatType calc_energy(const Spins& spins) const{
+                    assert(spins.size() == get_num_spins());
+                    FloatType ret = 0;
+                    Coordinate x = {};
+                    for(Index ind=0; ind<get_num_spins(); ind++){
+                        FloatType local = _h[ind];
+                        for(std::size_t k=0; k<num_offsets; k++){
+                            local += _J[k][ind] * spins[neighbor(x, k, 1)];
+                        }
+                        ret += local * spins[ind];
+                        //next coordinate (row-major)
+                        for(std::size_t d=Dims; d-- > 0;){
+                            if(++x[d] < _shape[d]) break;
+                            x[d] = 0;
+                        }
+                    }
+                    return ret;
+                }
+        };
+
+        /**
+         * @brief periodic square lattice
+         *
+         * @tparam FloatType floating-point type
+         */
+        template<typename FloatType>
+        using SquareLattice = Lattice<FloatType, 2, Offset<1, 0>, Offset<0, 1>>;
+
+        /**
+         * @brief periodic simple cubic lattice
+         *
+         * @tparam FloatType floating-point type
+         */
+        template<typename FloatType>
+        using CubicLattice = Lattice<FloatType, 3, Offset<1, 0, 0>, Offset<0, 1, 0>, Offset<0, 0, 1>>;
+
+    } // namespace graph
+} // namespace openjij
+
+#endif
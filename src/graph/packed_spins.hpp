@@ -0,0 +1,161 @@
+//    Copyright 2019 Jij Inc.
+
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+
+//        http://www.apache.org/licenses/LICENSE-2.0
+
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+
+#ifndef OPENJIJ_GRAPH_PACKED_SPINS_HPP__
+#define OPENJIJ_GRAPH_PACKED_SPINS_HPP__
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <graph/graph.hpp>
+
+namespace openjij {
+    namespace graph {
+
+        /**
+         * @brief spins packed into 64-bit words (1 bit per spin, set bit: +1, cleared bit: -1)
+         *
+         * Unused bits of the last word are always zero.
+         */
+        class PackedSpins{
+            public:
+
+                using Word = std::uint64_t;
+
+                /**
+                 * @brief number of spins in a word
+                 */
+                static constexpr std::size_t bits_per_word = 64;
+
+            private:
+
+                /**
+                 * @brief number of spins
+                 */
+                std::size_t _num_spins;
+
+                /**
+                 * @brief packed spins
+                 */
+                std::vector<Word> _words;
+
+                static std::size_t num_words(std::size_t num_spins){
+                    return (num_spins + bits_per_word - 1) / bits_per_word;
+                }
+
+            public:
+
+                /**
+                 * @brief PackedSpins constructor (all spins are -1)
+                 *
+                 * @param num_spins number of spins
+                 */
+                explicit PackedSpins(std::size_t num_spins = 0)
+                    : _num_spins(num_spins), _words(num_words(num_spins), 0){}
+
+                /**
+                 * @brief PackedSpins constructor
+                 *
+                 * @param spins spins (-1/+1)
+                 */
+                explicit PackedSpins(const Spins& spins)
+                    : PackedSpins(spins.size()){
+                        for(std::size_t i=0; i<spins.size(); i++){
+                            assert(spins[i] == 1 || spins[i] == -1);
+                            if(spins[i] > 0) _words[i / bits_per_word] |= Word(1) << (i % bits_per_word);
+                        }
+                    }
+
+                /**
+                 * @brief get the spin
+                 *
+                 * @param i index
+                 *
+                 * @return spin (-1/+1)
+                 */
+                Spin get(Index i) const{
+                    assert(i < _num_spins);
+                    return 2 * static_cast<Spin>((_words[i / bits_per_word] >> (i % bits_per_word)) & 1) - 1;
+                }
+
+                /**
+                 * @brief set the spin
+                 *
+                 * @param i index
+                 * @param spin spin (-1/+1)
+                 */
+                void set(Index i, Spin spin){
+                    assert(i < _num_spins);
+                    assert(spin == 1 || spin == -1);
+                    const Word mask = Word(1) << (i % bits_per_word);
+                    if(spin > 0) _words[i / bits_per_word] |= mask;
+                    else _words[i / bits_per_word] &= ~mask;
+                }
+
+                /**
+                 * @brief flip the spin
+                 *
+                 * @param i index
+                 */
+                void flip(Index i){
+                    assert(i < _num_spins);
+                    _words[i / bits_per_word] ^= Word(1) << (i % bits_per_word);
+                }
+
+                /**
+                 * @brief get the number of spins
+                 *
+                 * @return number of spins
+                 */
+                std::size_t size() const{
+                    return _num_spins;
+                }
+
+                /**
+                 * @brief get the packed words
+                 *
+                 * @return words (size: ceil(size()/64))
+                 */
+                const std::vector<Word>& words() const{
+                    return _words;
+                }
+
+                /**
+                 * @brief unpack the spins
+                 *
+                 * @return spins (-1/+1)
+                 */
+                Spins to_spins() const{
+                    Spins ret(_num_spins);
+                    for(std::size_t i=0; i<_num_spins; i++){
+                        ret[i] = get(i);
+                    }
+                    return ret;
+                }
+
+                bool operator==(const PackedSpins& other) const{
+                    return _num_spins == other._num_spins && _words == other._words;
+                }
+
+                bool operator!=(const PackedSpins& other) const{
+                    return !(*this == other);
+                }
+        };
+
+    } // namespace graph
+} // namespace openjij
+
+#endif
@@ -0,0 +1,384 @@
+//    Copyright 2019 Jij Inc.
+
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+
+//        http://www.apache.org/licenses/LICENSE-2.0
+
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+
+#ifndef OPENJIJ_GRAPH_PARSER_HPP__
+#define OPENJIJ_GRAPH_PARSER_HPP__
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <graph/graph.hpp>
+#include <graph/sparse.hpp>
+
+namespace openjij {
+    namespace graph {
+
+        /**
+         * @brief text formats supported by the parser
+         */
+        enum class TextFormat{
+            /**
+             * @brief one interaction per line: "i j value" (0-origin, i == j denotes a local field)
+             */
+            EdgeList,
+
+            /**
+             * @brief Gset: header "num_spins num_edges" followed by "i j value" lines (1-origin)
+             */
+            Gset,
+        };
+
+        /**
+         * @brief exception thrown by the parser (with position of the error)
+         */
+        class ParseError : public std::runtime_error{
+            private:
+                std::size_t _line;
+                std::size_t _column;
+            public:
+                /**
+                 * @brief ParseError constructor
+                 *
+                 * @param message error message
+                 * @param line line number (1-origin)
+                 * @param column column number (1-origin)
+                 */
+                ParseError(const std::string& message, std::size_t line, std::size_t column)
+                    : std::runtime_error("line " + std::to_string(line) + ", column " + std::to_string(column) + ": " + message),
+                    _line(line), _column(column){}
+
+                /**
+                 * @brief line number of the error (1-origin)
+                 */
+                std::size_t line() const{ return _line; }
+
+                /**
+                 * @brief column number of the error (1-origin)
+                 */
+                std::size_t column() const{ return _column; }
+        };
+
+        namespace parser_impl{
+
+            /**
+             * @brief COO arrays and status produced by a parser thread
+             */
+            struct Chunk{
+                std::vector<std::int64_t> rows;
+                std::vector<std::int64_t> cols;
+                std::vector<double> values;
+                std::int64_t max_index = -1;
+                std::size_t num_lines = 0;
+                bool failed = false;
+                std::size_t error_line = 0;   //local to the chunk (1-origin)
+                std::size_t error_column = 0;
+                std::string error_message;
+            };
+
+            inline bool is_blank(char c){
+                return c == ' ' || c == '\t' || c == '\r';
+            }
+
+            /**
+             * @brief line tokenizer (never reads beyond the end of the line)
+             */
+            class LineReader{
+                private:
+                    const char* _begin;
+                    const char* _pos;
+                    const char* _end;
+                public:
+                    LineReader(const char* begin, const char* end) : _begin(begin), _pos(begin), _end(end){}
+
+                    std::size_t column() const{ return static_cast<std::size_t>(_pos - _begin) + 1; }
+
+                    //skip blanks and return true if a token follows
+                    bool has_token(){
+                        while(_pos != _end && is_blank(*_pos)) ++_pos;
+                        return _pos != _end;
+                    }
+
+                    bool read_index(std::int64_t& value){
+                        if(!has_token()) return false;
+                        const char* p = _pos;
+                        bool negative = false;
+                        if(*p == '-' || *p == '+'){ negative = (*p == '-'); ++p; }
+                        if(p == _end || *p < '0' || *p > '9') return false;
+                        std::int64_t v = 0;
+                        while(p != _end && *p >= '0' && *p <= '9'){
+                            v = v*10 + (*p - '0');
+                            ++p;
+                        }
+                        if(p != _end && !is_blank(*p)) return false;
+                        value = negative ? -v : v;
+                        _pos = p;
+                        return true;
+                    }
+
+                    bool read_value(double& value){
+                        if(!has_token()) return false;
+                        //copy the token so that strtod never crosses the end of the line
+                        char buf[64];
+                        const char* p = _pos;
+                        std::size_t len = 0;
+                        while(p != _end && !is_blank(*p)){
+                            if(len + 1 >= sizeof(buf)) return false;
+                            buf[len++] = *p++;
+                        }
+                        buf[len] = '\0';
+                        char* parsed_end = nullptr;
+                        value = std::strtod(buf, &parsed_end);
+                        if(parsed_end != buf + len) return false;
+                        _pos = p;
+                        return true;
+                    }
+            };
+
+            /**
+             * @brief parse lines in [begin, end) (the range consists of whole lines)
+             */
+            inline void parse_range(const char* begin, const char* end, std::int64_t index_offset, std::int64_t num_spins, Chunk& chunk){
+                const char* line_begin = begin;
+                while(line_begin < end){
+                    const char* line_end = static_cast<const char*>(std::memchr(line_begin, '\n', static_cast<std::size_t>(end - line_begin)));
+                    if(line_end == nullptr) line_end = end;
+                    chunk.num_lines++;
+
+                    LineReader reader(line_begin, line_end);
+                    //skip blank lines and comments
+                    if(reader.has_token()){
+                        const char first = line_begin[reader.column()-1];
+                        if(first != '#' && first != '%' && first != 'c'){
+                            std::int64_t i, j;
+                            double value;
+                            std::size_t column = reader.column();
+                            bool ok = reader.read_index(i);
+                            if(ok){ reader.has_token(); column = reader.column(); ok = reader.read_index(j); }
+                            if(ok){ reader.has_token(); column = reader.column(); ok = reader.read_value(value); }
+                            if(!ok){
+                                chunk.failed = true;
+                                chunk.error_line = chunk.num_lines;
+                                chunk.error_column = column;
+                                chunk.error_message = "expected \"i j value\"";
+                                return;
+                            }
+                            if(reader.has_token()){
+                                chunk.failed = true;
+                                chunk.error_line = chunk.num_lines;
+                                chunk.error_column = reader.column();
+                                chunk.error_message = "unexpected token";
+                                return;
+                            }
+                            i -= index_offset;
+                            j -= index_offset;
+                            if(i < 0 || j < 0 || (num_spins > 0 && (i >= num_spins || j >= num_spins))){
+                                chunk.failed = true;
+                                chunk.error_line = chunk.num_lines;
+                                chunk.error_column = 1;
+                                chunk.error_message = "index out of range";
+                                return;
+                            }
+                            chunk.rows.push_back(i);
+                            chunk.cols.push_back(j);
+                            chunk.values.push_back(value);
+                            chunk.max_index = std::max(chunk.max_index, std::max(i, j));
+                        }
+                    }
+                    line_begin = line_end + 1;
+                }
+            }
+
+            /**
+             * @brief parse a block of whole lines with multiple threads
+             */
+            inline void parse_block(const char* begin, const char* end, std::int64_t index_offset, std::int64_t num_spins,
+                    std::vector<Chunk>& chunks, std::size_t base_line){
+                const std::size_t num_threads = chunks.size();
+                //split the block at line boundaries
+                std::vector<const char*> bounds(num_threads+1, end);
+                bounds[0] = begin;
+                const std::size_t step = static_cast<std::size_t>(end - begin) / num_threads;
+                for(std::size_t t=1; t<num_threads; t++){
+                    const char* p = std::max(bounds[t-1], begin + t*step);
+                    const char* nl = (p < end) ? static_cast<const char*>(std::memchr(p, '\n', static_cast<std::size_t>(end - p))) : nullptr;
+                    bounds[t] = (nl == nullptr) ? end : nl + 1;
+                }
+
+                std::vector<std::size_t> lines_before(num_threads, 0);
+                for(std::size_t t=0; t<num_threads; t++){
+                    lines_before[t] = chunks[t].num_lines;
+                }
+
+                std::vector<std::thread> threads;
+                for(std::size_t t=1; t<num_threads; t++){
+                    threads.emplace_back([&, t](){ parse_range(bounds[t], bounds[t+1], index_offset, num_spins, chunks[t]); });
+                }
+                parse_range(bounds[0], bounds[1], index_offset, num_spins, chunks[0]);
+                for(auto&& th : threads){
+                    th.join();
+                }
+
+                //report the first error in the file
+                std::size_t line = base_line;
+                for(std::size_t t=0; t<num_threads; t++){
+                    const std::size_t local_lines = chunks[t].num_lines - lines_before[t];
+                    if(chunks[t].failed){
+                        throw ParseError(chunks[t].error_message, line + chunks[t].error_line - lines_before[t] - 1, chunks[t].error_column);
+                    }
+                    line += local_lines;
+                }
+            }
+
+            inline std::size_t count_lines(const char* begin, const char* end){
+                return static_cast<std::size_t>(std::count(begin, end, '\n'));
+            }
+        } // namespace parser_impl
+
+        /**
+         * @brief parse a text stream into a Sparse graph with multiple threads
+         *
+         * The stream is read in blocks of (about) block_size bytes, and each block is split at line boundaries and parsed in parallel.
+         * Lines beginning with '#', '%' or 'c' and blank lines are ignored.
+         * Duplicate interactions are summed up.
+         *
+         * @tparam FloatType floating-point type
+         * @param is input stream
+         * @param format text format
+         * @param num_threads number of threads (0: hardware concurrency)
+         * @param block_size size of a block in bytes
+         *
+         * @return parsed graph (the number of spins is given by the Gset header or the maximum index + 1 for edge lists)
+         */
+        template<typename FloatType>
+            inline Sparse<FloatType> parse_sparse(std::istream& is, TextFormat format = TextFormat::EdgeList,
+                    std::size_t num_threads = 0, std::size_t block_size = (std::size_t(1) << 24)){
+                if(num_threads == 0){
+                    num_threads = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+                }
+                block_size = std::max<std::size_t>(block_size, 1);
+
+                std::vector<parser_impl::Chunk> chunks(num_threads);
+                std::vector<char> buffer;
+                std::vector<char> carry;
+                std::size_t base_line = 1;
+                bool header_done = (format != TextFormat::Gset);
+                std::int64_t num_spins = 0;
+                const std::int64_t index_offset = (format == TextFormat::Gset) ? 1 : 0;
+
+                bool eof = false;
+                while(!eof){
+                    //read a block and append it to the incomplete line of the previous block
+                    buffer.swap(carry);
+                    const std::size_t offset = buffer.size();
+                    buffer.resize(offset + block_size);
+                    is.read(buffer.data() + offset, static_cast<std::streamsize>(block_size));
+                    buffer.resize(offset + static_cast<std::size_t>(is.gcount()));
+                    eof = !is;
+
+                    const char* begin = buffer.data();
+                    const char* end = begin + buffer.size();
+
+                    //keep the last incomplete line for the next block
+                    const char* last = end;
+                    if(!eof){
+                        while(last != begin && *(last-1) != '\n') --last;
+                    }
+                    carry.assign(last, end);
+
+                    //Gset header (first non-comment line)
+                    while(!header_done && begin != last){
+                        const char* nl = static_cast<const char*>(std::memchr(begin, '\n', static_cast<std::size_t>(last - begin)));
+                        const char* line_end = (nl == nullptr) ? last : nl;
+                        parser_impl::LineReader reader(begin, line_end);
+                        if(reader.has_token() && begin[reader.column()-1] != '#' && begin[reader.column()-1] != '%' && begin[reader.column()-1] != 'c'){
+                            std::int64_t num_edges;
+                            std::size_t column = reader.column();
+                            bool ok = reader.read_index(num_spins) && num_spins > 0;
+                            if(ok){ reader.has_token(); column = reader.column(); ok = reader.read_index(num_edges); }
+                            if(!ok){
+                                throw ParseError("expected Gset header \"num_spins num_edges\"", base_line, column);
+                            }
+                            header_done = true;
+                        }
+                        base_line++;
+                        begin = (nl == nullptr) ? last : nl + 1;
+                    }
+
+                    if(begin != last){
+                        parser_impl::parse_block(begin, last, index_offset, num_spins, chunks, base_line);
+                        base_line += parser_impl::count_lines(begin, last);
+                    }
+                }
+
+                if(!header_done){
+                    throw ParseError("missing Gset header", base_line, 1);
+                }
+
+                //gather COO arrays
+                std::size_t total = 0;
+                std::int64_t max_index = -1;
+                for(auto&& chunk : chunks){
+                    total += chunk.values.size();
+                    max_index = std::max(max_index, chunk.max_index);
+                }
+                std::vector<std::int64_t> rows, cols;
+                std::vector<double> values;
+                rows.reserve(total);
+                cols.reserve(total);
+                values.reserve(total);
+                for(auto&& chunk : chunks){
+                    rows.insert(rows.end(), chunk.rows.begin(), chunk.rows.end());
+                    cols.insert(cols.end(), chunk.cols.begin(), chunk.cols.end());
+                    values.insert(values.end(), chunk.values.begin(), chunk.values.end());
+                    //release memory as soon as possible
+                    std::vector<std::int64_t>().swap(chunk.rows);
+                    std::vector<std::int64_t>().swap(chunk.cols);
+                    std::vector<double>().swap(chunk.values);
+                }
+
+                const std::size_t size = (format == TextFormat::Gset) ? static_cast<std::size_t>(num_spins) : static_cast<std::size_t>(max_index + 1);
+                return Sparse<FloatType>(size, rows.data(), cols.data(), values.data(), values.size());
+            }
+
+        /**
+         * @brief parse a text file into a Sparse graph with multiple threads
+         *
+         * @tparam FloatType floating-point type
+         * @param path path to the file
+         * @param format text format
+         * @param num_threads number of threads (0: hardware concurrency)
+         *
+         * @return parsed graph
+         */
+        template<typename FloatType>
+            inline Sparse<FloatType> parse_sparse(const std::string& path, TextFormat format = TextFormat::EdgeList, std::size_t num_threads = 0){
+                std::ifstream ifs(path, std::ios::binary);
+                if(!ifs){
+                    throw std::runtime_error("parse_sparse: cannot open " + path);
+                }
+                return parse_sparse<FloatType>(ifs, format, num_threads);
+            }
+    } // namespace graph
+} // namespace openjij
+
+#endif
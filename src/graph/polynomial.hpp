@@ -0,0 +1,263 @@
+//    Copyright 2019 Jij Inc.
+
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+
+//        http://www.apache.org/licenses/LICENSE-2.0
+
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+
+#ifndef OPENJIJ_GRAPH_POLYNOMIAL_HPP__
+#define OPENJIJ_GRAPH_POLYNOMIAL_HPP__
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include <graph/graph.hpp>
+
+namespace openjij {
+    namespace graph {
+
+        /**
+         * @brief type of variables
+         */
+        enum class Vartype{
+
+            /**
+             * @brief spin variables (-1 or +1)
+             */
+            SPIN,
+
+            /**
+             * @brief binary variables (0 or 1)
+             */
+            BINARY,
+        };
+
+        /**
+         * @brief polynomial interactions (higher-order binary model) E = \sum_t c_t \prod_{i \in t} x_i
+         *
+         * Terms are stored in flat arrays (variables of term t are term_vars()[term_offsets()[t]:term_offsets()[t+1]]),
+         * and each variable has an incidence list of the terms containing it, so that a flip touches only those terms.
+         * Linear terms are ordinary terms of degree one.
+         *
+         * @tparam FloatType floating-point type
+         */
+        template<typename FloatType>
+        class Polynomial : public Graph{
+            static_assert(std::is_floating_point<FloatType>::value, "FloatType must be floating-point type.");
+            public:
+
+                using value_type = FloatType;
+
+            private:
+
+                /**
+                 * @brief beginning of each term in _term_vars (size: number of terms + 1)
+                 */
+                std::vector<std::size_t> _term_offsets;
+
+                /**
+                 * @brief variables of the terms (flat)
+                 */
+                std::vector<Index> _term_vars;
+
+                /**
+                 * @brief coefficient of each term
+                 */
+                std::vector<FloatType> _coeffs;
+
+                /**
+                 * @brief beginning of each incidence list in _incidence (size: num_spins + 1)
+                 */
+                std::vector<std::size_t> _incidence_offsets;
+
+                /**
+                 * @brief terms containing each variable (flat)
+                 */
+                std::vector<std::size_t> _incidence;
+
+                /**
+                 * @brief append a term (variables are sorted and validated)
+                 *
+                 * @param sorted buffer reused over the terms
+                 */
+                template<typename Iterator>
+                void append_term(Iterator first, Iterator last, std::vector<Index>& sorted){
+                    if(first == last){
+                        throw std::invalid_argument("Polynomial: constant terms are not supported.");
+                    }
+                    sorted.clear();
+                    for(; first != last; ++first){
+                        //negative indices are mapped to large values by the conversion
+                        sorted.push_back(static_cast<Index>(*first));
+                    }
+                    std::sort(sorted.begin(), sorted.end());
+                    if(std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end()){
+                        throw std::invalid_argument("Polynomial: a term contains the same variable twice.");
+                    }
+                    if(sorted.back() >= get_num_spins()){
+                        throw std::invalid_argument("Polynomial: index out of range.");
+                    }
+                    for(auto&& i : sorted){
+                        _term_vars.push_back(i);
+                        _incidence_offsets[i+1]++;
+                    }
+                    _term_offsets.push_back(_term_vars.size());
+                }
+
+                /**
+                 * @brief build the incidence lists (counting sort by variable)
+                 */
+                void build_incidence(){
+                    for(std::size_t i=0; i<get_num_spins(); i++){
+                        _incidence_offsets[i+1] += _incidence_offsets[i];
+                    }
+                    _incidence.resize(_term_vars.size());
+                    std::vector<std::size_t> pos(_incidence_offsets.begin(), _incidence_offsets.end()-1);
+                    for(std::size_t t=0; t<get_num_terms(); t++){
+                        for(std::size_t k=_term_offsets[t]; k<_term_offsets[t+1]; k++){
+                            _incidence[pos[_term_vars[k]]++] = t;
+                        }
+                    }
+                }
+
+            public:
+
+                /**
+                 * @brief Polynomial constructor
+                 *
+                 * @param num_spins number of variables
+                 * @param terms variables of each term (nonempty, without duplicates)
+                 * @param coeffs coefficient of each term
+                 */
+                Polynomial(std::size_t num_spins, const std::vector<std::vector<Index>>& terms, const std::vector<FloatType>& coeffs)
+                    : Graph(num_spins), _term_offsets(1, 0), _coeffs(coeffs), _incidence_offsets(num_spins+1, 0){
+                        if(terms.size() != coeffs.size()){
+                            throw std::invalid_argument("Polynomial: terms and coeffs must have the same length.");
+                        }
+                        _term_offsets.reserve(terms.size()+1);
+                        std::vector<Index> sorted;
+                        for(auto&& term : terms){
+                            append_term(term.begin(), term.end(), sorted);
+                        }
+                        build_incidence();
+                    }
+
+                /**
+                 * @brief Polynomial constructor from flat arrays (e.g. numpy arrays, no per-term containers)
+                 *
+                 * @tparam IndexType index type of the arrays
+                 * @tparam ValueType value type of the coefficients
+                 * @param num_spins number of variables
+                 * @param term_vars variables of the terms (flat, size: term_offsets[num_terms])
+                 * @param term_offsets beginning of each term in term_vars (non-decreasing from 0, size: num_terms+1)
+                 * @param coeffs coefficient of each term (size: num_terms)
+                 * @param num_terms number of terms
+                 */
+                template<typename IndexType, typename ValueType>
+                Polynomial(std::size_t num_spins, const IndexType* term_vars, const IndexType* term_offsets, const ValueType* coeffs, std::size_t num_terms)
+                    : Graph(num_spins), _term_offsets(1, 0), _coeffs(coeffs, coeffs+num_terms), _incidence_offsets(num_spins+1, 0){
+                        if(term_offsets[0] != 0){
+                            throw std::invalid_argument("Polynomial: term_offsets must start with 0.");
+                        }
+                        _term_offsets.reserve(num_terms+1);
+                        _term_vars.reserve(static_cast<std::size_t>(term_offsets[num_terms]));
+                        std::vector<Index> sorted;
+                        for(std::size_t t=0; t<num_terms; t++){
+                            if(term_offsets[t+1] < term_offsets[t]){
+                                throw std::invalid_argument("Polynomial: term_offsets must be non-decreasing.");
+                            }
+                            append_term(term_vars + term_offsets[t], term_vars + term_offsets[t+1], sorted);
+                        }
+                        build_incidence();
+                    }
+
+                /**
+                 * @brief Polynomial copy constructor
+                 */
+                Polynomial(const Polynomial<FloatType>&) = default;
+
+                /**
+                 * @brief Polynomial move constructor
+                 */
+                Polynomial(Polynomial<FloatType>&&) = default;
+
+                /**
+                 * @brief get number of terms
+                 *
+                 * @return number of terms
+                 */
+                std::size_t get_num_terms() const{
+                    return _coeffs.size();
+                }
+
+                /**
+                 * @brief get beginning of each term in term_vars() (size: number of terms + 1)
+                 */
+                const std::vector<std::size_t>& term_offsets() const{
+                    return _term_offsets;
+                }
+
+                /**
+                 * @brief get variables of the terms (flat, sorted within each term)
+                 */
+                const std::vector<Index>& term_vars() const{
+                    return _term_vars;
+                }
+
+                /**
+                 * @brief get coefficient of each term
+                 */
+                const std::vector<FloatType>& coeffs() const{
+                    return _coeffs;
+                }
+
+                /**
+                 * @brief get beginning of each incidence list in incidence() (size: num_spins + 1)
+                 */
+                const std::vector<std::size_t>& incidence_offsets() const{
+                    return _incidence_offsets;
+                }
+
+                /**
+                 * @brief get terms containing each variable (flat)
+                 */
+                const std::vector<std::size_t>& incidence() const{
+                    return _incidence;
+                }
+
+                /**
+                 * @brief calculate total energy
+                 *
+                 * @param spins variables (-1/+1 for SPIN, 0/1 for BINARY; the formula is the same)
+                 *
+                 * @return total energy
+                 */
+                FloatType calc_energy(const Spins& spins) const{
+                    assert(spins.size() == get_num_spins());
+                    FloatType ret = 0;
+                    for(std::size_t t=0; t<get_num_terms(); t++){
+                        Spin prod = 1;
+                        for(std::size_t k=_term_offsets[t]; k<_term_offsets[t+1]; k++){
+                            prod *= spins[_term_vars[k]];
+                        }
+                        ret += _coeffs[t] * prod;
+                    }
+                    return ret;
+                }
+        };
+
+    } // namespace graph
+} // namespace openjij
+
+#endif
@@ -0,0 +1,472 @@
+//    Copyright 2019 Jij Inc.
+
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+
+//        http://www.apache.org/licenses/LICENSE-2.0
+
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+
+#ifndef OPENJIJ_GRAPH_QUANTIZED_HPP__
+#define OPENJIJ_GRAPH_QUANTIZED_HPP__
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include <graph/graph.hpp>
+#include <utility/memory.hpp>
+
+namespace openjij {
+    namespace graph {
+
+        /**
+         * @brief integer type used to accumulate the couplings of a row
+         *
+         * int8 couplings are accumulated in int32, wider couplings in int64.
+         *
+         * @tparam IntType integer type of couplings
+         */
+        template<typename IntType>
+            using QuantizedAccumulator = typename std::conditional<(sizeof(IntType) <= 1), std::int32_t, std::int64_t>::type;
+
+        /**
+         * @brief integer type of local fields and energies (the fields h and the sums over all spins may exceed the row accumulator)
+         */
+        using QuantizedField = std::int64_t;
+
+        /**
+         * @brief convert a value to an integer multiple of scale
+         *
+         * @tparam IntType integer type
+         * @tparam FloatType floating-point type
+         * @param value value to be converted
+         * @param scale scale factor
+         *
+         * @return value / scale
+         */
+        template<typename IntType, typename FloatType>
+            inline IntType quantize(FloatType value, FloatType scale){
+                const double q = static_cast<double>(value) / static_cast<double>(scale);
+                const double r = std::round(q);
+                if(std::abs(q - r) > 1e-6 * std::max(1.0, std::abs(q))){
+                    throw std::invalid_argument("quantize: value is not an integer multiple of the scale.");
+                }
+                if(r < static_cast<double>(std::numeric_limits<IntType>::min()) || r > static_cast<double>(std::numeric_limits<IntType>::max())){
+                    throw std::out_of_range("quantize: value is out of range of the integer type.");
+                }
+                return static_cast<IntType>(r);
+            }
+
+        /**
+         * @brief immutable all-to-all interactions stored as integers with a per-graph scale factor
+         *
+         * J_{ij} = scale * (integer coupling), h_{i} = scale * (integer field).
+         * Like DenseMatrix, the full symmetric matrix is stored row-major with aligned, padded rows and zero diagonal.
+         *
+         * @tparam IntType integer type of couplings (e.g. std::int8_t, std::int16_t)
+         * @tparam FloatType floating-point type
+         */
+        template<typename IntType, typename FloatType>
+            class QuantizedDense : public Graph{
+                static_assert(std::is_integral<IntType>::value && std::is_signed<IntType>::value, "IntType must be signed integer type.");
+                static_assert(std::is_floating_point<FloatType>::value, "FloatType must be floating-point type.");
+                public:
+
+                    /**
+                     * @brief float type
+                     */
+                    using value_type = FloatType;
+
+                    /**
+                     * @brief integer type of couplings
+                     */
+                    using int_type = IntType;
+
+                    /**
+                     * @brief integer type of the sum of the couplings of a row
+                     */
+                    using accumulator_type = QuantizedAccumulator<IntType>;
+
+                    /**
+                     * @brief integer type of local fields
+                     */
+                    using field_type = QuantizedField;
+
+                    /**
+                     * @brief alignment of each row in bytes
+                     */
+                    static constexpr std::size_t alignment = 64;
+
+                private:
+
+                    /**
+                     * @brief number of elements per row
+                     */
+                    std::size_t _stride;
+
+                    /**
+                     * @brief scale factor
+                     */
+                    FloatType _scale;
+
+                    /**
+                     * @brief integer couplings (num_spins x stride, row-major, symmetric)
+                     */
+                    std::vector<IntType, utility::AlignedAllocator<IntType, alignment>> _J;
+
+                    /**
+                     * @brief integer local fields
+                     */
+                    std::vector<field_type> _h;
+
+                public:
+
+                    /**
+                     * @brief QuantizedDense constructor from any graph (Dense, Sparse or derived class of them)
+                     *
+                     * @tparam GraphType type of graph
+                     * @param graph graph to be quantized
+                     * @param scale scale factor (all couplings and fields must be integer multiples of it)
+                     */
+                    template<typename GraphType>
+                        explicit QuantizedDense(const GraphType& graph, FloatType scale = 1)
+                        : Graph(graph.get_num_spins()), _stride(calc_stride(graph.get_num_spins())), _scale(scale),
+                        _J(graph.get_num_spins()*_stride, 0), _h(graph.get_num_spins(), 0){
+                            if(!(scale > 0)){
+                                throw std::invalid_argument("QuantizedDense: scale must be positive.");
+                            }
+                            for(std::size_t i=0; i<get_num_spins(); i++){
+                                for(auto&& j : graph.adj_nodes(i)){
+                                    if(i == j){
+                                        _h[i] = quantize<field_type>(graph.h(i), scale);
+                                    }
+                                    else{
+                                        _J[i*_stride+j] = quantize<IntType>(graph.J(i, j), scale);
+                                    }
+                                }
+                            }
+                        }
+
+                    /**
+                     * @brief number of elements per row including padding
+                     *
+                     * @return stride
+                     */
+                    std::size_t get_stride() const{
+                        return _stride;
+                    }
+
+                    /**
+                     * @brief calculate row stride for the given number of spins
+                     *
+                     * @param num_spins number of spins
+                     *
+                     * @return stride
+                     */
+                    inline static std::size_t calc_stride(std::size_t num_spins){
+                        constexpr std::size_t block = alignment / sizeof(IntType);
+                        return (num_spins + block - 1) / block * block;
+                    }
+
+                    /**
+                     * @brief scale factor
+                     *
+                     * @return scale
+                     */
+                    FloatType get_scale() const{
+                        return _scale;
+                    }
+
+                    /**
+                     * @brief pointer to the first element of a row (aligned, integer couplings)
+                     *
+                     * @param i Index i
+                     *
+                     * @return pointer to the integer J_{i0}
+                     */
+                    const IntType* row(Index i) const{
+                        assert(i < get_num_spins());
+                        return _J.data() + i*_stride;
+                    }
+
+                    /**
+                     * @brief calculate integer local field of a spin (h_i + \sum_j J_{ij} s_j in units of scale)
+                     *
+                     * @param i Index i
+                     * @param spins spin configuration
+                     *
+                     * @return integer local field
+                     */
+                    field_type local_field(Index i, const Spins& spins) const{
+                        assert(spins.size() == get_num_spins());
+                        const IntType* r = row(i);
+                        const Spin* s = spins.data();
+                        accumulator_type ret = 0;
+                        for(std::size_t j=0, num_spins=get_num_spins(); j<num_spins; j++){
+                            ret += static_cast<accumulator_type>(r[j]) * s[j];
+                        }
+                        return static_cast<field_type>(ret) + _h[i];
+                    }
+
+                    /**
+                     * @brief calculate total energy
+                     *
+                     * @param spins
+                     *
+                     * @return corresponding energy
+                     */
+                    FloatType calc_energy(const Spins& spins) const{
+                        assert(spins.size() == get_num_spins());
+                        field_type ret = 0;
+                        for(std::size_t i=0; i<get_num_spins(); i++){
+                            //J is counted twice
+                            ret += (local_field(i, spins) + _h[i]) * spins[i];
+                        }
+                        return _scale * static_cast<FloatType>(ret) / 2;
+                    }
+
+                    /**
+                     * @brief get J_{ij}
+                     *
+                     * @param i Index i
+                     * @param j Index j
+                     *
+                     * @return J_{ij} (h_{i} if i == j)
+                     */
+                    FloatType J(Index i, Index j) const{
+                        assert(i < get_num_spins());
+                        assert(j < get_num_spins());
+                        return (i == j) ? h(i) : _scale * _J[i*_stride+j];
+                    }
+
+                    /**
+                     * @brief get h_{i} (local field)
+                     *
+                     * @param i Index i
+                     *
+                     * @return h_{i}
+                     */
+                    FloatType h(Index i) const{
+                        assert(i < get_num_spins());
+                        return _scale * _h[i];
+                    }
+            };
+
+        /**
+         * @brief immutable sparse interactions stored as integers with a per-graph scale factor (CSR layout)
+         *
+         * J_{ij} = scale * (integer coupling), h_{i} = scale * (integer field).
+         * Neighbor indices (32 bit) and integer couplings are kept in separate arrays, so that a row is not padded to the size of Index.
+         *
+         * @tparam IntType integer type of couplings (e.g. std::int8_t, std::int16_t)
+         * @tparam FloatType floating-point type
+         */
+        template<typename IntType, typename FloatType>
+            class QuantizedSparse : public Graph{
+                static_assert(std::is_integral<IntType>::value && std::is_signed<IntType>::value, "IntType must be signed integer type.");
+                static_assert(std::is_floating_point<FloatType>::value, "FloatType must be floating-point type.");
+                public:
+
+                    /**
+                     * @brief float type
+                     */
+                    using value_type = FloatType;
+
+                    /**
+                     * @brief integer type of couplings
+                     */
+                    using int_type = IntType;
+
+                    /**
+                     * @brief integer type of the sum of the couplings of a row
+                     */
+                    using accumulator_type = QuantizedAccumulator<IntType>;
+
+                    /**
+                     * @brief integer type of local fields
+                     */
+                    using field_type = QuantizedField;
+
+                    /**
+                     * @brief type of neighbor indices
+                     */
+                    using CompactIndex = std::uint32_t;
+
+                private:
+
+                    /**
+                     * @brief scale factor
+                     */
+                    FloatType _scale;
+
+                    /**
+                     * @brief offsets of each row (size: num_spins+1)
+                     */
+                    std::vector<std::size_t> _row_offsets;
+
+                    /**
+                     * @brief adjacent nodes (sorted in each row)
+                     */
+                    std::vector<CompactIndex> _indices;
+
+                    /**
+                     * @brief integer couplings (parallel to _indices)
+                     */
+                    std::vector<IntType> _values;
+
+                    /**
+                     * @brief integer local fields
+                     */
+                    std::vector<field_type> _h;
+
+                public:
+
+                    /**
+                     * @brief QuantizedSparse constructor from any graph (Dense, Sparse or derived class of them)
+                     *
+                     * @tparam GraphType type of graph
+                     * @param graph graph to be quantized
+                     * @param scale scale factor (all couplings and fields must be integer multiples of it)
+                     */
+                    template<typename GraphType>
+                        explicit QuantizedSparse(const GraphType& graph, FloatType scale = 1)
+                        : Graph(graph.get_num_spins()), _scale(scale), _row_offsets(graph.get_num_spins()+1, 0), _h(graph.get_num_spins(), 0){
+                            if(!(scale > 0)){
+                                throw std::invalid_argument("QuantizedSparse: scale must be positive.");
+                            }
+                            if(get_num_spins() > std::numeric_limits<CompactIndex>::max()){
+                                throw std::invalid_argument("QuantizedSparse: too many spins.");
+                            }
+                            std::vector<Index> row;
+                            for(std::size_t i=0; i<get_num_spins(); i++){
+                                row.clear();
+                                for(auto&& j : graph.adj_nodes(i)){
+                                    if(i == j){
+                                        _h[i] = quantize<field_type>(graph.h(i), scale);
+                                    }
+                                    else{
+                                        row.push_back(j);
+                                    }
+                                }
+                                std::sort(row.begin(), row.end());
+                                for(auto&& j : row){
+                                    _indices.push_back(static_cast<CompactIndex>(j));
+                                    _values.push_back(quantize<IntType>(graph.J(i, j), scale));
+                                }
+                                _row_offsets[i+1] = _indices.size();
+                            }
+                        }
+
+                    /**
+                     * @brief scale factor
+                     *
+                     * @return scale
+                     */
+                    FloatType get_scale() const{
+                        return _scale;
+                    }
+
+                    /**
+                     * @brief number of adjacent nodes of a site (local field excluded)
+                     *
+                     * @param ind Node index
+                     *
+                     * @return degree
+                     */
+                    std::size_t degree(Index ind) const{
+                        assert(ind < get_num_spins());
+                        return _row_offsets[ind+1] - _row_offsets[ind];
+                    }
+
+                    /**
+                     * @brief get total number of stored (directed) edges
+                     *
+                     * @return number of edges
+                     */
+                    std::size_t get_num_stored_edges() const{
+                        return _indices.size();
+                    }
+
+                    /**
+                     * @brief calculate integer local field of a spin (h_i + \sum_j J_{ij} s_j in units of scale)
+                     *
+                     * @param i Index i
+                     * @param spins spin configuration
+                     *
+                     * @return integer local field
+                     */
+                    field_type local_field(Index i, const Spins& spins) const{
+                        assert(spins.size() == get_num_spins());
+                        accumulator_type ret = 0;
+                        for(std::size_t k=_row_offsets[i], end=_row_offsets[i+1]; k<end; k++){
+                            ret += static_cast<accumulator_type>(_values[k]) * spins[_indices[k]];
+                        }
+                        return static_cast<field_type>(ret) + _h[i];
+                    }
+
+                    /**
+                     * @brief calculate total energy
+                     *
+                     * @param spins
+                     *
+                     * @return corresponding energy
+                     */
+                    FloatType calc_energy(const Spins& spins) const{
+                        assert(spins.size() == get_num_spins());
+                        field_type ret = 0;
+                        for(std::size_t i=0; i<get_num_spins(); i++){
+                            //J is counted twice
+                            ret += (local_field(i, spins) + _h[i]) * spins[i];
+                        }
+                        return _scale * static_cast<FloatType>(ret) / 2;
+                    }
+
+                    /**
+                     * @brief get J_{ij} (binary search in the row)
+                     *
+                     * @param i Index i
+                     * @param j Index j
+                     *
+                     * @return J_{ij} (h_{i} if i == j)
+                     */
+                    FloatType J(Index i, Index j) const{
+                        assert(i < get_num_spins());
+                        assert(j < get_num_spins());
+                        if(i == j) return h(i);
+                        const auto first = _indices.begin() + _row_offsets[i];
+                        const auto last = _indices.begin() + _row_offsets[i+1];
+                        const auto it = std::lower_bound(first, last, static_cast<CompactIndex>(j));
+                        if(it == last || *it != j){
+                            throw std::out_of_range("QuantizedSparse::J: the interaction does not exist.");
+                        }
+                        return _scale * _values[static_cast<std::size_t>(it - _indices.begin())];
+                    }
+
+                    /**
+                     * @brief get h_{i} (local field)
+                     *
+                     * @param i Index i
+                     *
+                     * @return h_{i}
+                     */
+                    FloatType h(Index i) const{
+                        assert(i < get_num_spins());
+                        return _scale * _h[i];
+                    }
+            };
+    } // namespace graph
+} // namespace openjij
+
+#endif
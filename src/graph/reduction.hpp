@@ -0,0 +1,366 @@
+//    Copyright 2019 Jij Inc.
+
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+
+//        http://www.apache.org/licenses/LICENSE-2.0
+
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+
+#ifndef OPENJIJ_GRAPH_REDUCTION_HPP__
+#define OPENJIJ_GRAPH_REDUCTION_HPP__
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <queue>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <graph/graph.hpp>
+#include <graph/polynomial.hpp>
+#include <graph/sparse.hpp>
+#include <utility/pairhash.hpp>
+
+namespace openjij {
+    namespace graph {
+
+        /**
+         * @brief quadratic (Ising) model obtained from a polynomial by substituting products of two variables
+         *
+         * Spins 0, ..., num_variables-1 are the original variables and spin num_variables+k is the auxiliary variable
+         * of aux_pairs[k], i.e. x_{num_variables+k} = x_{aux_pairs[k].first} x_{aux_pairs[k].second} in the binary domain.
+         * The energy of the original polynomial is interaction.calc_energy(spins) + offset whenever the auxiliary variables are consistent,
+         * and the penalties make the consistent states the ground states.
+         *
+         * @tparam FloatType floating-point type
+         */
+        template<typename FloatType>
+            struct ReducedPolynomial{
+
+                /**
+                 * @brief Ising interactions over the original and the auxiliary spins
+                 */
+                Sparse<FloatType> interaction;
+
+                /**
+                 * @brief constant energy
+                 */
+                FloatType offset;
+
+                /**
+                 * @brief number of original variables
+                 */
+                std::size_t num_variables;
+
+                /**
+                 * @brief type of the original variables
+                 */
+                Vartype vartype;
+
+                /**
+                 * @brief variables substituted by each auxiliary variable
+                 */
+                std::vector<std::pair<Index, Index>> aux_pairs;
+
+                /**
+                 * @brief penalty strength of each auxiliary variable
+                 */
+                std::vector<FloatType> penalties;
+
+                /**
+                 * @brief convert spins of the reduced model into the original variables
+                 *
+                 * @param spins spins of the reduced model (size: interaction.get_num_spins())
+                 *
+                 * @return original variables (-1/+1 for SPIN, 0/1 for BINARY)
+                 */
+                Spins decode(const Spins& spins) const{
+                    assert(spins.size() == interaction.get_num_spins());
+                    Spins ret(spins.begin(), spins.begin() + num_variables);
+                    if(vartype == Vartype::BINARY){
+                        for(auto&& x : ret) x = (x + 1) / 2;
+                    }
+                    return ret;
+                }
+            };
+
+        namespace reduction_impl{
+
+            /**
+             * @brief hash class for terms (sorted variables)
+             */
+            struct TermHash{
+                inline std::size_t operator()(const std::vector<Index>& term) const{
+                    std::size_t seed = term.size();
+                    for(auto&& i : term){
+                        seed ^= std::hash<Index>()(i) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+                    }
+                    return seed;
+                }
+            };
+
+            template<typename FloatType>
+                using BinaryTerms = std::unordered_map<std::vector<Index>, FloatType, TermHash>;
+
+            /**
+             * @brief collect the terms of a polynomial in the binary domain (spin terms are expanded with s = 2x - 1)
+             *
+             * @param polynomial polynomial
+             * @param vartype type of variables of the polynomial
+             * @param terms merged binary terms (output)
+             *
+             * @return constant energy
+             */
+            template<typename FloatType>
+                inline FloatType to_binary(const Polynomial<FloatType>& polynomial, Vartype vartype, BinaryTerms<FloatType>& terms){
+                    const auto& offsets = polynomial.term_offsets();
+                    const auto& vars = polynomial.term_vars();
+                    const auto& coeffs = polynomial.coeffs();
+                    FloatType constant = 0;
+                    std::vector<Index> subset;
+                    for(std::size_t t=0; t<polynomial.get_num_terms(); t++){
+                        const std::size_t degree = offsets[t+1] - offsets[t];
+                        if(vartype == Vartype::BINARY){
+                            terms[std::vector<Index>(vars.begin()+offsets[t], vars.begin()+offsets[t+1])] += coeffs[t];
+                            continue;
+                        }
+                        //\prod_i (2x_i - 1) has 2^degree terms
+                        if(degree >= 32){
+                            throw std::invalid_argument("reduce_to_quadratic: degree of a spin term is too large to be expanded.");
+                        }
+                        for(std::size_t mask=0; mask < (std::size_t(1) << degree); mask++){
+                            subset.clear();
+                            for(std::size_t k=0; k<degree; k++){
+                                if((mask >> k) & 1) subset.push_back(vars[offsets[t]+k]);
+                            }
+                            const FloatType sign = ((degree - subset.size()) % 2 == 0) ? 1 : -1;
+                            const FloatType value = coeffs[t] * sign * std::ldexp(FloatType(1), static_cast<int>(subset.size()));
+                            if(subset.empty()){
+                                constant += value;
+                            }
+                            else{
+                                terms[subset] += value;
+                            }
+                        }
+                    }
+                    return constant;
+                }
+        } // namespace reduction_impl
+
+        /**
+         * @brief reduce a polynomial to a quadratic model with auxiliary variables
+         *
+         * The pair of variables shared by the largest number of terms of degree >= 3 is substituted by a new auxiliary variable
+         * (ties are broken by the smaller pair), and the pair counts are updated incrementally until every term is quadratic.
+         * Each auxiliary variable x_a = x_i x_j is enforced by the penalty P_a (x_i x_j - 2 x_i x_a - 2 x_j x_a + 3 x_a).
+         * Unless strength is given, P_a is set larger than the largest energy change caused by x_a (its terms and the penalties of
+         * the auxiliary variables built on top of it), so that the ground states of the reduced model are those of the polynomial.
+         *
+         * @tparam FloatType floating-point type
+         * @param polynomial polynomial interactions
+         * @param vartype type of variables of the polynomial
+         * @param strength penalty strength for all the auxiliary variables (automatic if not positive)
+         *
+         * @return reduced quadratic model
+         */
+        template<typename FloatType>
+            inline ReducedPolynomial<FloatType> reduce_to_quadratic(const Polynomial<FloatType>& polynomial, Vartype vartype, FloatType strength = 0){
+                using Pair = std::pair<Index, Index>;
+                const std::size_t num_variables = polynomial.get_num_spins();
+
+                //binary terms
+                reduction_impl::BinaryTerms<FloatType> merged;
+                FloatType offset = reduction_impl::to_binary(polynomial, vartype, merged);
+                std::vector<std::vector<Index>> terms;
+                std::vector<FloatType> coeffs;
+                terms.reserve(merged.size());
+                coeffs.reserve(merged.size());
+                for(auto&& elem : merged){
+                    if(elem.second != 0){
+                        terms.push_back(elem.first);
+                        coeffs.push_back(elem.second);
+                    }
+                }
+                merged.clear();
+
+                //pair counts over the terms of degree >= 3
+                std::unordered_map<Pair, std::size_t, utility::PairHash> pairs;
+                std::size_t num_pairs = 0;
+                for(auto&& term : terms){
+                    if(term.size() > 2) num_pairs += term.size()*(term.size()-1)/2;
+                }
+                pairs.reserve(num_pairs);
+                for(auto&& term : terms){
+                    if(term.size() <= 2) continue;
+                    for(std::size_t a=0; a<term.size(); a++){
+                        for(std::size_t b=a+1; b<term.size(); b++){
+                            pairs[std::make_pair(term[a], term[b])]++;
+                        }
+                    }
+                }
+
+                //terms containing each shared pair
+                //(a substitution only removes pairs from a term or adds pairs with the new auxiliary variable,
+                //so that a pair contained in a single term never needs the list)
+                std::unordered_map<Pair, std::vector<std::size_t>, utility::PairHash> occurrences;
+                for(std::size_t t=0; t<terms.size(); t++){
+                    const auto& term = terms[t];
+                    if(term.size() <= 2) continue;
+                    for(std::size_t a=0; a<term.size(); a++){
+                        for(std::size_t b=a+1; b<term.size(); b++){
+                            const Pair p = std::make_pair(term[a], term[b]);
+                            if(pairs[p] > 1) occurrences[p].push_back(t);
+                        }
+                    }
+                }
+
+                //max-heap of pair counts (stale entries are skipped)
+                using HeapEntry = std::pair<std::size_t, Pair>;
+                auto less = [](const HeapEntry& a, const HeapEntry& b){
+                    return (a.first != b.first) ? a.first < b.first : a.second > b.second;
+                };
+                std::priority_queue<HeapEntry, std::vector<HeapEntry>, decltype(less)> heap(less);
+                for(auto&& elem : occurrences){
+                    heap.emplace(elem.second.size(), elem.first);
+                }
+
+                auto decrement = [&](const Pair& p){
+                    auto& count = pairs[p];
+                    count--;
+                    if(count > 1) heap.emplace(count, p);
+                };
+
+                std::vector<Pair> aux_pairs;
+                std::vector<std::size_t> listed;
+                //pairs contained in a single term are left to the end
+                while(!heap.empty()){
+                    const HeapEntry top = heap.top();
+                    heap.pop();
+                    auto it = pairs.find(top.second);
+                    if(it == pairs.end() || it->second != top.first) continue;
+
+                    const Index i = top.second.first;
+                    const Index j = top.second.second;
+                    //the new auxiliary variable has the largest index, so that the terms stay sorted
+                    const Index aux = num_variables + aux_pairs.size();
+                    aux_pairs.push_back(top.second);
+                    listed.clear();
+                    listed.swap(occurrences[top.second]);
+
+                    for(auto&& t : listed){
+                        auto& term = terms[t];
+                        //the pair may have been removed from the term by another substitution
+                        if(term.size() <= 2
+                                || !std::binary_search(term.begin(), term.end(), i)
+                                || !std::binary_search(term.begin(), term.end(), j)) continue;
+                        term.erase(std::remove_if(term.begin(), term.end(), [i, j](Index k){return k == i || k == j;}), term.end());
+                        //pairs with i or j are removed, and the pairs with aux are added if the term is still of degree >= 3
+                        //(a cubic term has no other pair)
+                        decrement(top.second);
+                        for(auto&& k : term){
+                            decrement(std::make_pair(std::min(i, k), std::max(i, k)));
+                            decrement(std::make_pair(std::min(j, k), std::max(j, k)));
+                        }
+                        if(term.size() >= 2){
+                            for(auto&& k : term){
+                                const Pair p = std::make_pair(k, aux);
+                                auto& count = pairs[p];
+                                count++;
+                                occurrences[p].push_back(t);
+                                if(count > 1) heap.emplace(count, p);
+                            }
+                        }
+                        term.push_back(aux);
+                    }
+                    occurrences.erase(top.second);
+                    pairs.erase(top.second);
+                }
+                pairs.clear();
+                occurrences.clear();
+
+                //the remaining terms share no pair, so that they are reduced independently
+                for(auto&& term : terms){
+                    while(term.size() > 2){
+                        aux_pairs.emplace_back(term[0], term[1]);
+                        term.erase(term.begin(), term.begin()+2);
+                        term.push_back(num_variables + aux_pairs.size() - 1);
+                    }
+                }
+
+                //penalty strengths (an auxiliary variable is only used by the ones created after it)
+                const std::size_t num_spins = num_variables + aux_pairs.size();
+                std::vector<FloatType> penalties(aux_pairs.size(), strength);
+                if(!(strength > 0)){
+                    std::vector<FloatType> bound(num_spins, 0);
+                    for(std::size_t t=0; t<terms.size(); t++){
+                        for(auto&& i : terms[t]) bound[i] += std::abs(coeffs[t]);
+                    }
+                    for(std::size_t k=aux_pairs.size(); k-- > 0; ){
+                        const Index aux = num_variables + k;
+                        penalties[k] = (bound[aux] > 0) ? FloatType(1.5) * bound[aux] : FloatType(1);
+                        //terms with coefficients P, P and -2P contain x_i, x_j
+                        bound[aux_pairs[k].first] += 3 * penalties[k];
+                        bound[aux_pairs[k].second] += 3 * penalties[k];
+                    }
+                }
+
+                //binary quadratic model to ising model (x = (1 + s)/2)
+                std::vector<Index> rows, cols;
+                std::vector<FloatType> values;
+                std::vector<FloatType> h(num_spins, 0);
+                auto add_linear = [&](Index i, FloatType c){
+                    h[i] += c / 2;
+                    offset += c / 2;
+                };
+                auto add_quadratic = [&](Index i, Index j, FloatType c){
+                    rows.push_back(i);
+                    cols.push_back(j);
+                    values.push_back(c / 4);
+                    h[i] += c / 4;
+                    h[j] += c / 4;
+                    offset += c / 4;
+                };
+                for(std::size_t t=0; t<terms.size(); t++){
+                    if(terms[t].size() == 1){
+                        add_linear(terms[t][0], coeffs[t]);
+                    }
+                    else{
+                        assert(terms[t].size() == 2);
+                        add_quadratic(terms[t][0], terms[t][1], coeffs[t]);
+                    }
+                }
+                for(std::size_t k=0; k<aux_pairs.size(); k++){
+                    const Index aux = num_variables + k;
+                    const FloatType p = penalties[k];
+                    add_quadratic(aux_pairs[k].first, aux_pairs[k].second, p);
+                    add_quadratic(aux_pairs[k].first, aux, -2*p);
+                    add_quadratic(aux_pairs[k].second, aux, -2*p);
+                    add_linear(aux, 3*p);
+                }
+                for(std::size_t i=0; i<num_spins; i++){
+                    if(h[i] != 0){
+                        rows.push_back(i);
+                        cols.push_back(i);
+                        values.push_back(h[i]);
+                    }
+                }
+
+                return ReducedPolynomial<FloatType>{
+                    Sparse<FloatType>(num_spins, rows.data(), cols.data(), values.data(), values.size()),
+                        offset, num_variables, vartype, std::move(aux_pairs), std::move(penalties)};
+            }
+
+    } // namespace graph
+} // namespace openjij
+
+#endif
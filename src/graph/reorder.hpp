@@ -0,0 +1,239 @@
+//    Copyright 2019 Jij Inc.
+
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+
+//        http://www.apache.org/licenses/LICENSE-2.0
+
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+
+#ifndef OPENJIJ_GRAPH_REORDER_HPP__
+#define OPENJIJ_GRAPH_REORDER_HPP__
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <graph/graph.hpp>
+#include <graph/sparse.hpp>
+
+namespace openjij {
+    namespace graph {
+
+        /**
+         * @brief compute reverse Cuthill-McKee ordering of a graph
+         *
+         * Each connected component is traversed in breadth-first order starting from a node of minimum degree,
+         * visiting the neighbors in ascending order of degree; the whole order is reversed at the end.
+         * Adjacent nodes thereby get close indices, which reduces the bandwidth of the interaction matrix.
+         *
+         * @tparam GraphType type of graph (assume Dense, Sparse or derived class of them)
+         * @param graph graph
+         *
+         * @return order (order[new index] = original index)
+         */
+        template<typename GraphType>
+            inline std::vector<Index> reverse_cuthill_mckee(const GraphType& graph){
+                const std::size_t num_spins = graph.get_num_spins();
+
+                //degree (local field excluded)
+                std::vector<std::size_t> degree(num_spins, 0);
+                for(std::size_t i=0; i<num_spins; i++){
+                    for(auto&& j : graph.adj_nodes(i)){
+                        if(j != i) degree[i]++;
+                    }
+                }
+
+                //nodes sorted by degree (start node candidates)
+                std::vector<Index> by_degree(num_spins);
+                for(std::size_t i=0; i<num_spins; i++) by_degree[i] = i;
+                std::stable_sort(by_degree.begin(), by_degree.end(), [&degree](Index a, Index b){return degree[a] < degree[b];});
+
+                std::vector<Index> order;
+                order.reserve(num_spins);
+                std::vector<bool> visited(num_spins, false);
+                std::vector<Index> neighbors;
+
+                for(auto&& start : by_degree){
+                    if(visited[start]) continue;
+                    visited[start] = true;
+                    //breadth-first search (order itself is used as the queue)
+                    std::size_t head = order.size();
+                    order.push_back(start);
+                    while(head < order.size()){
+                        const Index i = order[head++];
+                        neighbors.clear();
+                        for(auto&& j : graph.adj_nodes(i)){
+                            if(!visited[j]){
+                                visited[j] = true;
+                                neighbors.push_back(j);
+                            }
+                        }
+                        std::stable_sort(neighbors.begin(), neighbors.end(), [&degree](Index a, Index b){return degree[a] < degree[b];});
+                        order.insert(order.end(), neighbors.begin(), neighbors.end());
+                    }
+                }
+
+                std::reverse(order.begin(), order.end());
+                return order;
+            }
+
+        /**
+         * @brief Sparse graph whose nodes are relabeled for memory locality
+         *
+         * Updaters see the relabeled graph (index k corresponds to the original node get_order()[k]),
+         * so that the spins of adjacent nodes are stored close to each other.
+         * result::get_solution maps the solution back to the original labels.
+         *
+         * @tparam FloatType floating-point type
+         */
+        template<typename FloatType>
+            class ReorderedSparse : public Sparse<FloatType>{
+                private:
+
+                    /**
+                     * @brief original index of each relabeled node
+                     */
+                    std::vector<Index> _to_original;
+
+                    /**
+                     * @brief relabeled index of each original node
+                     */
+                    std::vector<Index> _to_reordered;
+
+                    /**
+                     * @brief inverse permutation
+                     *
+                     * @param order permutation
+                     *
+                     * @return inverse of order
+                     */
+                    static std::vector<Index> invert(const std::vector<Index>& order){
+                        std::vector<Index> inverse(order.size(), order.size());
+                        for(std::size_t k=0; k<order.size(); k++){
+                            if(order[k] >= order.size() || inverse[order[k]] != order.size()){
+                                throw std::invalid_argument("ReorderedSparse: order is not a permutation.");
+                            }
+                            inverse[order[k]] = k;
+                        }
+                        return inverse;
+                    }
+
+                    /**
+                     * @brief build relabeled Sparse graph
+                     *
+                     * @tparam GraphType type of graph
+                     * @param graph original graph
+                     * @param to_reordered relabeled index of each original node
+                     *
+                     * @return relabeled graph
+                     */
+                    template<typename GraphType>
+                        static Sparse<FloatType> relabel(const GraphType& graph, const std::vector<Index>& to_reordered){
+                            if(to_reordered.size() != graph.get_num_spins()){
+                                throw std::invalid_argument("ReorderedSparse: size of order is different from the number of spins.");
+                            }
+                            std::vector<Index> rows, cols;
+                            std::vector<FloatType> values;
+                            for(std::size_t i=0; i<graph.get_num_spins(); i++){
+                                for(auto&& j : graph.adj_nodes(i)){
+                                    if(i <= j){
+                                        rows.push_back(to_reordered[i]);
+                                        cols.push_back(to_reordered[j]);
+                                        values.push_back(graph.J(i, j));
+                                    }
+                                }
+                            }
+                            return Sparse<FloatType>(graph.get_num_spins(), rows.data(), cols.data(), values.data(), values.size());
+                        }
+
+                    template<typename GraphType>
+                        ReorderedSparse(const GraphType& graph, std::vector<Index>&& order, std::vector<Index>&& inverse)
+                        : Sparse<FloatType>(relabel(graph, inverse)), _to_original(std::move(order)), _to_reordered(std::move(inverse)){}
+
+                public:
+
+                    /**
+                     * @brief ReorderedSparse constructor with reverse Cuthill-McKee ordering
+                     *
+                     * @tparam GraphType type of graph (assume Dense, Sparse or derived class of them)
+                     * @param graph original graph
+                     */
+                    template<typename GraphType>
+                        explicit ReorderedSparse(const GraphType& graph)
+                        : ReorderedSparse(graph, reverse_cuthill_mckee(graph)){}
+
+                    /**
+                     * @brief ReorderedSparse constructor with a given ordering (e.g. from a graph partitioner)
+                     *
+                     * @tparam GraphType type of graph (assume Dense, Sparse or derived class of them)
+                     * @param graph original graph
+                     * @param order order[new index] = original index
+                     */
+                    template<typename GraphType>
+                        ReorderedSparse(const GraphType& graph, std::vector<Index> order)
+                        : ReorderedSparse(graph, std::move(order), invert(order)){}
+
+                    /**
+                     * @brief ReorderedSparse copy constructor
+                     */
+                    ReorderedSparse(const ReorderedSparse<FloatType>&) = default;
+
+                    /**
+                     * @brief ReorderedSparse move constructor
+                     */
+                    ReorderedSparse(ReorderedSparse<FloatType>&&) = default;
+
+                    /**
+                     * @brief get the ordering
+                     *
+                     * @return order[new index] = original index
+                     */
+                    const std::vector<Index>& get_order() const{
+                        return _to_original;
+                    }
+
+                    /**
+                     * @brief convert spins in the relabeled order into the original order
+                     *
+                     * @param spins spins indexed by relabeled indices
+                     *
+                     * @return spins indexed by original indices
+                     */
+                    Spins to_original(const Spins& spins) const{
+                        assert(spins.size() == this->get_num_spins());
+                        Spins ret(spins.size());
+                        for(std::size_t k=0; k<spins.size(); k++){
+                            ret[_to_original[k]] = spins[k];
+                        }
+                        return ret;
+                    }
+
+                    /**
+                     * @brief convert spins in the original order into the relabeled order (e.g. initial states)
+                     *
+                     * @param spins spins indexed by original indices
+                     *
+                     * @return spins indexed by relabeled indices
+                     */
+                    Spins to_reordered(const Spins& spins) const{
+                        assert(spins.size() == this->get_num_spins());
+                        Spins ret(spins.size());
+                        for(std::size_t i=0; i<spins.size(); i++){
+                            ret[_to_reordered[i]] = spins[i];
+                        }
+                        return ret;
+                    }
+            };
+    } // namespace graph
+} // namespace openjij
+
+#endif
@@ -18,9 +18,11 @@
 #include <algorithm>
 #include <cassert>
 #include <cstddef>
+#include <stdexcept>
 #include <type_traits>
 #include <utility>
 #include <unordered_map>
+#include <vector>
 
 #include <graph/graph.hpp>
 #include <utility/pairhash.hpp>
@@ -123,6 +125,75 @@ namespace openjij {
                      */
                     explicit Sparse(std::size_t num_spins) : Sparse(num_spins, num_spins){}
 
+                    /**
+                     * @brief Sparse constructor from COO (row, column, value) arrays
+                     *
+                     * The pairs (i, j) and (j, i) denote the same interaction and the diagonal denotes local fields.
+                     * Duplicate entries are summed up (as in scipy.sparse).
+                     * The entries are sorted natively and the upper limit of the number of edges per site is set to the maximum degree.
+                     * (adding further edges with J(i, j) afterwards is limited by this value as well)
+                     *
+                     * @tparam IndexType index type of the arrays
+                     * @tparam ValueType value type of the array
+                     * @param num_spins number of spins
+                     * @param rows row indices
+                     * @param cols column indices
+                     * @param values values
+                     * @param num_elements number of elements in each array
+                     */
+                    template<typename IndexType, typename ValueType>
+                    Sparse(std::size_t num_spins, const IndexType* rows, const IndexType* cols, const ValueType* values, std::size_t num_elements)
+                        : Graph(num_spins), _num_edges(0), _list_adj_nodes(num_spins){
+                            using Element = std::pair<std::pair<Index, Index>, FloatType>;
+                            std::vector<Element> elements;
+                            elements.reserve(num_elements);
+                            for(std::size_t k=0; k<num_elements; k++){
+                                //negative indices are mapped to large values by the conversion
+                                const Index i = static_cast<Index>(rows[k]);
+                                const Index j = static_cast<Index>(cols[k]);
+                                if(i >= num_spins || j >= num_spins){
+                                    throw std::invalid_argument("Sparse: index out of range.");
+                                }
+                                elements.emplace_back(std::make_pair(std::min(i, j), std::max(i, j)), static_cast<FloatType>(values[k]));
+                            }
+
+                            std::sort(elements.begin(), elements.end(),
+                                    [](const Element& a, const Element& b){return a.first < b.first;});
+
+                            //sum up duplicates
+                            std::size_t num_unique = 0;
+                            for(std::size_t k=0; k<elements.size(); k++){
+                                if(num_unique > 0 && elements[num_unique-1].first == elements[k].first){
+                                    elements[num_unique-1].second += elements[k].second;
+                                }
+                                else{
+                                    elements[num_unique++] = elements[k];
+                                }
+                            }
+                            elements.resize(num_unique);
+
+                            //count degrees
+                            std::vector<std::size_t> degrees(num_spins, 0);
+                            for(auto&& elem : elements){
+                                degrees[elem.first.first]++;
+                                if(elem.first.first != elem.first.second) degrees[elem.first.second]++;
+                            }
+                            for(std::size_t i=0; i<num_spins; i++){
+                                _list_adj_nodes[i].reserve(degrees[i]);
+                                _num_edges = std::max(_num_edges, degrees[i]);
+                            }
+
+                            //each pair is unique, so that no search is needed
+                            _J.reserve(elements.size());
+                            for(auto&& elem : elements){
+                                const Index i = elem.first.first;
+                                const Index j = elem.first.second;
+                                _J.emplace(elem.first, elem.second);
+                                _list_adj_nodes[i].push_back(j);
+                                if(i != j) _list_adj_nodes[j].push_back(i);
+                            }
+                        }
+
                     /**
                      * @brief Sparse copy constructor
                      *
@@ -15,10 +15,12 @@
 #ifndef OPENJIJ_GRAPH_SQUARE_HPP__
 #define OPENJIJ_GRAPH_SQUARE_HPP__
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include <graph/sparse.hpp>
 
@@ -189,14 +191,20 @@ namespace openjij {
                  *
                  * @return number of rows
                  */
-                std::size_t get_num_row(){return _num_row;}
+                std::size_t get_num_row() const{return _num_row;}
 
                 /**
                  * @brief get number of columns
                  *
                  * @return number of columns
                  */
-                std::size_t get_num_column(){return _num_column;}
+                std::size_t get_num_column() const{return _num_column;}
+
+                /**
+                 * @brief access J_{ij} and h_{i} by global indices (as in Sparse)
+                 */
+                using Sparse<FloatType>::J;
+                using Sparse<FloatType>::h;
 
                 /**
                  * @brief access J(row, colum, direction)
@@ -311,6 +319,112 @@ namespace openjij {
                 }
         };
 
+        /**
+         * @brief couplings of a square lattice stored in one array per direction (row-major, indexed by global index)
+         *
+         * Neighbors are taken periodically; a coupling is zero if the bond does not exist (e.g. open boundary).
+         * If the plus and minus neighbors coincide (two rows or columns), the bond is counted once (in the MINUS array),
+         * and a neighbor coinciding with the site itself (one row or column) is ignored.
+         *
+         * @tparam FloatType floating-point type
+         */
+        template<typename FloatType>
+        struct SquareCouplings{
+            using value_type = FloatType;
+
+            std::vector<FloatType> J_minus_r;
+            std::vector<FloatType> J_plus_r;
+            std::vector<FloatType> J_minus_c;
+            std::vector<FloatType> J_plus_c;
+            std::vector<FloatType> h;
+
+            /**
+             * @brief number of rows
+             */
+            std::size_t num_row;
+
+            /**
+             * @brief number of columns
+             */
+            std::size_t num_column;
+
+            /**
+             * @brief SquareCouplings constructor
+             *
+             * @param graph square lattice graph
+             */
+            explicit SquareCouplings(const Square<FloatType>& graph)
+                : J_minus_r(graph.get_num_spins(), 0), J_plus_r(graph.get_num_spins(), 0),
+                J_minus_c(graph.get_num_spins(), 0), J_plus_c(graph.get_num_spins(), 0),
+                h(graph.get_num_spins(), 0),
+                num_row(graph.get_num_row()), num_column(graph.get_num_column()){
+
+                    //coupling of an existing bond (zero otherwise)
+                    auto bond = [&graph](Index from, Index to) -> FloatType{
+                        if(from == to) return 0;
+                        const auto& nodes = graph.adj_nodes(from);
+                        return (std::find(nodes.begin(), nodes.end(), to) != nodes.end()) ? graph.J(from, to) : 0;
+                    };
+
+                    for(std::size_t r=0; r<num_row; r++){
+                        for(std::size_t c=0; c<num_column; c++){
+                            const Index ind = r*num_column + c;
+                            const Index mr = prev_row(r)*num_column + c;
+                            const Index pr = next_row(r)*num_column + c;
+                            const Index mc = r*num_column + prev_column(c);
+                            const Index pc = r*num_column + next_column(c);
+                            J_minus_r[ind] = bond(ind, mr);
+                            J_plus_r[ind]  = (pr != mr) ? bond(ind, pr) : 0;
+                            J_minus_c[ind] = bond(ind, mc);
+                            J_plus_c[ind]  = (pc != mc) ? bond(ind, pc) : 0;
+                            h[ind] = graph.h(ind);
+                        }
+                    }
+                }
+
+            /**
+             * @brief previous row (periodic)
+             */
+            std::size_t prev_row(std::size_t r) const{ return (r == 0) ? num_row-1 : r-1; }
+
+            /**
+             * @brief next row (periodic)
+             */
+            std::size_t next_row(std::size_t r) const{ return (r == num_row-1) ? 0 : r+1; }
+
+            /**
+             * @brief previous column (periodic)
+             */
+            std::size_t prev_column(std::size_t c) const{ return (c == 0) ? num_column-1 : c-1; }
+
+            /**
+             * @brief next column (periodic)
+             */
+            std::size_t next_column(std::size_t c) const{ return (c == num_column-1) ? 0 : c+1; }
+
+            /**
+             * @brief calculate local field of a spin (h_i + \sum_j J_{ij} s_j) with the five-point stencil
+             *
+             * @param r row index
+             * @param c column index
+             * @param spins spin configuration
+             *
+             * @return local field
+             */
+            FloatType local_field(std::size_t r, std::size_t c, const Spins& spins) const{
+                assert(spins.size() == num_row*num_column);
+                const Spin* row = spins.data() + r*num_column;
+                const Spin* row_m = spins.data() + prev_row(r)*num_column;
+                const Spin* row_p = spins.data() + next_row(r)*num_column;
+                const Index ind = r*num_column + c;
+                return h[ind]
+                    + J_minus_r[ind] * row_m[c]
+                    + J_plus_r[ind]  * row_p[c]
+                    + J_minus_c[ind] * row[prev_column(c)]
+                    + J_plus_c[ind]  * row[next_column(c)];
+            }
+        };
+
     } // namespace graph
 } // namespace openjij
 
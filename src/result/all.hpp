@@ -16,5 +16,6 @@
 #define OPENJIJ_RESULT_ALL_HPP__
 
 #include <result/get_solution.hpp>
+#include <result/energy.hpp>
 
 #endif
@@ -0,0 +1,203 @@
+//    Copyright 2019 Jij Inc.
+
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+
+//        http://www.apache.org/licenses/LICENSE-2.0
+
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+
+#ifndef OPENJIJ_RESULT_ENERGY_HPP__
+#define OPENJIJ_RESULT_ENERGY_HPP__
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include <graph/all.hpp>
+#include <utility/eigen.hpp>
+
+namespace openjij {
+    namespace result {
+
+        namespace energy_impl{
+
+            /**
+             * @brief number of threads actually used
+             *
+             * @param num_threads requested number of threads (0: hardware concurrency)
+             * @param num_tasks number of tasks
+             *
+             * @return number of threads (1 <= ret <= max(1, num_tasks))
+             */
+            inline std::size_t get_num_threads(std::size_t num_threads, std::size_t num_tasks){
+                if(num_threads == 0){
+                    num_threads = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+                }
+                return std::max<std::size_t>(1, std::min(num_threads, num_tasks));
+            }
+
+            /**
+             * @brief call func(task) for the tasks [0, num_tasks), split into contiguous ranges over the threads
+             */
+            template<typename Func>
+                inline void parallel_for(std::size_t num_tasks, std::size_t num_threads, const Func& func){
+                    num_threads = get_num_threads(num_threads, num_tasks);
+                    auto run = [&](std::size_t t){
+                        for(std::size_t task=num_tasks*t/num_threads; task<num_tasks*(t+1)/num_threads; task++){
+                            func(task);
+                        }
+                    };
+                    std::vector<std::thread> threads;
+                    for(std::size_t t=1; t<num_threads; t++){
+                        threads.emplace_back(run, t);
+                    }
+                    run(0);
+                    for(auto&& th : threads){
+                        th.join();
+                    }
+                }
+        } // namespace energy_impl
+
+        /**
+         * @brief calculate energies of many states at once (Dense graph)
+         *
+         * The states are processed in blocks of rows, and each block (with a dummy spin for the local fields)
+         * is multiplied by the interaction matrix as a GEMM, i.e. E = 1/2 rowsum((S J) * S).
+         * The blocks are distributed over the threads.
+         *
+         * @tparam FloatType floating-point type
+         * @param graph interactions
+         * @param states row-major num_states x num_spins matrix of spins (-1/+1)
+         * @param num_states number of states
+         * @param energies energies of the states (output, size: num_states)
+         * @param num_threads number of threads (0: hardware concurrency)
+         */
+        template<typename FloatType>
+            inline void calc_energies(const graph::Dense<FloatType>& graph, const std::int8_t* states, std::size_t num_states,
+                    FloatType* energies, std::size_t num_threads = 0){
+                using Matrix = Eigen::Matrix<FloatType, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+                using StateMatrix = Eigen::Matrix<std::int8_t, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+                using Vector = Eigen::Matrix<FloatType, Eigen::Dynamic, 1>;
+                const std::size_t num_spins = graph.get_num_spins();
+
+                //the dummy-dummy element is cleared (it would add 1/2 to every energy)
+                Matrix interaction = utility::gen_matrix_from_graph<Eigen::RowMajor>(graph);
+                interaction(num_spins, num_spins) = 0;
+
+                constexpr std::size_t block_size = 256;
+                const std::size_t num_blocks = (num_states + block_size - 1) / block_size;
+                energy_impl::parallel_for(num_blocks, num_threads, [&](std::size_t b){
+                        const std::size_t begin = b*block_size;
+                        const std::size_t rows = std::min(block_size, num_states - begin);
+                        Matrix spins(rows, num_spins+1);
+                        spins.leftCols(num_spins) = Eigen::Map<const StateMatrix>(states + begin*num_spins, rows, num_spins).template cast<FloatType>();
+                        spins.col(num_spins).setOnes();
+                        const Matrix product = spins * interaction;
+                        Eigen::Map<Vector>(energies + begin, rows) = FloatType(0.5) * product.cwiseProduct(spins).rowwise().sum();
+                        });
+            }
+
+        /**
+         * @brief calculate energies of many states at once (CSRSparse graph)
+         *
+         * The states are distributed over the threads.
+         * If there are fewer states than threads, the rows of each state are split into chunks as well.
+         *
+         * @tparam FloatType floating-point type
+         * @param graph interactions
+         * @param states row-major num_states x num_spins matrix of spins (-1/+1)
+         * @param num_states number of states
+         * @param energies energies of the states (output, size: num_states)
+         * @param num_threads number of threads (0: hardware concurrency)
+         */
+        template<typename FloatType>
+            inline void calc_energies(const graph::CSRSparse<FloatType>& graph, const std::int8_t* states, std::size_t num_states,
+                    FloatType* energies, std::size_t num_threads = 0){
+                const std::size_t num_spins = graph.get_num_spins();
+                if(num_states == 0) return;
+
+                num_threads = energy_impl::get_num_threads(num_threads, num_states * std::max<std::size_t>(1, num_spins));
+                const std::size_t num_chunks = std::max<std::size_t>(1, std::min(num_spins, num_threads / num_states));
+
+                const std::size_t* row_offsets = graph.row_offsets();
+                const auto* edges = graph.edges();
+                const FloatType* h = graph.fields();
+                std::vector<FloatType> partial(num_states*num_chunks);
+                energy_impl::parallel_for(num_states*num_chunks, num_threads, [&](std::size_t task){
+                        const std::size_t s = task / num_chunks;
+                        const std::size_t c = task % num_chunks;
+                        const std::int8_t* spins = states + s*num_spins;
+                        FloatType ret = 0;
+                        for(std::size_t i=num_spins*c/num_chunks; i<num_spins*(c+1)/num_chunks; i++){
+                            FloatType local = 0;
+                            for(std::size_t k=row_offsets[i]; k<row_offsets[i+1]; k++){
+                                local += edges[k].value * spins[edges[k].index];
+                            }
+                            ret += ((1./2) * local + h[i]) * spins[i];
+                        }
+                        partial[task] = ret;
+                        });
+
+                for(std::size_t s=0; s<num_states; s++){
+                    FloatType ret = 0;
+                    for(std::size_t c=0; c<num_chunks; c++){
+                        ret += partial[s*num_chunks + c];
+                    }
+                    energies[s] = ret;
+                }
+            }
+
+        /**
+         * @brief calculate energies of many states at once (Sparse graph, frozen into CSR layout first)
+         *
+         * @tparam FloatType floating-point type
+         * @param graph interactions
+         * @param states row-major num_states x num_spins matrix of spins (-1/+1)
+         * @param num_states number of states
+         * @param energies energies of the states (output, size: num_states)
+         * @param num_threads number of threads (0: hardware concurrency)
+         */
+        template<typename FloatType>
+            inline void calc_energies(const graph::Sparse<FloatType>& graph, const std::int8_t* states, std::size_t num_states,
+                    FloatType* energies, std::size_t num_threads = 0){
+                calc_energies(graph::CSRSparse<FloatType>(graph), states, num_states, energies, num_threads);
+            }
+
+        /**
+         * @brief calculate energies of many states at once
+         *
+         * @tparam GraphType type of graph (Dense, Sparse or CSRSparse)
+         * @param graph interactions
+         * @param states list of spins
+         * @param num_threads number of threads (0: hardware concurrency)
+         *
+         * @return energies of the states
+         */
+        template<typename GraphType>
+            inline std::vector<typename GraphType::value_type> calc_energies(const GraphType& graph, const std::vector<graph::Spins>& states, std::size_t num_threads = 0){
+                const std::size_t num_spins = graph.get_num_spins();
+                std::vector<std::int8_t> packed(states.size()*num_spins);
+                for(std::size_t s=0; s<states.size(); s++){
+                    assert(states[s].size() == num_spins);
+                    std::copy(states[s].begin(), states[s].end(), packed.begin() + s*num_spins);
+                }
+                std::vector<typename GraphType::value_type> energies(states.size());
+                calc_energies(graph, packed.data(), states.size(), energies.data(), num_threads);
+                return energies;
+            }
+
+    } // namespace result
+} // namespace openjij
+
+#endif
@@ -20,6 +20,7 @@
 #include <algorithm>
 #include <cmath>
 #include <limits>
+#include <utility>
 
 #ifdef USE_CUDA
 #include <utility/gpu/memory.hpp>
@@ -73,7 +74,7 @@ namespace openjij {
             double energy = 0.0;
             double min_energy = std::numeric_limits<double>::max();
             for (std::size_t t=0; t<system.trotter_spins.size(); t++){
-                energy = system.interaction.calc_energy(system.trotter_spins[t]);
+                energy = system.interaction->calc_energy(system.trotter_spins[t]);
                 if(energy < min_energy){
                     mininum_trotter = t;
                     min_energy = energy;
@@ -101,7 +102,7 @@ namespace openjij {
             std::size_t num_trotter_slices = system.trotter_spins.cols();
             for (std::size_t t=0; t<num_trotter_slices; t++){
                 // calculate classical energy in each classical spin
-                energy = spins.col(t).transpose() * system.interaction * spins.col(t);
+                energy = spins.col(t).transpose() * (*system.interaction) * spins.col(t);
                 if(energy < min_energy){
                     minimum_trotter = t;
                     min_energy = energy;
@@ -117,6 +118,125 @@ namespace openjij {
         }
 
 
+        /**
+         * @brief get solution of classical system with polynomial interactions
+         *
+         * @tparam GraphType graph type
+         * @param system classical system with polynomial interactions
+         *
+         * @return solution (-1/+1 for SPIN, 0/1 for BINARY)
+         */
+        template<typename GraphType>
+        const graph::Spins get_solution(const system::ClassicalIsingPolynomial<GraphType>& system){
+            return system.spin;
+        }
+
+        /**
+         * @brief get solution of classical ising system with bit-packed spins
+         *
+         * @tparam GraphType graph type
+         * @param system classical ising system with bit-packed spins
+         *
+         * @return solution (unpacked)
+         */
+        template<typename GraphType>
+        const graph::Spins get_solution(const system::ClassicalIsingPacked<GraphType>& system){
+            return system.spin.to_spins();
+        }
+
+        /**
+         * @brief get solution of transverse ising system with bit-packed trotter spins
+         *
+         * @tparam GraphType graph type
+         * @param system transverse ising system with bit-packed trotter spins
+         *
+         * @return solution (unpacked trotter slice with the minimum energy)
+         */
+        template<typename GraphType>
+        const graph::Spins get_solution(const system::TransverseIsingPacked<GraphType>& system){
+            graph::Spins minimum_spins;
+            double min_energy = std::numeric_limits<double>::max();
+            for (auto&& packed : system.trotter_spins){
+                auto spins = packed.to_spins();
+                const double energy = system.interaction.calc_energy(spins);
+                if(energy < min_energy){
+                    min_energy = energy;
+                    minimum_spins = std::move(spins);
+                }
+            }
+            return minimum_spins;
+        }
+
+        /**
+         * @brief get solutions of all the replicas of a multi-spin coded classical ising system
+         *
+         * @tparam GraphType graph type
+         * @param system multi-spin coded classical ising system
+         *
+         * @return solutions (size: num_replicas)
+         */
+        template<typename GraphType>
+        const std::vector<graph::Spins> get_solution(const system::MultiSpinClassicalIsing<GraphType>& system){
+            std::vector<graph::Spins> ret;
+            for(std::size_t r=0; r<system::MultiSpinClassicalIsing<GraphType>::num_replicas; r++){
+                ret.push_back(system.get_replica(r));
+            }
+            return ret;
+        }
+
+        /**
+         * @brief get solutions of all the replicas of a batched classical ising system
+         *
+         * @tparam GraphType graph type
+         * @param system batched classical ising system
+         *
+         * @return solutions (size: num_replicas)
+         */
+        template<typename GraphType>
+        const std::vector<graph::Spins> get_solution(const system::BatchedClassicalIsing<GraphType>& system){
+            std::vector<graph::Spins> ret;
+            for(std::size_t r=0; r<system.num_replicas; r++){
+                ret.push_back(system.get_replica(r));
+            }
+            return ret;
+        }
+
+        /**
+         * @brief get solution of classical ising system on a reordered graph (original labels)
+         *
+         * @tparam FloatType floating-point type
+         * @param system classical ising system without Eigen implementation
+         *
+         * @return solution
+         */
+        template<typename FloatType>
+        const graph::Spins get_solution(const system::ClassicalIsing<graph::ReorderedSparse<FloatType>, false>& system){
+            return system.interaction->to_original(system.spin);
+        }
+
+        /**
+         * @brief get solution of transverse ising system on a reordered graph (original labels)
+         *
+         * @tparam FloatType floating-point type
+         * @param system transverse ising system without Eigen implementation
+         *
+         * @return solution
+         */
+        template<typename FloatType>
+        const graph::Spins get_solution(const system::TransverseIsing<graph::ReorderedSparse<FloatType>, false>& system){
+            std::size_t mininum_trotter = 0;
+            double energy = 0.0;
+            double min_energy = std::numeric_limits<double>::max();
+            for (std::size_t t=0; t<system.trotter_spins.size(); t++){
+                energy = system.interaction->calc_energy(system.trotter_spins[t]);
+                if(energy < min_energy){
+                    mininum_trotter = t;
+                    min_energy = energy;
+                }
+            }
+            return system.interaction->to_original(system.trotter_spins[mininum_trotter]);
+        }
+
      	/**
          * @brief get solution of continuous time Ising system
          *
@@ -21,6 +21,13 @@
 #include <system/classical_ising.hpp>
 #include <system/transverse_ising.hpp>
 #include <system/continuous_time_ising.hpp>
+#include <system/classical_ising_polynomial.hpp>
+#include <system/packed_ising.hpp>
+#include <system/multi_spin_classical_ising.hpp>
+#include <system/batched_classical_ising.hpp>
+#include <system/update_interaction.hpp>
+#include <system/prepared_problem.hpp>
+#include <system/state_io.hpp>
 
 #ifdef USE_CUDA
 #include <system/gpu/chimera_gpu_transverse.hpp>
@@ -0,0 +1,160 @@
+//    Copyright 2019 Jij Inc.
+
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+
+//        http://www.apache.org/licenses/LICENSE-2.0
+
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+
+#ifndef OPENJIJ_SYSTEM_BATCHED_CLASSICAL_ISING_HPP__
+#define OPENJIJ_SYSTEM_BATCHED_CLASSICAL_ISING_HPP__
+
+#include <cassert>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include <system/system.hpp>
+#include <graph/all.hpp>
+
+namespace openjij {
+    namespace system {
+
+        /**
+         * @brief classical ising system holding many replicas in structure-of-arrays layout
+         *
+         * spin[i*num_replicas + r] is the spin i of the replica r, so that the replicas of a spin are contiguous
+         * and one coupling row serves all of them.
+         * The couplings are copied once into CSR arrays.
+         *
+         * @tparam GraphType type of graph (assume Dense, Sparse or derived class of them)
+         */
+        template<typename GraphType>
+            struct BatchedClassicalIsing{
+                using system_type = classical_system;
+                using FloatType = typename GraphType::value_type;
+
+                /**
+                 * @brief Constructor to initialize spins of the replicas and interaction
+                 *
+                 * @param init_spins initial spins of the replicas
+                 * @param init_interaction interactions
+                 */
+                BatchedClassicalIsing(const std::vector<graph::Spins>& init_spins, const GraphType& init_interaction)
+                    : num_spins(init_interaction.get_num_spins()), num_replicas(init_spins.size()){
+                        if(num_replicas == 0){
+                            throw std::invalid_argument("at least one replica is required.");
+                        }
+                        row_offsets.push_back(0);
+                        for(std::size_t i=0; i<num_spins; i++){
+                            FloatType h = 0;
+                            for(auto&& j : init_interaction.adj_nodes(i)){
+                                if(i == j){
+                                    h = init_interaction.h(i);
+                                    continue;
+                                }
+                                const FloatType value = init_interaction.J(i, j);
+                                if(value == 0) continue;
+                                adj_indices.push_back(j);
+                                adj_values.push_back(value);
+                            }
+                            fields.push_back(h);
+                            row_offsets.push_back(adj_indices.size());
+                        }
+                        reset_spins(init_spins);
+                    }
+
+                /**
+                 * @brief reset spins of the replicas
+                 *
+                 * @param init_spins initial spins of the replicas (size: num_replicas)
+                 */
+                void reset_spins(const std::vector<graph::Spins>& init_spins){
+                    if(init_spins.size() != num_replicas){
+                        throw std::invalid_argument("the number of initial states must be equal to num_replicas.");
+                    }
+                    spin.resize(num_spins*num_replicas);
+                    for(std::size_t r=0; r<num_replicas; r++){
+                        assert(init_spins[r].size() == num_spins);
+                        for(std::size_t i=0; i<num_spins; i++){
+                            spin[i*num_replicas + r] = init_spins[r][i];
+                        }
+                    }
+                }
+
+                /**
+                 * @brief get spins of a replica
+                 *
+                 * @param replica replica index
+                 *
+                 * @return spins
+                 */
+                graph::Spins get_replica(std::size_t replica) const{
+                    assert(replica < num_replicas);
+                    graph::Spins ret(num_spins);
+                    for(std::size_t i=0; i<num_spins; i++){
+                        ret[i] = static_cast<graph::Spin>(spin[i*num_replicas + replica]);
+                    }
+                    return ret;
+                }
+
+                /**
+                 * @brief spins of the replicas (-1/+1, size: num_spins*num_replicas)
+                 */
+                std::vector<FloatType> spin;
+
+                /**
+                 * @brief number of real spins
+                 */
+                const std::size_t num_spins;
+
+                /**
+                 * @brief number of replicas
+                 */
+                const std::size_t num_replicas;
+
+                /**
+                 * @brief neighbors of spin i are [row_offsets[i], row_offsets[i+1])
+                 */
+                std::vector<std::size_t> row_offsets;
+
+                /**
+                 * @brief indices of the neighbors
+                 */
+                std::vector<std::size_t> adj_indices;
+
+                /**
+                 * @brief interactions with the neighbors
+                 */
+                std::vector<FloatType> adj_values;
+
+                /**
+                 * @brief local fields
+                 */
+                std::vector<FloatType> fields;
+            };
+
+        /**
+         * @brief helper function for BatchedClassicalIsing constructor
+         *
+         * @tparam GraphType
+         * @param init_spins initial spins of the replicas
+         * @param init_interaction initial interaction
+         *
+         * @return generated object
+         */
+        template<typename GraphType>
+            BatchedClassicalIsing<GraphType> make_batched_classical_ising(const std::vector<graph::Spins>& init_spins, const GraphType& init_interaction){
+                return BatchedClassicalIsing<GraphType>(init_spins, init_interaction);
+            }
+
+    } // namespace system
+} // namespace openjij
+
+#endif
@@ -16,7 +16,9 @@
 #define OPENJIJ_SYSTEM_CLASSICAL_ISING_HPP__
 
 #include <cassert>
+#include <memory>
 #include <utility>
+#include <vector>
 #include <system/system.hpp>
 #include <graph/all.hpp>
 #include <utility/eigen.hpp>
@@ -39,6 +41,7 @@ namespace openjij {
                 static_assert(!eigen_impl, "Eigen implementation is not supported.");
 
                 using system_type = classical_system;
+                using FloatType = typename GraphType::value_type;
 
                 /**
                  * @brief Constructor to initialize spin and interaction
@@ -47,8 +50,17 @@ namespace openjij {
                  * @param interaction
                  */
                 ClassicalIsing(const graph::Spins& init_spin, const GraphType& init_interaction)
-                    : spin{init_spin}, interaction{init_interaction}, num_spins{init_spin.size()} {
-                        assert(init_spin.size() == init_interaction.get_num_spins());
+                    : ClassicalIsing(init_spin, make_shared_interaction(init_interaction)) {}
+
+                /**
+                 * @brief Constructor to initialize spin with an interaction shared by other systems (couplings are not copied)
+                 *
+                 * @param spin
+                 * @param interaction
+                 */
+                ClassicalIsing(const graph::Spins& init_spin, SharedInteraction<GraphType> init_interaction)
+                    : spin{init_spin}, interaction{std::move(init_interaction)}, num_spins{init_spin.size()} {
+                        assert(init_spin.size() == interaction->get_num_spins());
                     }
 
                 /**
@@ -58,14 +70,88 @@ namespace openjij {
                  */
                 void reset_spins(const graph::Spins& init_spin){
                     this->spin = init_spin;
+                    invalidate_local_fields();
+                }
+
+                /**
+                 * @brief mark the cached local fields as stale (call after changing spin or interaction directly)
+                 */
+                void invalidate_local_fields(){
+                    local_fields_valid = false;
+                }
+
+                /**
+                 * @brief recompute the local fields and the energy from scratch
+                 * (graph must provide adj_nodes, i.e. Dense, Sparse or derived class of them)
+                 */
+                void refresh_local_fields(){
+                    local_field.assign(num_spins, 0);
+                    energy = 0;
+                    for(std::size_t i=0; i<num_spins; i++){
+                        FloatType field = 0;
+                        FloatType h = 0;
+                        for(auto&& j : interaction->adj_nodes(i)){
+                            if(i != j) field += interaction->J(i, j) * spin[j];
+                            else h = interaction->h(i);
+                        }
+                        local_field[i] = field + h;
+                        energy += (field/2 + h) * spin[i];
+                    }
+                    local_fields_valid = true;
+                }
+
+                /**
+                 * @brief energy difference when the spin is flipped (local fields must be valid)
+                 *
+                 * @param index spin
+                 *
+                 * @return energy difference
+                 */
+                FloatType energy_difference(std::size_t index) const{
+                    assert(local_fields_valid);
+                    return -2 * spin[index] * local_field[index];
+                }
+
+                /**
+                 * @brief flip the spin and update the local fields of its neighbors (local fields must be valid)
+                 *
+                 * @param index spin
+                 */
+                void flip(std::size_t index){
+                    assert(local_fields_valid);
+                    energy += energy_difference(index);
+                    const FloatType diff = -2 * spin[index];
+                    for(auto&& j : interaction->adj_nodes(index)){
+                        if(index != j) local_field[j] += interaction->J(index, j) * diff;
+                    }
+                    spin[index] *= -1;
                 }
 
                 graph::Spins spin;
-                const GraphType interaction;
+
+                /**
+                 * @brief interaction (shared by the copies of this system)
+                 */
+                SharedInteraction<GraphType> interaction;
                 /**
                  * @brief number of real spins (dummy spin excluded)
                  */
                 const std::size_t num_spins; //spin.size()
+
+                /**
+                 * @brief cached local fields h_i + \sum_j J_{ij} s_j, maintained by the single spin flip updater
+                 */
+                std::vector<FloatType> local_field;
+
+                /**
+                 * @brief total energy of the current spins (valid together with local_field)
+                 */
+                FloatType energy = 0;
+
+                /**
+                 * @brief whether local_field and energy match the current spins and interaction
+                 */
+                bool local_fields_valid = false;
             };
 
         //TODO: unify Dense and Sparse Eigen-implemented ClassicalIsing struct
@@ -92,11 +178,24 @@ namespace openjij {
                  */
                 ClassicalIsing(const graph::Spins& init_spin, const graph::Dense<FloatType>& init_interaction)
                     : spin(utility::gen_vector_from_std_vector<FloatType, Eigen::ColMajor>(init_spin)),
-                    interaction(utility::gen_matrix_from_graph<Eigen::RowMajor>(init_interaction)),
+                    interaction(make_shared_interaction<MatrixXx>(utility::gen_matrix_from_graph<Eigen::RowMajor>(init_interaction))),
                     num_spins(init_interaction.get_num_spins()){
                         assert(init_spin.size() == init_interaction.get_num_spins());
                     }
 
+                /**
+                 * @brief Constructor to initialize spin with an interaction matrix shared by other systems
+                 *
+                 * @param spin
+                 * @param interaction interaction matrix with the dummy spin (num_spins+1 x num_spins+1)
+                 */
+                ClassicalIsing(const graph::Spins& init_spin, SharedInteraction<MatrixXx> init_interaction)
+                    : spin(utility::gen_vector_from_std_vector<FloatType, Eigen::ColMajor>(init_spin)),
+                    interaction(std::move(init_interaction)),
+                    num_spins(init_spin.size()){
+                        assert(static_cast<std::size_t>(interaction->rows()) == num_spins+1);
+                    }
+
                 /**
                  * @brief reset spins
                  *
@@ -104,15 +203,77 @@ namespace openjij {
                  */
                 void reset_spins(const graph::Spins& init_spin){
                     this->spin = utility::gen_vector_from_std_vector<FloatType, Eigen::ColMajor>(init_spin);
+                    invalidate_local_fields();
+                }
+
+                /**
+                 * @brief mark the cached local fields as stale (call after changing spin or interaction directly)
+                 */
+                void invalidate_local_fields(){
+                    local_fields_valid = false;
+                }
+
+                /**
+                 * @brief recompute the local fields and the energy from scratch
+                 */
+                void refresh_local_fields(){
+                    local_field = *interaction * spin;
+                    //the dummy-dummy element (=1) is not a part of the energy
+                    energy = (spin.dot(local_field) - interaction->coeff(num_spins, num_spins)) / 2;
+                    local_fields_valid = true;
+                }
+
+                /**
+                 * @brief energy difference when the spin is flipped (local fields must be valid)
+                 *
+                 * @param index spin
+                 *
+                 * @return energy difference
+                 */
+                FloatType energy_difference(std::size_t index) const{
+                    assert(local_fields_valid);
+                    return -2 * spin(index) * local_field(index);
+                }
+
+                /**
+                 * @brief flip the spin and update the local fields of its neighbors (local fields must be valid)
+                 *
+                 * @param index spin
+                 */
+                void flip(std::size_t index){
+                    assert(local_fields_valid);
+                    assert(index < num_spins);
+                    energy += energy_difference(index);
+                    local_field += (-2 * spin(index)) * interaction->row(index).transpose();
+                    spin(index) *= -1;
                 }
 
                 VectorXx spin;
-                const MatrixXx interaction;
+
+                /**
+                 * @brief interaction matrix (shared by the copies of this system)
+                 */
+                SharedInteraction<MatrixXx> interaction;
 
                 /**
                  * @brief number of real spins (dummy spin excluded)
                  */
                 const std::size_t num_spins; //spin.size()-1
+
+                /**
+                 * @brief cached local fields (interaction * spin), maintained by the single spin flip updater
+                 */
+                VectorXx local_field;
+
+                /**
+                 * @brief total energy of the current spins (valid together with local_field)
+                 */
+                FloatType energy = 0;
+
+                /**
+                 * @brief whether local_field and energy match the current spins and interaction
+                 */
+                bool local_fields_valid = false;
             };
 
         /**
@@ -137,11 +298,24 @@ namespace openjij {
                  */
                 ClassicalIsing(const graph::Spins& init_spin, const graph::Sparse<FloatType>& init_interaction)
                     : spin(utility::gen_vector_from_std_vector<FloatType, Eigen::ColMajor>(init_spin)),
-                    interaction(utility::gen_matrix_from_graph<Eigen::RowMajor>(init_interaction)),
+                    interaction(make_shared_interaction<SparseMatrixXx>(utility::gen_matrix_from_graph<Eigen::RowMajor>(init_interaction))),
                     num_spins(init_interaction.get_num_spins()){
                         assert(init_spin.size() == init_interaction.get_num_spins());
                     }
 
+                /**
+                 * @brief Constructor to initialize spin with an interaction matrix shared by other systems
+                 *
+                 * @param spin
+                 * @param interaction interaction matrix with the dummy spin (num_spins+1 x num_spins+1)
+                 */
+                ClassicalIsing(const graph::Spins& init_spin, SharedInteraction<SparseMatrixXx> init_interaction)
+                    : spin(utility::gen_vector_from_std_vector<FloatType, Eigen::ColMajor>(init_spin)),
+                    interaction(std::move(init_interaction)),
+                    num_spins(init_spin.size()){
+                        assert(static_cast<std::size_t>(interaction->rows()) == num_spins+1);
+                    }
+
                 /**
                  * @brief reset spins
                  *
@@ -149,17 +323,235 @@ namespace openjij {
                  */
                 void reset_spins(const graph::Spins& init_spin){
                     this->spin = utility::gen_vector_from_std_vector<FloatType, Eigen::ColMajor>(init_spin);
+                    invalidate_local_fields();
+                }
+
+                /**
+                 * @brief mark the cached local fields as stale (call after changing spin or interaction directly)
+                 */
+                void invalidate_local_fields(){
+                    local_fields_valid = false;
+                }
+
+                /**
+                 * @brief recompute the local fields and the energy from scratch
+                 */
+                void refresh_local_fields(){
+                    local_field = *interaction * spin;
+                    //the dummy-dummy element (=1) is not a part of the energy
+                    energy = (spin.dot(local_field) - interaction->coeff(num_spins, num_spins)) / 2;
+                    local_fields_valid = true;
+                }
+
+                /**
+                 * @brief energy difference when the spin is flipped (local fields must be valid)
+                 *
+                 * @param index spin
+                 *
+                 * @return energy difference
+                 */
+                FloatType energy_difference(std::size_t index) const{
+                    assert(local_fields_valid);
+                    return -2 * spin(index) * local_field(index);
+                }
+
+                /**
+                 * @brief flip the spin and update the local fields of its neighbors (local fields must be valid)
+                 *
+                 * @param index spin
+                 */
+                void flip(std::size_t index){
+                    assert(local_fields_valid);
+                    assert(index < num_spins);
+                    energy += energy_difference(index);
+                    local_field += (-2 * spin(index)) * interaction->row(index).transpose();
+                    spin(index) *= -1;
                 }
 
                 VectorXx spin;
-                const SparseMatrixXx interaction;
+
+                /**
+                 * @brief interaction matrix (shared by the copies of this system)
+                 */
+                SharedInteraction<SparseMatrixXx> interaction;
 
                 /**
                  * @brief number of real spins (dummy spin excluded)
                  */
                 const std::size_t num_spins; //spin.size()-1
+
+                /**
+                 * @brief cached local fields (interaction * spin), maintained by the single spin flip updater
+                 */
+                VectorXx local_field;
+
+                /**
+                 * @brief total energy of the current spins (valid together with local_field)
+                 */
+                FloatType energy = 0;
+
+                /**
+                 * @brief whether local_field and energy match the current spins and interaction
+                 */
+                bool local_fields_valid = false;
+            };
+
+        /**
+         * @brief ClassicalIsing structure for Chimera graph (no Eigen implementation)
+         *
+         * The couplings are copied once into per-direction arrays, so that updaters need neither hashing nor adjacency lists.
+         *
+         * @tparam FloatType type of floating-point
+         */
+        template<typename FloatType>
+            struct ClassicalIsing<graph::Chimera<FloatType>, false>{
+                using system_type = classical_system;
+
+                /**
+                 * @brief Constructor to initialize spin and interaction
+                 *
+                 * @param spin
+                 * @param interaction
+                 */
+                ClassicalIsing(const graph::Spins& init_spin, const graph::Chimera<FloatType>& init_interaction)
+                    : spin{init_spin}, interaction{init_interaction}, couplings{init_interaction}, num_spins{init_spin.size()} {
+                        assert(init_spin.size() == init_interaction.get_num_spins());
+                    }
+
+                /**
+                 * @brief reset spins
+                 *
+                 * @param init_spin
+                 */
+                void reset_spins(const graph::Spins& init_spin){
+                    this->spin = init_spin;
+                }
+
+                graph::Spins spin;
+                const graph::Chimera<FloatType> interaction;
+
+                /**
+                 * @brief couplings in per-direction arrays
+                 */
+                const graph::ChimeraCouplings<FloatType> couplings;
+
+                /**
+                 * @brief number of real spins (dummy spin excluded)
+                 */
+                const std::size_t num_spins; //spin.size()
+            };
+
+        /**
+         * @brief ClassicalIsing structure for Square graph (no Eigen implementation)
+         *
+         * The couplings are copied once into direction-indexed arrays for stencil sweeps.
+         *
+         * @tparam FloatType type of floating-point
+         */
+        template<typename FloatType>
+            struct ClassicalIsing<graph::Square<FloatType>, false>{
+                using system_type = classical_system;
+
+                /**
+                 * @brief Constructor to initialize spin and interaction
+                 *
+                 * @param spin
+                 * @param interaction
+                 */
+                ClassicalIsing(const graph::Spins& init_spin, const graph::Square<FloatType>& init_interaction)
+                    : spin{init_spin}, interaction{init_interaction}, couplings{init_interaction}, num_spins{init_spin.size()} {
+                        assert(init_spin.size() == init_interaction.get_num_spins());
+                    }
+
+                /**
+                 * @brief reset spins
+                 *
+                 * @param init_spin
+                 */
+                void reset_spins(const graph::Spins& init_spin){
+                    this->spin = init_spin;
+                }
+
+                graph::Spins spin;
+                const graph::Square<FloatType> interaction;
+
+                /**
+                 * @brief couplings in direction-indexed arrays
+                 */
+                const graph::SquareCouplings<FloatType> couplings;
+
+                /**
+                 * @brief number of real spins (dummy spin excluded)
+                 */
+                const std::size_t num_spins; //spin.size()
             };
 
+        /**
+         * @brief ClassicalIsing structure for King's graph (no Eigen implementation)
+         *
+         * The couplings are copied once into direction-indexed arrays for stencil sweeps.
+         *
+         * @tparam FloatType type of floating-point
+         */
+        template<typename FloatType>
+            struct ClassicalIsing<graph::KingGraph<FloatType>, false>{
+                using system_type = classical_system;
+
+                /**
+                 * @brief Constructor to initialize spin and interaction
+                 *
+                 * @param spin
+                 * @param interaction
+                 */
+                ClassicalIsing(const graph::Spins& init_spin, const graph::KingGraph<FloatType>& init_interaction)
+                    : spin{init_spin}, interaction{init_interaction}, couplings{init_interaction}, num_spins{init_spin.size()} {
+                        assert(init_spin.size() == init_interaction.get_num_spins());
+                    }
+
+                /**
+                 * @brief reset spins
+                 *
+                 * @param init_spin
+                 */
+                void reset_spins(const graph::Spins& init_spin){
+                    this->spin = init_spin;
+                }
+
+                graph::Spins spin;
+                const graph::KingGraph<FloatType> interaction;
+
+                /**
+                 * @brief couplings in direction-indexed arrays
+                 */
+                const graph::KingCouplings<FloatType> couplings;
+
+                /**
+                 * @brief number of real spins (dummy spin excluded)
+                 */
+                const std::size_t num_spins; //spin.size()
+            };
+
+        namespace classical_ising_impl{
+            template<typename System>
+                inline auto invalidate_local_fields(System& system, int) -> decltype(system.invalidate_local_fields(), void()){
+                    system.invalidate_local_fields();
+                }
+
+            template<typename System>
+                inline void invalidate_local_fields(System&, long){}
+        } // namespace classical_ising_impl
+
+        /**
+         * @brief mark the cached local fields of a system as stale (no-op for systems without the cache)
+         *
+         * @tparam System system type
+         * @param system system whose spin or interaction has been changed directly
+         */
+        template<typename System>
+            inline void invalidate_local_fields(System& system){
+                classical_ising_impl::invalidate_local_fields(system, 0);
+            }
+
         /**
          * @brief helper function for ClassicalIsing constructor
          *
@@ -175,6 +567,20 @@ namespace openjij {
                 return ClassicalIsing<GraphType, eigen_impl>(init_spin, init_interaction);
             }
 
+        /**
+         * @brief helper function for ClassicalIsing constructor with a shared interaction
+         *
+         * @tparam GraphType
+         * @param init_spin initial spin
+         * @param init_interaction interaction shared with other systems
+         *
+         * @return generated object
+         */
+        template<typename GraphType>
+            ClassicalIsing<GraphType, false> make_classical_ising(const graph::Spins& init_spin, SharedInteraction<GraphType> init_interaction){
+                return ClassicalIsing<GraphType, false>(init_spin, std::move(init_interaction));
+            }
+
 
 
     } // namespace system
@@ -0,0 +1,177 @@
+//    Copyright 2019 Jij Inc.
+
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+
+//        http://www.apache.org/licenses/LICENSE-2.0
+
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+
+#ifndef OPENJIJ_SYSTEM_CLASSICAL_ISING_POLYNOMIAL_HPP__
+#define OPENJIJ_SYSTEM_CLASSICAL_ISING_POLYNOMIAL_HPP__
+
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+#include <system/system.hpp>
+#include <graph/polynomial.hpp>
+
+namespace openjij {
+    namespace system {
+
+        /**
+         * @brief classical system with polynomial (higher-order) interactions
+         *
+         * A per-term state is kept up to date, so that the energy difference of a flip and the flip itself
+         * cost only the terms containing the variable:
+         * SPIN: product of the spins in the term (+1 or -1),
+         * BINARY: number of variables in the term that are zero.
+         *
+         * @tparam GraphType type of graph (assume Polynomial)
+         */
+        template<typename GraphType>
+            struct ClassicalIsingPolynomial{
+                using system_type = classical_system;
+                using FloatType = typename GraphType::value_type;
+
+                /**
+                 * @brief Constructor to initialize spin and interaction
+                 *
+                 * @param init_spin initial variables (-1/+1 for SPIN, 0/1 for BINARY)
+                 * @param init_interaction polynomial interactions
+                 * @param vartype type of variables
+                 */
+                ClassicalIsingPolynomial(const graph::Spins& init_spin, const GraphType& init_interaction, graph::Vartype vartype)
+                    : spin{init_spin}, interaction{init_interaction}, vartype{vartype}, num_spins{init_spin.size()} {
+                        assert(init_spin.size() == init_interaction.get_num_spins());
+                        reset_term_state();
+                    }
+
+                /**
+                 * @brief reset spins
+                 *
+                 * @param init_spin
+                 */
+                void reset_spins(const graph::Spins& init_spin){
+                    assert(init_spin.size() == num_spins);
+                    this->spin = init_spin;
+                    reset_term_state();
+                }
+
+                /**
+                 * @brief energy difference when the variable is flipped
+                 *
+                 * @param index variable
+                 *
+                 * @return energy difference
+                 */
+                FloatType energy_difference(std::size_t index) const{
+                    const auto& offsets = interaction.incidence_offsets();
+                    const auto& incidence = interaction.incidence();
+                    const auto& coeffs = interaction.coeffs();
+                    FloatType sum = 0;
+                    if(vartype == graph::Vartype::SPIN){
+                        for(std::size_t k=offsets[index]; k<offsets[index+1]; k++){
+                            const std::size_t t = incidence[k];
+                            sum += coeffs[t] * term_state[t];
+                        }
+                        return -2 * sum;
+                    }
+                    else{
+                        //the other variables of the term are all one
+                        const std::size_t own_zero = (spin[index] == 0) ? 1 : 0;
+                        for(std::size_t k=offsets[index]; k<offsets[index+1]; k++){
+                            const std::size_t t = incidence[k];
+                            if(static_cast<std::size_t>(term_state[t]) == own_zero) sum += coeffs[t];
+                        }
+                        return (1 - 2*spin[index]) * sum;
+                    }
+                }
+
+                /**
+                 * @brief flip the variable and update the terms containing it
+                 *
+                 * @param index variable
+                 */
+                void flip(std::size_t index){
+                    const auto& offsets = interaction.incidence_offsets();
+                    const auto& incidence = interaction.incidence();
+                    if(vartype == graph::Vartype::SPIN){
+                        for(std::size_t k=offsets[index]; k<offsets[index+1]; k++){
+                            term_state[incidence[k]] *= -1;
+                        }
+                        spin[index] *= -1;
+                    }
+                    else{
+                        const int diff = (spin[index] == 1) ? 1 : -1;
+                        for(std::size_t k=offsets[index]; k<offsets[index+1]; k++){
+                            term_state[incidence[k]] += diff;
+                        }
+                        spin[index] = 1 - spin[index];
+                    }
+                }
+
+                graph::Spins spin;
+                const GraphType interaction;
+
+                /**
+                 * @brief type of variables
+                 */
+                const graph::Vartype vartype;
+
+                /**
+                 * @brief per-term state (product of spins for SPIN, number of zeros for BINARY)
+                 */
+                std::vector<int> term_state;
+
+                /**
+                 * @brief number of variables
+                 */
+                const std::size_t num_spins; //spin.size()
+
+            private:
+
+                void reset_term_state(){
+                    const auto& offsets = interaction.term_offsets();
+                    const auto& vars = interaction.term_vars();
+                    term_state.assign(interaction.get_num_terms(), 0);
+                    for(std::size_t t=0; t<interaction.get_num_terms(); t++){
+                        int state = (vartype == graph::Vartype::SPIN) ? 1 : 0;
+                        for(std::size_t k=offsets[t]; k<offsets[t+1]; k++){
+                            if(vartype == graph::Vartype::SPIN){
+                                state *= spin[vars[k]];
+                            }
+                            else{
+                                state += (spin[vars[k]] == 0) ? 1 : 0;
+                            }
+                        }
+                        term_state[t] = state;
+                    }
+                }
+            };
+
+        /**
+         * @brief helper function for ClassicalIsingPolynomial constructor
+         *
+         * @tparam GraphType
+         * @param init_spin initial variables
+         * @param init_interaction polynomial interactions
+         * @param vartype type of variables
+         *
+         * @return generated object
+         */
+        template<typename GraphType>
+            ClassicalIsingPolynomial<GraphType> make_classical_ising_polynomial(const graph::Spins& init_spin, const GraphType& init_interaction, graph::Vartype vartype){
+                return ClassicalIsingPolynomial<GraphType>(init_spin, init_interaction, vartype);
+            }
+
+    } // namespace system
+} // namespace openjij
+
+#endif
@@ -17,12 +17,205 @@
 
 #include <system/system.hpp>
 #include <graph/all.hpp>
+#include <utility/union_find.hpp>
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
+#include <memory>
 #include <vector>
 #include <utility>
 
 namespace openjij {
     namespace system {
+
+        /**
+         * @brief view of a timeline in SpinTimelines
+         *
+         * @tparam T cut point type (CutPoint or const CutPoint)
+         */
+        template<typename T>
+        class TimelineView {
+        private:
+            T* _first;
+            T* _last;
+
+        public:
+            TimelineView(T* first, T* last) : _first(first), _last(last) {}
+
+            T& operator[](std::size_t k) const {
+                assert(k < size());
+                return _first[k];
+            }
+
+            std::size_t size() const {
+                return _last - _first;
+            }
+
+            T* begin() const {
+                return _first;
+            }
+
+            T* end() const {
+                return _last;
+            }
+
+            T& front() const {
+                assert(size() > 0);
+                return *_first;
+            }
+
+            T& back() const {
+                assert(size() > 0);
+                return *(_last - 1);
+            }
+        };
+
+        /**
+         * @brief timelines of all the sites in a flat arena (offset array + cut point array)
+         *
+         * Cut points of the site i are [offsets()[i], offsets()[i+1]) of the arena, so that offsets()[i]+k is
+         * a one-dimensional index of the kth time point at the ith site.
+         * clear() keeps the capacity, so rebuilding timelines does not allocate in steady state.
+         *
+         * @tparam CutPoint pair of time point and spin
+         */
+        template<typename CutPoint>
+        class SpinTimelines {
+        private:
+            std::vector<std::size_t> _offsets;
+            std::vector<CutPoint> _points;
+
+        public:
+            SpinTimelines() : _offsets(1, 0) {}
+
+            /**
+             * @brief SpinTimelines constructor
+             *
+             * @param spin_config timelines of the sites
+             */
+            explicit SpinTimelines(const std::vector<std::vector<CutPoint>>& spin_config) : SpinTimelines() {
+                for(auto&& timeline : spin_config) {
+                    push_timeline(timeline);
+                }
+            }
+
+            TimelineView<CutPoint> operator[](std::size_t i) {
+                assert(i < size());
+                return TimelineView<CutPoint>(_points.data() + _offsets[i], _points.data() + _offsets[i+1]);
+            }
+
+            TimelineView<const CutPoint> operator[](std::size_t i) const {
+                assert(i < size());
+                return TimelineView<const CutPoint>(_points.data() + _offsets[i], _points.data() + _offsets[i+1]);
+            }
+
+            /**
+             * @brief number of sites
+             */
+            std::size_t size() const {
+                return _offsets.size() - 1;
+            }
+
+            /**
+             * @brief total number of cut points
+             */
+            std::size_t num_points() const {
+                return _points.size();
+            }
+
+            /**
+             * @brief offsets of the timelines (size: size()+1)
+             */
+            const std::vector<std::size_t>& offsets() const {
+                return _offsets;
+            }
+
+            /**
+             * @brief remove all the timelines (capacity is kept)
+             */
+            void clear() {
+                _offsets.resize(1);
+                _points.clear();
+            }
+
+            /**
+             * @brief append a cut point to the timeline under construction
+             *
+             * @param point cut point
+             */
+            void push_back(const CutPoint& point) {
+                _points.push_back(point);
+            }
+
+            /**
+             * @brief finish the timeline under construction
+             */
+            void close_timeline() {
+                _offsets.push_back(_points.size());
+            }
+
+            /**
+             * @brief append a timeline
+             *
+             * @param timeline cut points of the site
+             */
+            template<typename Timeline>
+            void push_timeline(const Timeline& timeline) {
+                for(auto&& point : timeline) {
+                    push_back(point);
+                }
+                close_timeline();
+            }
+
+            /**
+             * @brief copy into std::vector based timelines
+             *
+             * @return timelines of the sites
+             */
+            std::vector<std::vector<CutPoint>> to_spin_configuration() const {
+                std::vector<std::vector<CutPoint>> ret;
+                for(std::size_t i = 0;i < size();i++) {
+                    ret.emplace_back((*this)[i].begin(), (*this)[i].end());
+                }
+                return ret;
+            }
+
+            void swap(SpinTimelines& other) {
+                _offsets.swap(other._offsets);
+                _points.swap(other._points);
+            }
+        };
+
+        /**
+         * @brief scratch buffers reused by the continuous time updaters (not a part of the state)
+         *
+         * @tparam CutPoint pair of time point and spin
+         */
+        template<typename CutPoint>
+        struct ContinuousTimeWorkspace {
+            using TimeType = typename CutPoint::first_type;
+
+            /**
+             * @brief timelines under construction (swapped with spin_config)
+             */
+            SpinTimelines<CutPoint> next_config;
+
+            /**
+             * @brief poisson points (cuts or bonds)
+             */
+            std::vector<TimeType> points;
+
+            /**
+             * @brief union-find tree over all the time points
+             */
+            utility::UnionFind union_find_tree{0};
+
+            /**
+             * @brief flip decision of each cluster root (-1: undecided, 0: keep, 1: flip)
+             */
+            std::vector<std::int8_t> cluster_flip;
+        };
+
         template<typename GraphType, bool eigen_impl=false>
         struct ContinuousTimeIsing {
             using system_type = transverse_field_system;
@@ -36,6 +229,11 @@ namespace openjij {
              */
             using SpinConfiguration = std::vector<std::vector<CutPoint>>;
 
+            /**
+             * @brief spin configuration stored in a flat arena
+             */
+            using Timelines = SpinTimelines<CutPoint>;
+
             /**
              * @brief ContinuousTimeIsing constructor
              *
@@ -48,25 +246,12 @@ namespace openjij {
                                 const FloatType gamma)
                 : spin_config(init_spin_config),
                   num_spins(init_spin_config.size()+1),
-                  interaction(init_interaction.get_num_spins()+1),
+                  interaction(make_shared_interaction(convert_to_interaction(init_interaction))),
                   gamma(gamma) {
 
                 assert(init_spin_config.size() == init_interaction.get_num_spins());
 
-                for(graph::Index i = 0;i < init_interaction.get_num_spins();i++) {
-                    for(auto&& j : init_interaction.adj_nodes(i)) {
-                        if(i < j) {
-                            continue;
-                        }
-
-                        this->interaction.J(i, j) = init_interaction.J(i, j); // add actual interactions
-                    }
-
-                    this->interaction.J(i, this->num_spins-1) = init_interaction.h(i);
-                    // add longitudinal magnetic field as interaction between ith spin and auxiliary spin
-                }
-
-                spin_config.push_back(std::vector<CutPoint> { CutPoint(0.0, 1) });
+                spin_config.push_timeline(std::vector<CutPoint> { CutPoint(0.0, 1) });
                 // initialize auxiliary spin with 1 along entire timeline
             }
 
@@ -106,6 +291,31 @@ namespace openjij {
                 return spin_config;
             }
 
+            /**
+             * @brief add the auxiliary spin; longitudinal magnetic field becomes interaction between each spin and the auxiliary spin
+             *
+             * @param init_interaction
+             */
+            static GraphType convert_to_interaction(const GraphType& init_interaction) {
+                const auto auxiliary_index = init_interaction.get_num_spins();
+                GraphType interaction(auxiliary_index+1);
+
+                for(graph::Index i = 0;i < init_interaction.get_num_spins();i++) {
+                    for(auto&& j : init_interaction.adj_nodes(i)) {
+                        if(i < j) {
+                            continue;
+                        }
+
+                        interaction.J(i, j) = init_interaction.J(i, j); // add actual interactions
+                    }
+
+                    interaction.J(i, auxiliary_index) = init_interaction.h(i);
+                    // add longitudinal magnetic field as interaction between ith spin and auxiliary spin
+                }
+
+                return interaction;
+            }
+
             /* member functions*/
         public:
 
@@ -117,8 +327,8 @@ namespace openjij {
             void reset_spins(const SpinConfiguration& init_spin_config) {
                 assert(init_spin_config.size() == this->num_spins-1);
 
-                this->spin_config = init_spin_config;
-                this->spin_config.push_back(std::vector<CutPoint> { CutPoint(TimeType(), 1) });
+                this->spin_config = Timelines(init_spin_config);
+                this->spin_config.push_timeline(std::vector<CutPoint> { CutPoint(TimeType(), 1) });
                 // add auxiliary timeline
             }
 
@@ -130,12 +340,13 @@ namespace openjij {
             void reset_spins(const graph::Spins& classical_spins) {
                 assert(classical_spins.size() == this->num_spins-1);
 
+                this->spin_config.clear();
                 for(size_t i = 0;i < this->num_spins - 1;i++) {
-                    this->spin_config[i] = std::vector<CutPoint> {
-                        CutPoint(TimeType(), classical_spins[i]) // TimeType() is zero value of the type
-                    };
+                    this->spin_config.push_back(CutPoint(TimeType(), classical_spins[i])); // TimeType() is zero value of the type
+                    this->spin_config.close_timeline();
                 }
-                this->spin_config[this->num_spins-1] = std::vector<CutPoint> { CutPoint(TimeType(), 1) };
+                this->spin_config.push_back(CutPoint(TimeType(), 1));
+                this->spin_config.close_timeline();
             }
 
             /**
@@ -149,7 +360,7 @@ namespace openjij {
                 static const auto first_lt = [](CutPoint x, CutPoint y) { return x.first < y.first; };
                 // function to compare two time points (lt; less than)
 
-                const auto& timeline = this->spin_config[site_index];
+                const auto timeline = this->spin_config[site_index];
                 const auto dummy_cut = CutPoint(time_point, 0); // dummy variable for binary search
                 auto found_itr = std::upper_bound(timeline.begin(),
                                                   timeline.end(),
@@ -198,7 +409,7 @@ namespace openjij {
             /**
              * @brief spin configuration
              */
-            SpinConfiguration spin_config;
+            Timelines spin_config;
 
             /**
              * @brief number of spins, including auxiliary spin for longitudinal magnetic field
@@ -206,14 +417,19 @@ namespace openjij {
             const std::size_t num_spins;
 
             /**
-             * @brief interaction
+             * @brief interaction including the auxiliary spin (shared by the copies of this system)
              */
-            GraphType interaction;
+            SharedInteraction<GraphType> interaction;
 
             /**
              * @brief coefficient of transverse field term, actual field would be gamma * s, where s = [0:1]
              */
             const FloatType gamma;
+
+            /**
+             * @brief scratch buffers of the updaters
+             */
+            ContinuousTimeWorkspace<CutPoint> workspace;
         };
 
         /**
@@ -0,0 +1,168 @@
+//    Copyright 2019 Jij Inc.
+
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+
+//        http://www.apache.org/licenses/LICENSE-2.0
+
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+
+#ifndef OPENJIJ_SYSTEM_MULTI_SPIN_CLASSICAL_ISING_HPP__
+#define OPENJIJ_SYSTEM_MULTI_SPIN_CLASSICAL_ISING_HPP__
+
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include <system/system.hpp>
+#include <graph/all.hpp>
+
+namespace openjij {
+    namespace system {
+
+        /**
+         * @brief classical ising system with 64 replicas packed bitwise (multi-spin coding) for \f\pm J\f models
+         *
+         * Bit r of spin[i] is the spin i of the replica r (set bit: +1, cleared bit: -1).
+         * All the nonzero J_{ij} and h_i must have the same magnitude J0;
+         * a local field is treated as a bond to the ghost spin spin[num_spins], which is +1 in every replica.
+         *
+         * @tparam GraphType type of graph (assume Sparse or derived class of it, e.g. Square, Chimera)
+         */
+        template<typename GraphType>
+            struct MultiSpinClassicalIsing{
+                using system_type = classical_system;
+                using FloatType = typename GraphType::value_type;
+                using Word = std::uint64_t;
+
+                /**
+                 * @brief number of replicas
+                 */
+                static constexpr std::size_t num_replicas = 64;
+
+                /**
+                 * @brief Constructor to initialize spins of the replicas and interaction
+                 *
+                 * @param init_spins initial spins of the replicas (size: num_replicas)
+                 * @param init_interaction interactions (\f\pm J\f)
+                 */
+                MultiSpinClassicalIsing(const std::vector<graph::Spins>& init_spins, const GraphType& init_interaction)
+                    : interaction(init_interaction), num_spins(init_interaction.get_num_spins()), magnitude(0){
+                        //CSR adjacency with the signs of the bonds
+                        bond_offsets.push_back(0);
+                        for(std::size_t i=0; i<num_spins; i++){
+                            for(auto&& j : interaction.adj_nodes(i)){
+                                const FloatType value = (i != j) ? interaction.J(i, j) : interaction.h(i);
+                                if(value == 0) continue;
+                                if(magnitude == 0){
+                                    magnitude = std::abs(value);
+                                }
+                                else if(std::abs(value) != magnitude){
+                                    throw std::invalid_argument("all the nonzero interactions must have the same magnitude.");
+                                }
+                                bond_nodes.push_back((i != j) ? j : num_spins);
+                                bond_signs.push_back(value < 0 ? ~Word(0) : Word(0));
+                            }
+                            bond_offsets.push_back(bond_nodes.size());
+                        }
+                        reset_spins(init_spins);
+                    }
+
+                /**
+                 * @brief reset spins of the replicas
+                 *
+                 * @param init_spins initial spins of the replicas (size: num_replicas)
+                 */
+                void reset_spins(const std::vector<graph::Spins>& init_spins){
+                    if(init_spins.size() != num_replicas){
+                        throw std::invalid_argument("the number of initial states must be equal to num_replicas.");
+                    }
+                    spin.assign(num_spins+1, 0);
+                    for(std::size_t r=0; r<num_replicas; r++){
+                        assert(init_spins[r].size() == num_spins);
+                        for(std::size_t i=0; i<num_spins; i++){
+                            if(init_spins[r][i] > 0) spin[i] |= Word(1) << r;
+                        }
+                    }
+                    //ghost spin
+                    spin[num_spins] = ~Word(0);
+                }
+
+                /**
+                 * @brief get spins of a replica
+                 *
+                 * @param replica replica index
+                 *
+                 * @return spins
+                 */
+                graph::Spins get_replica(std::size_t replica) const{
+                    assert(replica < num_replicas);
+                    graph::Spins ret(num_spins);
+                    for(std::size_t i=0; i<num_spins; i++){
+                        ret[i] = ((spin[i] >> replica) & 1) ? 1 : -1;
+                    }
+                    return ret;
+                }
+
+                /**
+                 * @brief bitwise spins (size: num_spins+1, the last one is the ghost spin)
+                 */
+                std::vector<Word> spin;
+
+                const GraphType interaction;
+
+                /**
+                 * @brief number of real spins (ghost spin excluded)
+                 */
+                const std::size_t num_spins;
+
+                /**
+                 * @brief magnitude of the interactions J0
+                 */
+                FloatType magnitude;
+
+                /**
+                 * @brief bonds of spin i are [bond_offsets[i], bond_offsets[i+1])
+                 */
+                std::vector<std::size_t> bond_offsets;
+
+                /**
+                 * @brief the other end of each bond (num_spins for a local field)
+                 */
+                std::vector<std::size_t> bond_nodes;
+
+                /**
+                 * @brief sign of each bond (all bits set for a negative interaction)
+                 */
+                std::vector<Word> bond_signs;
+            };
+
+        template<typename GraphType>
+            constexpr std::size_t MultiSpinClassicalIsing<GraphType>::num_replicas;
+
+        /**
+         * @brief helper function for MultiSpinClassicalIsing constructor
+         *
+         * @tparam GraphType
+         * @param init_spins initial spins of the replicas
+         * @param init_interaction initial interaction
+         *
+         * @return generated object
+         */
+        template<typename GraphType>
+            MultiSpinClassicalIsing<GraphType> make_multi_spin_classical_ising(const std::vector<graph::Spins>& init_spins, const GraphType& init_interaction){
+                return MultiSpinClassicalIsing<GraphType>(init_spins, init_interaction);
+            }
+
+    } // namespace system
+} // namespace openjij
+
+#endif
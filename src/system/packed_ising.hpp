@@ -0,0 +1,196 @@
+//    Copyright 2019 Jij Inc.
+
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+
+//        http://www.apache.org/licenses/LICENSE-2.0
+
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+
+#ifndef OPENJIJ_SYSTEM_PACKED_ISING_HPP__
+#define OPENJIJ_SYSTEM_PACKED_ISING_HPP__
+
+#include <cassert>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include <system/system.hpp>
+#include <system/transverse_ising.hpp>
+#include <graph/all.hpp>
+#include <graph/packed_spins.hpp>
+
+namespace openjij {
+    namespace system {
+
+        /**
+         * @brief trotterized spins, each slice packed into 64-bit words
+         * packed_trotter_spins[i].get(j) -> jth spin in ith trotter slice.
+         */
+        using PackedTrotterSpins = std::vector<graph::PackedSpins>;
+
+        /**
+         * @brief ClassicalIsing structure with bit-packed spins (1 bit per spin)
+         *
+         * @tparam GraphType type of graph (assume CSRSparse)
+         */
+        template<typename GraphType>
+            struct ClassicalIsingPacked{
+                using system_type = classical_system;
+
+                /**
+                 * @brief Constructor to initialize spin and interaction
+                 *
+                 * @param init_spin initial spins
+                 * @param init_interaction interactions
+                 */
+                ClassicalIsingPacked(const graph::Spins& init_spin, const GraphType& init_interaction)
+                    : spin(init_spin), interaction(init_interaction), num_spins(init_spin.size()){
+                        assert(init_spin.size() == init_interaction.get_num_spins());
+                    }
+
+                /**
+                 * @brief reset spins
+                 *
+                 * @param init_spin
+                 */
+                void reset_spins(const graph::Spins& init_spin){
+                    assert(init_spin.size() == num_spins);
+                    this->spin = graph::PackedSpins(init_spin);
+                }
+
+                graph::PackedSpins spin;
+                GraphType interaction;
+
+                /**
+                 * @brief number of real spins (dummy spin excluded)
+                 */
+                const std::size_t num_spins; //spin.size()
+            };
+
+        /**
+         * @brief TransverseIsing structure with bit-packed trotter spins (1 bit per spin)
+         *
+         * @tparam GraphType type of graph (assume CSRSparse)
+         */
+        template<typename GraphType>
+            struct TransverseIsingPacked{
+                using system_type = transverse_field_system;
+                using FloatType = typename GraphType::value_type;
+
+                /**
+                 * @brief TransverseIsingPacked Constructor
+                 *
+                 * @param init_trotter_spins
+                 * @param init_interaction
+                 * @param gamma coefficient of transverse field term
+                 */
+                TransverseIsingPacked(const TrotterSpins& init_trotter_spins, const GraphType& init_interaction, FloatType gamma)
+                : interaction(init_interaction), num_classical_spins(init_trotter_spins[0].size()), gamma(gamma){
+                    if(!(init_trotter_spins.size() >= 2)){
+                        throw std::invalid_argument("trotter slices must be equal or larger than 2.");
+                    }
+                    reset_spins(init_trotter_spins);
+                }
+
+                /**
+                 * @brief TransverseIsingPacked Constuctor with initial classical spins
+                 *
+                 * @param classical_spins initial classical spins
+                 * @param init_interaction
+                 * @param gamma coefficient of transverse field term
+                 * @param num_trotter_slices
+                 */
+                TransverseIsingPacked(const graph::Spins& classical_spins, const GraphType& init_interaction, FloatType gamma, size_t num_trotter_slices)
+                : trotter_spins(num_trotter_slices, graph::PackedSpins(classical_spins)), interaction(init_interaction), num_classical_spins(classical_spins.size()), gamma(gamma){
+                    if(!(trotter_spins.size() >= 2)){
+                        throw std::invalid_argument("trotter slices must be equal or larger than 2.");
+                    }
+                }
+
+                /**
+                 * @brief reset spins with trotter spins
+                 *
+                 * @param init_trotter_spins
+                 */
+                void reset_spins(const TrotterSpins& init_trotter_spins){
+                    trotter_spins.clear();
+                    for(auto&& spins : init_trotter_spins){
+                        assert(spins.size() == num_classical_spins);
+                        trotter_spins.emplace_back(spins);
+                    }
+                }
+
+                /**
+                 * @brief reset spins with classical spins
+                 *
+                 * @param classical_spins
+                 */
+                void reset_spins(const graph::Spins& classical_spins){
+                    assert(classical_spins.size() == num_classical_spins);
+                    for(auto& spins : this->trotter_spins){
+                        spins = graph::PackedSpins(classical_spins);
+                    }
+                }
+
+                /**
+                 * @brief trotterlized spins
+                 */
+                PackedTrotterSpins trotter_spins;
+
+                /**
+                 * @brief interaction
+                 */
+                GraphType interaction;
+
+                /**
+                 * @brief number of real classical spins
+                 */
+                std::size_t num_classical_spins;
+
+                /**
+                 * @brief coefficient of transverse field term
+                 */
+                FloatType gamma;
+            };
+
+        /**
+         * @brief helper function for ClassicalIsingPacked constructor
+         *
+         * @tparam GraphType
+         * @param init_spin initial spin
+         * @param init_interaction initial interaction
+         *
+         * @return generated object
+         */
+        template<typename GraphType>
+            ClassicalIsingPacked<GraphType> make_classical_ising_packed(const graph::Spins& init_spin, const GraphType& init_interaction){
+                return ClassicalIsingPacked<GraphType>(init_spin, init_interaction);
+            }
+
+        /**
+         * @brief helper function for TransverseIsingPacked constructor
+         *
+         * @tparam GraphType
+         * @param classical_spins initial classical spins
+         * @param init_interaction initial interaction
+         * @param gamma coefficient of transverse field term
+         * @param num_trotter_slices number of trotter slices
+         *
+         * @return generated object
+         */
+        template<typename GraphType>
+            TransverseIsingPacked<GraphType> make_transverse_ising_packed(const graph::Spins& classical_spins, const GraphType& init_interaction,
+                    typename GraphType::value_type gamma, std::size_t num_trotter_slices){
+                return TransverseIsingPacked<GraphType>(classical_spins, init_interaction, gamma, num_trotter_slices);
+            }
+
+    } // namespace system
+} // namespace openjij
+
+#endif
@@ -0,0 +1,264 @@
+//    Copyright 2019 Jij Inc.
+
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+
+//        http://www.apache.org/licenses/LICENSE-2.0
+
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+
+#ifndef OPENJIJ_SYSTEM_PREPARED_PROBLEM_HPP__
+#define OPENJIJ_SYSTEM_PREPARED_PROBLEM_HPP__
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <system/system.hpp>
+#include <system/classical_ising.hpp>
+#include <graph/all.hpp>
+#include <utility/eigen.hpp>
+
+namespace openjij {
+    namespace system {
+
+        /**
+         * @brief problem prepared once for repeated sampling
+         *
+         * Owns the graph and builds its derived forms (Eigen matrix, CSR layout, coloring,
+         * default beta range and degree statistics) on first use.
+         * Systems made from the problem share these forms instead of converting the graph again.
+         * The lazy builds are thread-safe.
+         *
+         * @tparam GraphType type of graph (assume Dense or Sparse)
+         */
+        template<typename GraphType>
+            class PreparedProblem{
+                public:
+                    using FloatType = typename GraphType::value_type;
+
+                    /**
+                     * @brief Eigen matrix used by the Eigen-based systems (with the dummy spin)
+                     */
+                    using EigenMatrix = typename utility::get_eigen_matrix_type<GraphType, Eigen::RowMajor>::type;
+
+                    /**
+                     * @brief statistics of the number of adjacent nodes (local fields excluded)
+                     */
+                    struct DegreeStatistics{
+                        std::size_t min_degree;
+                        std::size_t max_degree;
+                        double mean_degree;
+                    };
+
+                    /**
+                     * @brief PreparedProblem constructor
+                     *
+                     * @param graph graph of the problem
+                     */
+                    explicit PreparedProblem(const GraphType& graph)
+                        : _graph(make_shared_interaction(graph)){}
+
+                    PreparedProblem(const PreparedProblem&) = delete;
+                    PreparedProblem& operator=(const PreparedProblem&) = delete;
+
+                    /**
+                     * @brief get the graph
+                     *
+                     * @return graph
+                     */
+                    const SharedInteraction<GraphType>& get_graph() const{
+                        return _graph;
+                    }
+
+                    /**
+                     * @brief get the number of spins
+                     *
+                     * @return number of spins
+                     */
+                    std::size_t get_num_spins() const{
+                        return _graph->get_num_spins();
+                    }
+
+                    /**
+                     * @brief get the Eigen matrix (built on first call)
+                     *
+                     * @return Eigen matrix
+                     */
+                    const SharedInteraction<EigenMatrix>& get_eigen_matrix() const{
+                        std::call_once(_eigen_matrix_flag, [this](){
+                                _eigen_matrix = make_shared_interaction<EigenMatrix>(utility::gen_matrix_from_graph<Eigen::RowMajor>(*_graph));
+                                });
+                        return _eigen_matrix;
+                    }
+
+                    /**
+                     * @brief get the graph in CSR layout (built on first call)
+                     *
+                     * @return CSR graph
+                     */
+                    const SharedInteraction<graph::CSRSparse<FloatType>>& get_csr() const{
+                        std::call_once(_csr_flag, [this](){
+                                _csr = make_shared_interaction(graph::CSRSparse<FloatType>(*_graph));
+                                });
+                        return _csr;
+                    }
+
+                    /**
+                     * @brief get a greedy coloring; adjacent spins have different colors (built on first call)
+                     *
+                     * @return color of each spin
+                     */
+                    const std::vector<std::size_t>& get_coloring() const{
+                        std::call_once(_coloring_flag, [this](){ build_coloring(); });
+                        return _coloring;
+                    }
+
+                    /**
+                     * @brief get the number of colors of get_coloring()
+                     *
+                     * @return number of colors
+                     */
+                    std::size_t get_num_colors() const{
+                        get_coloring();
+                        return _num_colors;
+                    }
+
+                    /**
+                     * @brief get the default beta range of the annealing (computed on first call)
+                     * beta_min = log(2) / max_i (|h_i| + sum_j |J_ij|), beta_max = log(100) / min nonzero |J_ij| or |h_i|
+                     *
+                     * @return pair of beta_min and beta_max
+                     */
+                    std::pair<FloatType, FloatType> get_beta_range() const{
+                        std::call_once(_statistics_flag, [this](){ build_statistics(); });
+                        if(!(_max_abs_field > 0)){
+                            throw std::invalid_argument("beta range is undefined for a problem without interactions.");
+                        }
+                        return std::make_pair(std::log(FloatType(2)) / _max_abs_field, std::log(FloatType(100)) / _min_abs_interaction);
+                    }
+
+                    /**
+                     * @brief get the statistics of the degrees (computed on first call)
+                     *
+                     * @return degree statistics
+                     */
+                    const DegreeStatistics& get_degree_statistics() const{
+                        std::call_once(_statistics_flag, [this](){ build_statistics(); });
+                        return _degree_statistics;
+                    }
+
+                private:
+
+                    SharedInteraction<GraphType> _graph;
+
+                    mutable std::once_flag _eigen_matrix_flag;
+                    mutable SharedInteraction<EigenMatrix> _eigen_matrix;
+
+                    mutable std::once_flag _csr_flag;
+                    mutable SharedInteraction<graph::CSRSparse<FloatType>> _csr;
+
+                    mutable std::once_flag _coloring_flag;
+                    mutable std::vector<std::size_t> _coloring;
+                    mutable std::size_t _num_colors = 0;
+
+                    mutable std::once_flag _statistics_flag;
+                    mutable DegreeStatistics _degree_statistics = {0, 0, 0};
+                    mutable FloatType _max_abs_field = 0;
+                    mutable FloatType _min_abs_interaction = 0;
+
+                    void build_coloring() const{
+                        const std::size_t num_spins = get_num_spins();
+                        _coloring.assign(num_spins, 0);
+                        std::vector<std::size_t> used_by(num_spins+1, num_spins); //used_by[c] == i -> color c is taken by a neighbor of i
+                        for(std::size_t i=0; i<num_spins; i++){
+                            for(auto&& j : _graph->adj_nodes(i)){
+                                if(j < i && _graph->J(i, j) != 0) used_by[_coloring[j]] = i;
+                            }
+                            std::size_t color = 0;
+                            while(used_by[color] == i) color++;
+                            _coloring[i] = color;
+                            _num_colors = std::max(_num_colors, color+1);
+                        }
+                    }
+
+                    void build_statistics() const{
+                        const std::size_t num_spins = get_num_spins();
+                        _degree_statistics.min_degree = (num_spins > 0) ? std::numeric_limits<std::size_t>::max() : 0;
+                        _min_abs_interaction = std::numeric_limits<FloatType>::max();
+                        std::size_t sum_degree = 0;
+                        for(std::size_t i=0; i<num_spins; i++){
+                            std::size_t degree = 0;
+                            FloatType abs_field = 0;
+                            for(auto&& j : _graph->adj_nodes(i)){
+                                const FloatType value = std::abs((i != j) ? _graph->J(i, j) : _graph->h(i));
+                                if(value == 0) continue;
+                                if(i != j) degree++;
+                                abs_field += value;
+                                _min_abs_interaction = std::min(_min_abs_interaction, value);
+                            }
+                            _max_abs_field = std::max(_max_abs_field, abs_field);
+                            _degree_statistics.min_degree = std::min(_degree_statistics.min_degree, degree);
+                            _degree_statistics.max_degree = std::max(_degree_statistics.max_degree, degree);
+                            sum_degree += degree;
+                        }
+                        _degree_statistics.mean_degree = (num_spins > 0) ? static_cast<double>(sum_degree) / num_spins : 0;
+                    }
+            };
+
+        namespace prepared_problem_impl{
+            template<typename GraphType>
+                inline const SharedInteraction<GraphType>& get_interaction(const PreparedProblem<GraphType>& problem, std::false_type){
+                    return problem.get_graph();
+                }
+
+            template<typename GraphType>
+                inline const SharedInteraction<typename PreparedProblem<GraphType>::EigenMatrix>& get_interaction(const PreparedProblem<GraphType>& problem, std::true_type){
+                    return problem.get_eigen_matrix();
+                }
+        } // namespace prepared_problem_impl
+
+        /**
+         * @brief helper function for ClassicalIsing constructor with a prepared problem (the interaction is shared)
+         *
+         * @tparam eigen_impl
+         * @tparam GraphType
+         * @param init_spin initial spin
+         * @param problem prepared problem
+         *
+         * @return generated object
+         */
+        template<bool eigen_impl=false, typename GraphType>
+            ClassicalIsing<GraphType, eigen_impl> make_classical_ising(const graph::Spins& init_spin, const PreparedProblem<GraphType>& problem){
+                return ClassicalIsing<GraphType, eigen_impl>(init_spin, prepared_problem_impl::get_interaction(problem, std::integral_constant<bool, eigen_impl>()));
+            }
+
+        /**
+         * @brief helper function for ClassicalIsing constructor on the CSR layout of a prepared problem
+         *
+         * @tparam GraphType
+         * @param init_spin initial spin
+         * @param problem prepared problem
+         *
+         * @return generated object
+         */
+        template<typename GraphType>
+            ClassicalIsing<graph::CSRSparse<typename GraphType::value_type>, false> make_classical_ising_csr(const graph::Spins& init_spin, const PreparedProblem<GraphType>& problem){
+                return ClassicalIsing<graph::CSRSparse<typename GraphType::value_type>, false>(init_spin, problem.get_csr());
+            }
+
+    } // namespace system
+} // namespace openjij
+
+#endif
@@ -0,0 +1,472 @@
+//    Copyright 2019 Jij Inc.
+
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+
+//        http://www.apache.org/licenses/LICENSE-2.0
+
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+
+#ifndef OPENJIJ_SYSTEM_STATE_IO_HPP__
+#define OPENJIJ_SYSTEM_STATE_IO_HPP__
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <system/classical_ising.hpp>
+#include <system/transverse_ising.hpp>
+#include <system/continuous_time_ising.hpp>
+
+namespace openjij {
+    namespace system {
+
+        /**
+         * @brief kind of system state written by save_state
+         */
+        enum class StateKind : std::uint32_t{
+            CLASSICAL = 0,          /**< naive ClassicalIsing: spins and cached local fields */
+            CLASSICAL_EIGEN = 1,    /**< Eigen-based ClassicalIsing: spins and cached local fields */
+            CLASSICAL_LATTICE = 2,  /**< ClassicalIsing on Chimera, Square or King's graph: spins */
+            TRANSVERSE = 3,         /**< naive TransverseIsing: trotter spins and cached local fields */
+            TRANSVERSE_EIGEN = 4,   /**< Eigen-based TransverseIsing: trotter spins and cached local fields */
+            CONTINUOUS_TIME = 5,    /**< ContinuousTimeIsing: timelines */
+        };
+
+        namespace state_io_impl{
+
+            /*
+             * The state is a sequence of native-endian values.
+             * An array is written as the size of its element (uint32), its length (uint64) and the elements,
+             * so that a state saved with another FloatType is rejected instead of misread.
+             */
+
+            template<typename T>
+                inline void write_value(std::ostream& os, const T& value){
+                    os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+                }
+
+            template<typename T>
+                inline T read_value(std::istream& is){
+                    T value;
+                    if(!is.read(reinterpret_cast<char*>(&value), sizeof(T))){
+                        throw std::runtime_error("load_state: unexpected end of stream");
+                    }
+                    return value;
+                }
+
+            template<typename T>
+                inline void write_array(std::ostream& os, const T* data, std::size_t size){
+                    write_value<std::uint32_t>(os, sizeof(T));
+                    write_value<std::uint64_t>(os, size);
+                    os.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(sizeof(T)*size));
+                }
+
+            template<typename T>
+                inline std::size_t read_array_size(std::istream& is){
+                    if(read_value<std::uint32_t>(is) != sizeof(T)){
+                        throw std::runtime_error("load_state: element size mismatch");
+                    }
+                    return static_cast<std::size_t>(read_value<std::uint64_t>(is));
+                }
+
+            template<typename T>
+                inline void read_array_data(std::istream& is, T* data, std::size_t size){
+                    if(!is.read(reinterpret_cast<char*>(data), static_cast<std::streamsize>(sizeof(T)*size))){
+                        throw std::runtime_error("load_state: unexpected end of stream");
+                    }
+                }
+
+            /**
+             * @brief read an array whose length is fixed by the system
+             */
+            template<typename T>
+                inline void read_array(std::istream& is, T* data, std::size_t expected_size){
+                    if(read_array_size<T>(is) != expected_size){
+                        throw std::runtime_error("load_state: number of spins mismatch");
+                    }
+                    read_array_data(is, data, expected_size);
+                }
+
+            template<typename T>
+                inline void write_values(std::ostream& os, const std::vector<T>& vec){
+                    write_array(os, vec.data(), vec.size());
+                }
+
+            /**
+             * @brief read a vector of the given length, growing it as the data arrive
+             * (the length comes from the stream and is not trusted for a single allocation)
+             */
+            template<typename T>
+                inline void read_values_of_size(std::istream& is, std::vector<T>& vec, std::size_t size){
+                    constexpr std::size_t chunk_size = std::size_t(1) << 16;
+                    vec.clear();
+                    while(vec.size() < size){
+                        const std::size_t begin = vec.size();
+                        vec.resize(begin + std::min(chunk_size, size - begin));
+                        read_array_data(is, vec.data() + begin, vec.size() - begin);
+                    }
+                }
+
+            /**
+             * @brief read a vector whose length is fixed by the system
+             */
+            template<typename T>
+                inline void read_values(std::istream& is, std::vector<T>& vec, std::size_t expected_size){
+                    vec.resize(expected_size);
+                    read_array(is, vec.data(), expected_size);
+                }
+
+            /**
+             * @brief write an Eigen vector or matrix with its shape
+             */
+            template<typename Matrix>
+                inline void write_values(std::ostream& os, const Matrix& mat){
+                    write_value<std::uint64_t>(os, mat.rows());
+                    write_value<std::uint64_t>(os, mat.cols());
+                    write_array(os, mat.data(), mat.size());
+                }
+
+            /**
+             * @brief read an Eigen vector or matrix whose shape is fixed by the system
+             */
+            template<typename Matrix>
+                inline void read_values(std::istream& is, Matrix& mat, std::size_t expected_rows, std::size_t expected_cols){
+                    const auto rows = read_value<std::uint64_t>(is);
+                    const auto cols = read_value<std::uint64_t>(is);
+                    if(rows != expected_rows || cols != expected_cols){
+                        throw std::runtime_error("load_state: number of spins mismatch");
+                    }
+                    mat.resize(expected_rows, expected_cols);
+                    read_array(is, mat.data(), mat.size());
+                }
+
+            inline void write_kind(std::ostream& os, StateKind kind){
+                write_value(os, kind);
+            }
+
+            inline void read_kind(std::istream& is, StateKind kind){
+                if(read_value<StateKind>(is) != kind){
+                    throw std::runtime_error("load_state: state of another kind of system");
+                }
+            }
+
+            inline void check_stream(const std::ostream& os){
+                if(!os){
+                    throw std::runtime_error("save_state: cannot write the state");
+                }
+            }
+
+            /**
+             * @brief write the cached local fields, so that a resumed run continues from the same rounded values
+             */
+            template<typename System>
+                inline void write_local_fields(std::ostream& os, const System& system){
+                    write_value<std::uint8_t>(os, system.local_fields_valid);
+                    if(system.local_fields_valid){
+                        write_values(os, system.local_field);
+                    }
+                }
+
+            /**
+             * @brief read the cached local fields (shape: size of the vector or rows and columns of the matrix)
+             * The local fields are marked valid only after they are read with the shape of the system.
+             */
+            template<typename System, typename... Shape>
+                inline void read_local_fields(std::istream& is, System& system, Shape... shape){
+                    system.local_fields_valid = false;
+                    const bool valid = (read_value<std::uint8_t>(is) != 0);
+                    if(valid){
+                        read_values(is, system.local_field, shape...);
+                    }
+                    system.local_fields_valid = valid;
+                }
+
+        } // namespace state_io_impl
+
+        /**
+         * @brief write the state of naive ClassicalIsing (spins and cached local fields)
+         *
+         * @param os output stream (binary mode)
+         * @param system system
+         */
+        template<typename GraphType>
+            inline void save_state(std::ostream& os, const ClassicalIsing<GraphType, false>& system){
+                using namespace state_io_impl;
+                write_kind(os, StateKind::CLASSICAL);
+                write_values(os, system.spin);
+                write_local_fields(os, system);
+                write_value(os, system.energy);
+                check_stream(os);
+            }
+
+        /**
+         * @brief restore the state written by save_state
+         *
+         * @param is input stream (binary mode)
+         * @param system system with the same interaction
+         */
+        template<typename GraphType>
+            inline void load_state(std::istream& is, ClassicalIsing<GraphType, false>& system){
+                using namespace state_io_impl;
+                read_kind(is, StateKind::CLASSICAL);
+                read_array(is, system.spin.data(), system.spin.size());
+                read_local_fields(is, system, system.spin.size());
+                system.energy = read_value<typename ClassicalIsing<GraphType, false>::FloatType>(is);
+            }
+
+        namespace state_io_impl{
+            template<typename System>
+                inline void save_eigen_classical(std::ostream& os, const System& system){
+                    write_kind(os, StateKind::CLASSICAL_EIGEN);
+                    write_values(os, system.spin);
+                    write_local_fields(os, system);
+                    write_value(os, system.energy);
+                    check_stream(os);
+                }
+
+            template<typename System>
+                inline void load_eigen_classical(std::istream& is, System& system){
+                    read_kind(is, StateKind::CLASSICAL_EIGEN);
+                    const std::size_t num_spins = system.spin.size();
+                    read_values(is, system.spin, num_spins, 1);
+                    read_local_fields(is, system, num_spins, 1);
+                    system.energy = read_value<typename std::decay<decltype(system.energy)>::type>(is);
+                }
+
+            template<typename System>
+                inline void save_lattice_classical(std::ostream& os, const System& system){
+                    write_kind(os, StateKind::CLASSICAL_LATTICE);
+                    write_values(os, system.spin);
+                    check_stream(os);
+                }
+
+            template<typename System>
+                inline void load_lattice_classical(std::istream& is, System& system){
+                    read_kind(is, StateKind::CLASSICAL_LATTICE);
+                    read_array(is, system.spin.data(), system.spin.size());
+                }
+
+            template<typename System>
+                inline void save_eigen_transverse(std::ostream& os, const System& system){
+                    write_kind(os, StateKind::TRANSVERSE_EIGEN);
+                    write_values(os, system.trotter_spins);
+                    write_local_fields(os, system);
+                    check_stream(os);
+                }
+
+            template<typename System>
+                inline void load_eigen_transverse(std::istream& is, System& system){
+                    read_kind(is, StateKind::TRANSVERSE_EIGEN);
+                    const std::size_t rows = system.trotter_spins.rows();
+                    const std::size_t cols = system.trotter_spins.cols();
+                    read_values(is, system.trotter_spins, rows, cols);
+                    read_local_fields(is, system, rows, cols);
+                }
+        } // namespace state_io_impl
+
+        template<typename FloatType>
+            inline void save_state(std::ostream& os, const ClassicalIsing<graph::Dense<FloatType>, true>& system){
+                state_io_impl::save_eigen_classical(os, system);
+            }
+
+        template<typename FloatType>
+            inline void load_state(std::istream& is, ClassicalIsing<graph::Dense<FloatType>, true>& system){
+                state_io_impl::load_eigen_classical(is, system);
+            }
+
+        template<typename FloatType>
+            inline void save_state(std::ostream& os, const ClassicalIsing<graph::Sparse<FloatType>, true>& system){
+                state_io_impl::save_eigen_classical(os, system);
+            }
+
+        template<typename FloatType>
+            inline void load_state(std::istream& is, ClassicalIsing<graph::Sparse<FloatType>, true>& system){
+                state_io_impl::load_eigen_classical(is, system);
+            }
+
+        template<typename FloatType>
+            inline void save_state(std::ostream& os, const ClassicalIsing<graph::Chimera<FloatType>, false>& system){
+                state_io_impl::save_lattice_classical(os, system);
+            }
+
+        template<typename FloatType>
+            inline void load_state(std::istream& is, ClassicalIsing<graph::Chimera<FloatType>, false>& system){
+                state_io_impl::load_lattice_classical(is, system);
+            }
+
+        template<typename FloatType>
+            inline void save_state(std::ostream& os, const ClassicalIsing<graph::Square<FloatType>, false>& system){
+                state_io_impl::save_lattice_classical(os, system);
+            }
+
+        template<typename FloatType>
+            inline void load_state(std::istream& is, ClassicalIsing<graph::Square<FloatType>, false>& system){
+                state_io_impl::load_lattice_classical(is, system);
+            }
+
+        template<typename FloatType>
+            inline void save_state(std::ostream& os, const ClassicalIsing<graph::KingGraph<FloatType>, false>& system){
+                state_io_impl::save_lattice_classical(os, system);
+            }
+
+        template<typename FloatType>
+            inline void load_state(std::istream& is, ClassicalIsing<graph::KingGraph<FloatType>, false>& system){
+                state_io_impl::load_lattice_classical(is, system);
+            }
+
+        /**
+         * @brief write the state of naive TransverseIsing (trotter spins and cached local fields)
+         *
+         * @param os output stream (binary mode)
+         * @param system system
+         */
+        template<typename GraphType>
+            inline void save_state(std::ostream& os, const TransverseIsing<GraphType, false>& system){
+                using namespace state_io_impl;
+                write_kind(os, StateKind::TRANSVERSE);
+                write_value<std::uint64_t>(os, system.trotter_spins.size());
+                write_array(os, system.trotter_spins.data(), system.trotter_spins.size()*system.trotter_spins.num_spins());
+                write_local_fields(os, system);
+                check_stream(os);
+            }
+
+        /**
+         * @brief restore the state written by save_state
+         *
+         * @param is input stream (binary mode)
+         * @param system system with the same interaction and number of trotter slices
+         */
+        template<typename GraphType>
+            inline void load_state(std::istream& is, TransverseIsing<GraphType, false>& system){
+                using namespace state_io_impl;
+                read_kind(is, StateKind::TRANSVERSE);
+                if(read_value<std::uint64_t>(is) != system.trotter_spins.size()){
+                    throw std::runtime_error("load_state: number of trotter slices mismatch");
+                }
+                const std::size_t num_trotter_spins = system.trotter_spins.size()*system.trotter_spins.num_spins();
+                read_array(is, system.trotter_spins.data(), num_trotter_spins);
+                read_local_fields(is, system, num_trotter_spins);
+            }
+
+        template<typename FloatType>
+            inline void save_state(std::ostream& os, const TransverseIsing<graph::Dense<FloatType>, true>& system){
+                state_io_impl::save_eigen_transverse(os, system);
+            }
+
+        template<typename FloatType>
+            inline void load_state(std::istream& is, TransverseIsing<graph::Dense<FloatType>, true>& system){
+                state_io_impl::load_eigen_transverse(is, system);
+            }
+
+        template<typename FloatType>
+            inline void save_state(std::ostream& os, const TransverseIsing<graph::Sparse<FloatType>, true>& system){
+                state_io_impl::save_eigen_transverse(os, system);
+            }
+
+        template<typename FloatType>
+            inline void load_state(std::istream& is, TransverseIsing<graph::Sparse<FloatType>, true>& system){
+                state_io_impl::load_eigen_transverse(is, system);
+            }
+
+        /**
+         * @brief write the state of ContinuousTimeIsing (timelines, the auxiliary one included)
+         *
+         * @param os output stream (binary mode)
+         * @param system system
+         */
+        template<typename GraphType, bool eigen_impl>
+            inline void save_state(std::ostream& os, const ContinuousTimeIsing<GraphType, eigen_impl>& system){
+                using namespace state_io_impl;
+                using TimeType = typename ContinuousTimeIsing<GraphType, eigen_impl>::TimeType;
+                const auto& timelines = system.spin_config;
+
+                //cut points are split into times and spins (std::pair may contain padding)
+                std::vector<std::uint64_t> offsets(timelines.offsets().begin(), timelines.offsets().end());
+                std::vector<TimeType> times;
+                std::vector<std::int8_t> spins;
+                times.reserve(timelines.num_points());
+                spins.reserve(timelines.num_points());
+                for(std::size_t i=0; i<timelines.size(); i++){
+                    for(auto&& point : timelines[i]){
+                        times.push_back(point.first);
+                        spins.push_back(static_cast<std::int8_t>(point.second));
+                    }
+                }
+
+                write_kind(os, StateKind::CONTINUOUS_TIME);
+                write_values(os, offsets);
+                write_values(os, times);
+                write_values(os, spins);
+                check_stream(os);
+            }
+
+        /**
+         * @brief restore the state written by save_state
+         *
+         * @param is input stream (binary mode)
+         * @param system system with the same interaction
+         */
+        template<typename GraphType, bool eigen_impl>
+            inline void load_state(std::istream& is, ContinuousTimeIsing<GraphType, eigen_impl>& system){
+                using namespace state_io_impl;
+                using CutPoint = typename ContinuousTimeIsing<GraphType, eigen_impl>::CutPoint;
+                using TimeType = typename ContinuousTimeIsing<GraphType, eigen_impl>::TimeType;
+
+                read_kind(is, StateKind::CONTINUOUS_TIME);
+
+                //every timeline has at least one cut point
+                std::vector<std::uint64_t> offsets;
+                read_values(is, offsets, system.num_spins+1);
+                if(offsets.front() != 0){
+                    throw std::runtime_error("load_state: inconsistent timelines");
+                }
+                for(std::size_t i=0; i+1<offsets.size(); i++){
+                    if(!(offsets[i] < offsets[i+1])){
+                        throw std::runtime_error("load_state: inconsistent timelines");
+                    }
+                }
+                const std::uint64_t num_points = offsets.back();
+
+                std::vector<TimeType> times;
+                std::vector<std::int8_t> spins;
+                if(read_array_size<TimeType>(is) != num_points){
+                    throw std::runtime_error("load_state: inconsistent timelines");
+                }
+                read_values_of_size(is, times, static_cast<std::size_t>(num_points));
+                if(read_array_size<std::int8_t>(is) != num_points){
+                    throw std::runtime_error("load_state: inconsistent timelines");
+                }
+                read_values_of_size(is, spins, static_cast<std::size_t>(num_points));
+                for(auto&& spin : spins){
+                    if(spin != 1 && spin != -1){
+                        throw std::runtime_error("load_state: invalid spin");
+                    }
+                }
+
+                //the system is modified only after the whole state is read and validated
+                typename ContinuousTimeIsing<GraphType, eigen_impl>::Timelines timelines;
+                for(std::size_t i=0; i+1<offsets.size(); i++){
+                    for(std::size_t k=offsets[i]; k<offsets[i+1]; k++){
+                        timelines.push_back(CutPoint(times[k], spins[k]));
+                    }
+                    timelines.close_timeline();
+                }
+                system.spin_config.swap(timelines);
+            }
+
+    } // namespace system
+} // namespace openjij
+
+#endif
@@ -15,6 +15,9 @@
 #ifndef OPENJIJ_SYSTEM_SYSTEM_HPP__
 #define OPENJIJ_SYSTEM_SYSTEM_HPP__
 
+#include <memory>
+#include <utility>
+
 #include <utility/type_traits.hpp>
 
 namespace openjij {
@@ -92,6 +95,65 @@ namespace openjij {
             using type = typename utility::get_base_class<typename System::system_type, mc_system, single_command_system, realtime_dynamics_system>::type;
         };
 
+        /**
+         * @brief immutable interaction shared by systems (e.g. replicas on the same model)
+         *
+         * @tparam Interaction type of graph or matrix
+         */
+        template<typename Interaction>
+        using SharedInteraction = std::shared_ptr<const Interaction>;
+
+        namespace shared_interaction_impl {
+
+            /**
+             * @brief deleter of the interactions built by make_shared_interaction; it keeps the writable pointer it owns
+             *
+             * @tparam Interaction type of graph or matrix
+             */
+            template<typename Interaction>
+            struct Owner {
+                Interaction* pointer;
+
+                void operator()(const Interaction* p) const {
+                    delete p;
+                }
+            };
+        } // namespace shared_interaction_impl
+
+        /**
+         * @brief build an interaction to be shared by systems
+         *
+         * @tparam Interaction type of graph or matrix
+         * @param interaction interaction
+         *
+         * @return shared interaction
+         */
+        template<typename Interaction>
+        inline SharedInteraction<Interaction> make_shared_interaction(Interaction interaction) {
+            Interaction* pointer = new Interaction(std::move(interaction));
+            return SharedInteraction<Interaction>(pointer, shared_interaction_impl::Owner<Interaction>{pointer});
+        }
+
+        /**
+         * @brief get a writable interaction; it is copied first unless the caller is the only owner
+         * of an interaction built by make_shared_interaction (copy-on-write).
+         * Interactions from other sources (const objects, non-owning or aliasing pointers) are never written.
+         *
+         * @tparam Interaction type of graph or matrix
+         * @param interaction shared interaction
+         *
+         * @return interaction owned only by the caller
+         */
+        template<typename Interaction>
+        inline Interaction& detach_interaction(SharedInteraction<Interaction>& interaction) {
+            const auto owner = std::get_deleter<shared_interaction_impl::Owner<Interaction>>(interaction);
+            if(interaction.use_count() != 1 || owner == nullptr || owner->pointer != interaction.get()) {
+                interaction = make_shared_interaction(Interaction(*interaction));
+                return *std::get_deleter<shared_interaction_impl::Owner<Interaction>>(interaction)->pointer;
+            }
+            return *owner->pointer;
+        }
+
     } // namespace system
 } // namespace openjij
 
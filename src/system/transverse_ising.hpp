@@ -19,8 +19,13 @@
 #include <system/system.hpp>
 #include <graph/all.hpp>
 #include <utility/eigen.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <utility>
 #include <vector>
 #include <exception>
+#include <stdexcept>
 
 namespace openjij {
     namespace system {
@@ -31,6 +36,145 @@ namespace openjij {
          */
         using TrotterSpins = std::vector<graph::Spins>;
 
+        /**
+         * @brief view of a trotter slice in ContiguousTrotterSpins
+         *
+         * @tparam T spin type (std::int8_t or const std::int8_t)
+         */
+        template<typename T>
+            class TrotterSlice{
+                private:
+                    T* _data;
+                    std::size_t _size;
+
+                public:
+                    TrotterSlice(T* data, std::size_t size) : _data(data), _size(size){}
+
+                    T& operator[](std::size_t i) const{
+                        assert(i < _size);
+                        return _data[i];
+                    }
+
+                    std::size_t size() const{
+                        return _size;
+                    }
+
+                    T* begin() const{
+                        return _data;
+                    }
+
+                    T* end() const{
+                        return _data + _size;
+                    }
+
+                    /**
+                     * @brief copy the spins of the slice
+                     */
+                    operator graph::Spins() const{
+                        return graph::Spins(begin(), end());
+                    }
+
+                    /**
+                     * @brief overwrite the spins of the slice
+                     *
+                     * @param spins spins (size: size())
+                     */
+                    const TrotterSlice& operator=(const graph::Spins& spins) const{
+                        assert(spins.size() == _size);
+                        std::copy(spins.begin(), spins.end(), _data);
+                        return *this;
+                    }
+            };
+
+        /**
+         * @brief trotterized spins stored contiguously (slice-major, 1 byte per spin)
+         * trotter_spins[i][j] -> jth spin in ith trotter slice.
+         */
+        class ContiguousTrotterSpins{
+            private:
+                std::size_t _num_trotter_slices;
+                std::size_t _num_spins;
+                std::vector<std::int8_t> _spins;
+
+            public:
+
+                /**
+                 * @brief ContiguousTrotterSpins constructor (all spins are +1)
+                 *
+                 * @param num_trotter_slices number of trotter slices
+                 * @param num_spins number of spins in a slice
+                 */
+                ContiguousTrotterSpins(std::size_t num_trotter_slices = 0, std::size_t num_spins = 0)
+                    : _num_trotter_slices(num_trotter_slices), _num_spins(num_spins), _spins(num_trotter_slices*num_spins, 1){}
+
+                /**
+                 * @brief ContiguousTrotterSpins constructor
+                 *
+                 * @param trotter_spins trotterized spins
+                 */
+                explicit ContiguousTrotterSpins(const TrotterSpins& trotter_spins)
+                    : ContiguousTrotterSpins(trotter_spins.size(), trotter_spins.empty() ? 0 : trotter_spins[0].size()){
+                        for(std::size_t t=0; t<_num_trotter_slices; t++){
+                            if(trotter_spins[t].size() != _num_spins){
+                                throw std::invalid_argument("all the trotter slices must have the same number of spins.");
+                            }
+                            (*this)[t] = trotter_spins[t];
+                        }
+                    }
+
+                TrotterSlice<std::int8_t> operator[](std::size_t t){
+                    assert(t < _num_trotter_slices);
+                    return TrotterSlice<std::int8_t>(_spins.data() + t*_num_spins, _num_spins);
+                }
+
+                TrotterSlice<const std::int8_t> operator[](std::size_t t) const{
+                    assert(t < _num_trotter_slices);
+                    return TrotterSlice<const std::int8_t>(_spins.data() + t*_num_spins, _num_spins);
+                }
+
+                /**
+                 * @brief get the number of trotter slices
+                 *
+                 * @return number of trotter slices
+                 */
+                std::size_t size() const{
+                    return _num_trotter_slices;
+                }
+
+                /**
+                 * @brief get the number of spins in a slice
+                 *
+                 * @return number of spins
+                 */
+                std::size_t num_spins() const{
+                    return _num_spins;
+                }
+
+                /**
+                 * @brief raw spins (size: size()*num_spins())
+                 */
+                std::int8_t* data(){
+                    return _spins.data();
+                }
+
+                const std::int8_t* data() const{
+                    return _spins.data();
+                }
+
+                /**
+                 * @brief copy into std::vector based trotter spins
+                 *
+                 * @return trotterized spins
+                 */
+                TrotterSpins to_trotter_spins() const{
+                    TrotterSpins ret;
+                    for(std::size_t t=0; t<_num_trotter_slices; t++){
+                        ret.push_back((*this)[t]);
+                    }
+                    return ret;
+                }
+        };
+
         /**
          * @brief naive TransverseIsing structure with discrete-time trotter spins (no Eigen implementation)
          *
@@ -49,7 +193,16 @@ namespace openjij {
                  * @param init_interaction
                  */
                 TransverseIsing(const TrotterSpins& init_trotter_spins, const GraphType& init_interaction, FloatType gamma)
-                : trotter_spins(init_trotter_spins), interaction(init_interaction), num_classical_spins(init_trotter_spins[0].size()), gamma(gamma){
+                : TransverseIsing(init_trotter_spins, make_shared_interaction(init_interaction), gamma) {}
+
+                /**
+                 * @brief TransverseIsing Constructor with an interaction shared by other systems (couplings are not copied)
+                 *
+                 * @param init_trotter_spins
+                 * @param init_interaction
+                 */
+                TransverseIsing(const TrotterSpins& init_trotter_spins, SharedInteraction<GraphType> init_interaction, FloatType gamma)
+                : trotter_spins(init_trotter_spins), interaction(std::move(init_interaction)), num_classical_spins(init_trotter_spins[0].size()), gamma(gamma){
                     //assert(trotter_spins.size() >= 2);
                     if(!(trotter_spins.size() >= 2)){
                         throw std::invalid_argument("trotter slices must be equal or larger than 2.");
@@ -64,15 +217,23 @@ namespace openjij {
                  * @param num_trotter_slices
                  */
                 TransverseIsing(const graph::Spins& classical_spins, const GraphType& init_interaction, FloatType gamma, size_t num_trotter_slices)
-                : trotter_spins(num_trotter_slices), interaction(init_interaction), num_classical_spins(classical_spins.size()), gamma(gamma){
+                : TransverseIsing(classical_spins, make_shared_interaction(init_interaction), gamma, num_trotter_slices) {}
+
+                /**
+                 * @brief TransverseIsing Constuctor with initial classical spins and an interaction shared by other systems
+                 *
+                 * @param classical_spins initial classical spins
+                 * @param init_interaction
+                 * @param num_trotter_slices
+                 */
+                TransverseIsing(const graph::Spins& classical_spins, SharedInteraction<GraphType> init_interaction, FloatType gamma, size_t num_trotter_slices)
+                : trotter_spins(num_trotter_slices, classical_spins.size()), interaction(std::move(init_interaction)), num_classical_spins(classical_spins.size()), gamma(gamma){
                     //initialize trotter_spins with classical_spins
                     if(!(trotter_spins.size() >= 2)){
                         throw std::invalid_argument("trotter slices must be equal or larger than 2.");
                     }
 
-                    for(auto& spins : trotter_spins){
-                        spins = classical_spins;
-                    }
+                    reset_spins(classical_spins);
                 }
 
                 /**
@@ -81,7 +242,8 @@ namespace openjij {
                  * @param init_trotter_spins
                  */
                 void reset_spins(const TrotterSpins& init_trotter_spins){
-                    this->trotter_spins = init_trotter_spins;
+                    this->trotter_spins = ContiguousTrotterSpins(init_trotter_spins);
+                    invalidate_local_fields();
                 }
                 
                 /**
@@ -90,20 +252,63 @@ namespace openjij {
                  * @param classical_spins
                  */
                 void reset_spins(const graph::Spins& classical_spins){
-                    for(auto& spins : this->trotter_spins){
-                        spins = classical_spins;
+                    for(std::size_t t=0; t<trotter_spins.size(); t++){
+                        trotter_spins[t] = classical_spins;
+                    }
+                    invalidate_local_fields();
+                }
+
+                /**
+                 * @brief mark the cached local fields as stale (call after changing trotter_spins or interaction directly)
+                 */
+                void invalidate_local_fields(){
+                    local_fields_valid = false;
+                }
+
+                /**
+                 * @brief recompute the local fields of all the trotter slices from scratch
+                 * (graph must provide adj_nodes, i.e. Dense, Sparse or derived class of them)
+                 */
+                void refresh_local_fields(){
+                    local_field.assign(trotter_spins.size()*num_classical_spins, 0);
+                    for(std::size_t t=0; t<trotter_spins.size(); t++){
+                        const auto slice = trotter_spins[t];
+                        FloatType* field = &local_field[t*num_classical_spins];
+                        for(std::size_t i=0; i<num_classical_spins; i++){
+                            for(auto&& j : interaction->adj_nodes(i)){
+                                field[i] += (i != j) ? interaction->J(i, j) * slice[j] : interaction->h(i);
+                            }
+                        }
                     }
+                    local_fields_valid = true;
+                }
+
+                /**
+                 * @brief flip a spin and update the local fields of its neighbors in the slice (local fields must be valid)
+                 *
+                 * @param index_trot trotter slice
+                 * @param index spin
+                 */
+                void flip(std::size_t index_trot, std::size_t index){
+                    assert(local_fields_valid);
+                    auto slice = trotter_spins[index_trot];
+                    FloatType* field = &local_field[index_trot*num_classical_spins];
+                    const FloatType diff = -2 * slice[index];
+                    for(auto&& j : interaction->adj_nodes(index)){
+                        if(index != j) field[j] += interaction->J(index, j) * diff;
+                    }
+                    slice[index] = -slice[index];
                 }
 
                 /**
                  * @brief trotterlized spins
                  */
-                TrotterSpins trotter_spins;
+                ContiguousTrotterSpins trotter_spins;
 
                 /**
-                 * @brief interaction 
+                 * @brief interaction (shared by the copies of this system)
                  */
-                const GraphType interaction;
+                SharedInteraction<GraphType> interaction;
 
                 /**
                  * @brief number of real classical spins (dummy spin excluded)
@@ -114,6 +319,17 @@ namespace openjij {
                  * @brief coefficient of transverse field term
                  */
                 FloatType gamma;
+
+                /**
+                 * @brief cached local fields h_i + \sum_j J_{ij} s_j^{(t)} (slice-major, t*num_classical_spins + i),
+                 * maintained by the single spin flip updater
+                 */
+                std::vector<FloatType> local_field;
+
+                /**
+                 * @brief whether local_field matches the current spins and interaction
+                 */
+                bool local_fields_valid = false;
             };
 
         //TODO: unify Dense and Sparse Eigen-implemented TransverselIsing struct
@@ -140,7 +356,7 @@ namespace openjij {
                  */
                 TransverseIsing(const TrotterSpins& init_trotter_spins, const graph::Dense<FloatType>& init_interaction, FloatType gamma)
                 : trotter_spins(utility::gen_matrix_from_trotter_spins<FloatType, Eigen::ColMajor>(init_trotter_spins)),
-                interaction(utility::gen_matrix_from_graph<Eigen::RowMajor>(init_interaction)),
+                interaction(make_shared_interaction<MatrixXx>(utility::gen_matrix_from_graph<Eigen::RowMajor>(init_interaction))),
                 num_classical_spins(init_trotter_spins[0].size()), gamma(gamma){
                     if(!(init_trotter_spins.size() >= 2)){
                         throw std::invalid_argument("trotter slices must be equal or larger than 2.");
@@ -155,7 +371,7 @@ namespace openjij {
                  * @param num_trotter_slices
                  */
                 TransverseIsing(const graph::Spins& init_classical_spins, const graph::Dense<FloatType>& init_interaction, FloatType gamma, size_t num_trotter_slices)
-                :interaction(utility::gen_matrix_from_graph<Eigen::RowMajor>(init_interaction)),
+                :interaction(make_shared_interaction<MatrixXx>(utility::gen_matrix_from_graph<Eigen::RowMajor>(init_interaction))),
                  num_classical_spins(init_classical_spins.size()), gamma(gamma){
                     //initialize trotter_spins with classical_spins
 
@@ -180,6 +396,7 @@ namespace openjij {
                  */
                 void reset_spins(const TrotterSpins& init_trotter_spins){
                     this->trotter_spins = utility::gen_matrix_from_trotter_spins<FloatType, Eigen::ColMajor>(init_trotter_spins);
+                    invalidate_local_fields();
                 }
                 
                 /**
@@ -195,6 +412,7 @@ namespace openjij {
                     }
                     //init trotter_spins
                     this->trotter_spins = utility::gen_matrix_from_trotter_spins<FloatType, Eigen::ColMajor>(init_trotter_spins);
+                    invalidate_local_fields();
                 }
 
                 /**
@@ -203,9 +421,9 @@ namespace openjij {
                 TrotterMatrix trotter_spins;
 
                 /**
-                 * @brief interaction 
+                 * @brief interaction matrix (shared by the copies of this system)
                  */
-                const MatrixXx interaction;
+                SharedInteraction<MatrixXx> interaction;
 
                 /**
                  * @brief number of real classical spins (dummy spin excluded)
@@ -216,6 +434,44 @@ namespace openjij {
                  * @brief coefficient of transverse field term
                  */
                 FloatType gamma;
+
+                /**
+                 * @brief mark the cached local fields as stale (call after changing trotter_spins or interaction directly)
+                 */
+                void invalidate_local_fields(){
+                    local_fields_valid = false;
+                }
+
+                /**
+                 * @brief recompute the local fields of all the trotter slices from scratch
+                 */
+                void refresh_local_fields(){
+                    local_field = *interaction * trotter_spins;
+                    local_fields_valid = true;
+                }
+
+                /**
+                 * @brief flip a spin and update the local fields of the slice (local fields must be valid)
+                 *
+                 * @param index_trot trotter slice
+                 * @param index spin
+                 */
+                void flip(std::size_t index_trot, std::size_t index){
+                    assert(local_fields_valid);
+                    assert(index < num_classical_spins);
+                    local_field.col(index_trot) += (-2 * trotter_spins(index, index_trot)) * interaction->row(index).transpose();
+                    trotter_spins(index, index_trot) *= -1;
+                }
+
+                /**
+                 * @brief cached local fields (interaction * trotter_spins), maintained by the single spin flip updater
+                 */
+                TrotterMatrix local_field;
+
+                /**
+                 * @brief whether local_field matches the current spins and interaction
+                 */
+                bool local_fields_valid = false;
             };
 
         /**
@@ -240,7 +496,7 @@ namespace openjij {
                  */
                 TransverseIsing(const TrotterSpins& init_trotter_spins, const graph::Sparse<FloatType>& init_interaction, FloatType gamma)
                 :trotter_spins(utility::gen_matrix_from_trotter_spins<FloatType, Eigen::ColMajor>(init_trotter_spins)),
-                interaction(utility::gen_matrix_from_graph<Eigen::RowMajor>(init_interaction)),
+                interaction(make_shared_interaction<SparseMatrixXx>(utility::gen_matrix_from_graph<Eigen::RowMajor>(init_interaction))),
                 num_classical_spins(init_trotter_spins[0].size()), gamma(gamma){
                     if(!(init_trotter_spins.size() >= 2)){
                         throw std::invalid_argument("trotter slices must be equal or larger than 2.");
@@ -255,7 +511,7 @@ namespace openjij {
                  * @param num_trotter_slices
                  */
                 TransverseIsing(const graph::Spins& init_classical_spins, const graph::Sparse<FloatType>& init_interaction, FloatType gamma, size_t num_trotter_slices)
-                :interaction(utility::gen_matrix_from_graph<Eigen::RowMajor>(init_interaction)),
+                :interaction(make_shared_interaction<SparseMatrixXx>(utility::gen_matrix_from_graph<Eigen::RowMajor>(init_interaction))),
                 num_classical_spins(init_classical_spins.size()), gamma(gamma){
                     //initialize trotter_spins with classical_spins
 
@@ -281,6 +537,7 @@ namespace openjij {
                  */
                 void reset_spins(const TrotterSpins& init_trotter_spins){
                     this->trotter_spins = utility::gen_matrix_from_trotter_spins<FloatType, Eigen::ColMajor>(init_trotter_spins);
+                    invalidate_local_fields();
                 }
                 
                 /**
@@ -296,6 +553,7 @@ namespace openjij {
                     }
                     //init trotter_spins
                     this->trotter_spins = utility::gen_matrix_from_trotter_spins<FloatType, Eigen::ColMajor>(init_trotter_spins);
+                    invalidate_local_fields();
                 }
                 /**
                  * @brief trotterlized spins
@@ -303,9 +561,9 @@ namespace openjij {
                 TrotterMatrix trotter_spins;
 
                 /**
-                 * @brief interaction 
+                 * @brief interaction matrix (shared by the copies of this system)
                  */
-                const SparseMatrixXx interaction;
+                SharedInteraction<SparseMatrixXx> interaction;
 
                 /**
                  * @brief number of real classical spins (dummy spin excluded)
@@ -316,6 +574,44 @@ namespace openjij {
                  * @brief coefficient of transverse field term
                  */
                 FloatType gamma;
+
+                /**
+                 * @brief mark the cached local fields as stale (call after changing trotter_spins or interaction directly)
+                 */
+                void invalidate_local_fields(){
+                    local_fields_valid = false;
+                }
+
+                /**
+                 * @brief recompute the local fields of all the trotter slices from scratch
+                 */
+                void refresh_local_fields(){
+                    local_field = *interaction * trotter_spins;
+                    local_fields_valid = true;
+                }
+
+                /**
+                 * @brief flip a spin and update the local fields of the slice (local fields must be valid)
+                 *
+                 * @param index_trot trotter slice
+                 * @param index spin
+                 */
+                void flip(std::size_t index_trot, std::size_t index){
+                    assert(local_fields_valid);
+                    assert(index < num_classical_spins);
+                    local_field.col(index_trot) += (-2 * trotter_spins(index, index_trot)) * interaction->row(index).transpose();
+                    trotter_spins(index, index_trot) *= -1;
+                }
+
+                /**
+                 * @brief cached local fields (interaction * trotter_spins), maintained by the single spin flip updater
+                 */
+                TrotterMatrix local_field;
+
+                /**
+                 * @brief whether local_field matches the current spins and interaction
+                 */
+                bool local_fields_valid = false;
             };
 
         /**
@@ -350,6 +646,22 @@ namespace openjij {
             TransverseIsing<GraphType, eigen_impl> make_transverse_ising(const graph::Spins& classical_spins, const GraphType& init_interaction, double gamma, std::size_t num_trotter_slices){
                 return TransverseIsing<GraphType, eigen_impl>(classical_spins, init_interaction, static_cast<typename GraphType::value_type>(gamma), num_trotter_slices);
             }
+
+        /**
+         * @brief helper function for TransverseIsing constructor with a shared interaction
+         *
+         * @tparam GraphType
+         * @param classical_spins initial classical spins
+         * @param init_interaction interaction shared with other systems
+         * @param gamma coefficient of transverse field term
+         * @param num_trotter_slices number of trotter slices
+         *
+         * @return generated object
+         */
+        template<typename GraphType>
+            TransverseIsing<GraphType, false> make_transverse_ising(const graph::Spins& classical_spins, SharedInteraction<GraphType> init_interaction, double gamma, std::size_t num_trotter_slices){
+                return TransverseIsing<GraphType, false>(classical_spins, std::move(init_interaction), static_cast<typename GraphType::value_type>(gamma), num_trotter_slices);
+            }
     } // namespace system
 } // namespace openjij
 
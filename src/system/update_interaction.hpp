@@ -0,0 +1,146 @@
+//    Copyright 2019 Jij Inc.
+
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+
+//        http://www.apache.org/licenses/LICENSE-2.0
+
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+
+#ifndef OPENJIJ_SYSTEM_UPDATE_INTERACTION_HPP__
+#define OPENJIJ_SYSTEM_UPDATE_INTERACTION_HPP__
+
+#include <cassert>
+#include <cstddef>
+
+#include <Eigen/Dense>
+#include <Eigen/Sparse>
+
+#include <graph/delta.hpp>
+#include <system/classical_ising.hpp>
+#include <system/transverse_ising.hpp>
+
+namespace openjij {
+    namespace system {
+
+        namespace update_interaction_impl{
+
+            /**
+             * @brief write the entries into an interaction matrix with a dummy spin (index num_spins) carrying the local fields
+             */
+            template<typename MatrixType, typename FloatType>
+                inline void apply(MatrixType& interaction, std::size_t num_spins, const graph::Delta<FloatType>& delta){
+                    for(auto&& e : delta.entries()){
+                        assert(e.i < num_spins && e.j < num_spins);
+                        const std::size_t i = e.i;
+                        const std::size_t j = (e.i == e.j) ? num_spins : e.j;
+                        interaction.coeffRef(i, j) = e.value;
+                        interaction.coeffRef(j, i) = e.value;
+                    }
+                }
+
+            /**
+             * @brief write the entries into a sparse interaction matrix (new elements are inserted)
+             */
+            template<typename FloatType, int Options>
+                inline void apply(Eigen::SparseMatrix<FloatType, Options>& interaction, std::size_t num_spins, const graph::Delta<FloatType>& delta){
+                    for(auto&& e : delta.entries()){
+                        assert(e.i < num_spins && e.j < num_spins);
+                        const std::size_t i = e.i;
+                        const std::size_t j = (e.i == e.j) ? num_spins : e.j;
+                        interaction.coeffRef(i, j) = e.value;
+                        interaction.coeffRef(j, i) = e.value;
+                    }
+                    if(!interaction.isCompressed()){
+                        interaction.makeCompressed();
+                    }
+                }
+        } // namespace update_interaction_impl
+
+        /**
+         * @brief apply changed interactions to a classical ising system in place (spins are kept, a shared interaction is copied first)
+         *
+         * @tparam GraphType type of graph (assume Dense, Sparse)
+         * @param system classical ising system
+         * @param delta changed interactions
+         */
+        template<typename GraphType>
+            inline void update_interaction(ClassicalIsing<GraphType, false>& system, const graph::Delta<typename GraphType::value_type>& delta){
+                delta.apply(detach_interaction(system.interaction));
+                invalidate_local_fields(system);
+            }
+
+        /**
+         * @brief apply changed interactions to a classical ising system in place (spins are kept, a shared interaction is copied first)
+         *
+         * @tparam FloatType floating-point type
+         * @param system classical ising system (Eigen implementation)
+         * @param delta changed interactions
+         */
+        template<typename FloatType>
+            inline void update_interaction(ClassicalIsing<graph::Dense<FloatType>, true>& system, const graph::Delta<FloatType>& delta){
+                update_interaction_impl::apply(detach_interaction(system.interaction), system.num_spins, delta);
+                system.invalidate_local_fields();
+            }
+
+        /**
+         * @brief apply changed interactions to a classical ising system in place (spins are kept, a shared interaction is copied first)
+         *
+         * @tparam FloatType floating-point type
+         * @param system classical ising system (Eigen implementation)
+         * @param delta changed interactions
+         */
+        template<typename FloatType>
+            inline void update_interaction(ClassicalIsing<graph::Sparse<FloatType>, true>& system, const graph::Delta<FloatType>& delta){
+                update_interaction_impl::apply(detach_interaction(system.interaction), system.num_spins, delta);
+                system.invalidate_local_fields();
+            }
+
+        /**
+         * @brief apply changed interactions to a transverse ising system in place (spins are kept, a shared interaction is copied first)
+         *
+         * @tparam GraphType type of graph (assume Dense, Sparse)
+         * @param system transverse ising system
+         * @param delta changed interactions
+         */
+        template<typename GraphType>
+            inline void update_interaction(TransverseIsing<GraphType, false>& system, const graph::Delta<typename GraphType::value_type>& delta){
+                delta.apply(detach_interaction(system.interaction));
+                system.invalidate_local_fields();
+            }
+
+        /**
+         * @brief apply changed interactions to a transverse ising system in place (spins are kept, a shared interaction is copied first)
+         *
+         * @tparam FloatType floating-point type
+         * @param system transverse ising system (Eigen implementation)
+         * @param delta changed interactions
+         */
+        template<typename FloatType>
+            inline void update_interaction(TransverseIsing<graph::Dense<FloatType>, true>& system, const graph::Delta<FloatType>& delta){
+                update_interaction_impl::apply(detach_interaction(system.interaction), system.num_classical_spins, delta);
+                system.invalidate_local_fields();
+            }
+
+        /**
+         * @brief apply changed interactions to a transverse ising system in place (spins are kept, a shared interaction is copied first)
+         *
+         * @tparam FloatType floating-point type
+         * @param system transverse ising system (Eigen implementation)
+         * @param delta changed interactions
+         */
+        template<typename FloatType>
+            inline void update_interaction(TransverseIsing<graph::Sparse<FloatType>, true>& system, const graph::Delta<FloatType>& delta){
+                update_interaction_impl::apply(detach_interaction(system.interaction), system.num_classical_spins, delta);
+                system.invalidate_local_fields();
+            }
+
+    } // namespace system
+} // namespace openjij
+
+#endif
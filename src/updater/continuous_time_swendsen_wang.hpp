@@ -20,7 +20,6 @@
 #include <algorithm>
 #include <cmath>
 #include <cassert>
-#include <unordered_map>
 
 #include <graph/all.hpp>
 #include <system/continuous_time_ising.hpp>
@@ -48,77 +47,69 @@ namespace openjij {
                                const utility::TransverseFieldUpdaterParameter& parameter) {
 
                 const graph::Index num_spin = system.num_spins;
-                std::vector<graph::Index> index_helper;
-                index_helper.reserve(num_spin+1);
-                index_helper.push_back(0);
-                /* index_helper[i]+k gives 1 dimensionalized index of kth time point at ith site.
-                 * this helps use of union-find tree only available for 1D structure.
-                 */
+                auto& workspace = system.workspace;
+                auto& points = workspace.points;
 
                 /* 1. remove old cuts and place new cuts for every site */
+                auto& next_config = workspace.next_config;
+                next_config.clear();
                 for(graph::Index i = 0;i < num_spin;i++) {
-                    auto& timeline = system.spin_config[i];
-                    auto cuts = generate_poisson_points(0.5*system.gamma*(1.0-parameter.s), parameter.beta, random_number_engine);
+                    const auto timeline = system.spin_config[i];
+                    generate_poisson_points(0.5*system.gamma*(1.0-parameter.s), parameter.beta, random_number_engine, points);
                     // assuming transverse field gamma is positive
 
-                    timeline = create_timeline(timeline, cuts);
-                    assert(timeline.size() > 0);
-
-                    index_helper.push_back(index_helper.back()+timeline.size());
+                    merge_timeline(timeline.begin(), timeline.end(), points.begin(), points.end(), next_config);
+                    next_config.close_timeline();
+                    assert(next_config[i].size() > 0);
                 }
+                system.spin_config.swap(next_config);
+
+                const auto& index_helper = system.spin_config.offsets();
+                /* index_helper[i]+k gives 1 dimensionalized index of kth time point at ith site.
+                 * this helps use of union-find tree only available for 1D structure.
+                 */
 
                 /* 2. place spacial bonds */
-                utility::UnionFind union_find_tree(index_helper.back());
+                auto& union_find_tree = workspace.union_find_tree;
+                union_find_tree.reset(index_helper.back());
                 for(graph::Index i = 0;i < num_spin;i++) {
-                    for(auto&& j : system.interaction.adj_nodes(i)) {
+                    for(auto&& j : system.interaction->adj_nodes(i)) {
                         if (i < j) {
                             continue; // ignore duplicated interaction
                                       // if adj_nodes are sorted, this "continue" can be replaced by "break"
                         }
 
-                        const auto bonds = generate_poisson_points(std::abs(0.5*system.interaction.J(i, j)*parameter.s),
-                                                                   parameter.beta, random_number_engine);
-                        for(const auto bond : bonds) {
+                        generate_poisson_points(std::abs(0.5*system.interaction->J(i, j)*parameter.s),
+                                                parameter.beta, random_number_engine, points);
+                        for(const auto bond : points) {
                             /* get time point indices just before the bond */
                             auto ki = system.get_temporal_spin_index(i, bond);
                             auto kj = system.get_temporal_spin_index(j, bond);
 
-                            if(system.spin_config[i][ki].second * system.spin_config[j][kj].second * system.interaction.J(i, j) < 0) {
+                            if(system.spin_config[i][ki].second * system.spin_config[j][kj].second * system.interaction->J(i, j) < 0) {
                                 union_find_tree.unite_sets(index_helper[i]+ki, index_helper[j]+kj);
                             }
                         }
                     }
                 }
 
-                /* 3. make clusters */
-                std::unordered_map<utility::UnionFind::Node, std::vector<utility::UnionFind::Node>> cluster_map;
-                // root-index to {contained nodes} map
+                /* 3. flip clusters; the flip of a cluster is decided when its root is first visited */
+                auto& cluster_flip = workspace.cluster_flip;
+                cluster_flip.assign(index_helper.back(), -1);
 
+                auto urd = std::uniform_real_distribution<>(0, 1.0);
                 for(graph::Index i = 0;i < num_spin;i++) {
-                    for(size_t k = 0;k < system.spin_config[i].size();k++) {
-                        auto index = index_helper[i] + k;
-                        auto root_index = union_find_tree.find_set(index);
-                        auto position = cluster_map.find(root_index);
-                        if(position == cluster_map.end()) {
-                            cluster_map.emplace(root_index, std::vector<utility::UnionFind::Node>{ index });
-                        } else {
-                            position->second.push_back(index);
+                    const auto timeline = system.spin_config[i];
+                    for(size_t k = 0;k < timeline.size();k++) {
+                        auto root_index = union_find_tree.find_set(index_helper[i] + k);
+                        if(cluster_flip[root_index] < 0) {
+                            // 3.1. decide spin state (flip with the probability 1/2)
+                            const FloatType probability = 1.0 / 2.0;
+                            cluster_flip[root_index] = (urd(random_number_engine) < probability) ? 1 : 0;
                         }
-                    }
-                }
-
-                /* 4. flip clusters */
-                auto urd = std::uniform_real_distribution<>(0, 1.0);
-                for(const auto& cluster : cluster_map) {
-                    // 4.1. decide spin state (flip with the probability 1/2)
-                    const FloatType probability = 1.0 / 2.0;
-                    if(urd(random_number_engine) < probability){
-                        // 4.2. update spin states
-                        for(auto node : cluster.second) {
-                            auto i = std::distance(index_helper.begin(),
-                                                   std::upper_bound(index_helper.begin(), index_helper.end(), node)) - 1;
-                            auto k = node - index_helper[i];
-                            system.spin_config[i][k].second *= -1;
+                        // 3.2. update spin states
+                        if(cluster_flip[root_index] == 1) {
+                            timeline[k].second *= -1;
                         }
                     }
                 }
@@ -130,61 +121,71 @@ namespace openjij {
              */
             static std::vector<CutPoint> create_timeline(const std::vector<CutPoint>& old_timeline,
                                                          const std::vector<TimeType>& cuts) {
-                /* remove redundant cuts*/
-                std::vector<CutPoint> concatenated_timeline;
-                auto current_spin = old_timeline.back().second;
-                for(auto cut_point : old_timeline) {
-                    if(cut_point.second != current_spin) {
-                        concatenated_timeline.push_back(cut_point);
-                    }
-                    current_spin = cut_point.second;
-                }
+                std::vector<CutPoint> new_timeline;
+                merge_timeline(old_timeline.begin(), old_timeline.end(), cuts.begin(), cuts.end(), new_timeline);
+                return new_timeline;
+            }
+
+            /**
+             * @brief append a new timeline to new_timeline; place kinks of [first, last) by ignoring old cuts and place new cuts
+             *
+             * @param first begin of old timeline
+             * @param last end of old timeline
+             * @param cut_first begin of sorted new cuts
+             * @param cut_last end of sorted new cuts
+             * @param new_timeline output which has push_back(CutPoint) (std::vector or SpinTimelines)
+             */
+            template<typename CutPointIterator, typename TimeIterator, typename Timeline>
+            static void merge_timeline(CutPointIterator first, CutPointIterator last,
+                                       TimeIterator cut_first, TimeIterator cut_last,
+                                       Timeline& new_timeline) {
+                assert(first != last);
+
+                /* redundant cuts (no change of spin state) are skipped while merging */
+                auto current_spin = (last - 1)->second;
+                auto timeline_itr = skip_redundant_cuts(first, last, current_spin);
 
                 /* if entire timeline is occupied by single spin state */
-                std::vector<CutPoint> new_timeline;
-                if(concatenated_timeline.empty()) {
-                    if(cuts.empty()) {
-                        new_timeline.push_back(old_timeline[0]);
+                if(timeline_itr == last) {
+                    if(cut_first == cut_last) {
+                        new_timeline.push_back(*first);
                     } else {
-                        for(auto cut : cuts) {
-                            new_timeline.push_back(CutPoint(cut, current_spin));
+                        for(;cut_first != cut_last;cut_first++) {
+                            new_timeline.push_back(CutPoint(*cut_first, current_spin));
                         }
                     }
-                    return new_timeline;
+                    return;
                 }
 
-                current_spin = concatenated_timeline.back().second;
-                auto timeline_itr = concatenated_timeline.begin();
-                auto cuts_itr = cuts.begin();
                 while(true) {
                     /* if all cuts have been placed, add remaining old kinks and break loop */
-                    if(cuts_itr == cuts.end()) {
-                        std::for_each(timeline_itr, concatenated_timeline.end(), [&](CutPoint it) {
-                                new_timeline.push_back(it);
-                            });
+                    if(cut_first == cut_last) {
+                        while(timeline_itr != last) {
+                            new_timeline.push_back(*timeline_itr);
+                            current_spin = timeline_itr->second;
+                            timeline_itr = skip_redundant_cuts(timeline_itr + 1, last, current_spin);
+                        }
                         break;
                     }
 
                     /* if all spin kinks have been placed, add remaining cuts and break loop */
-                    if(timeline_itr == concatenated_timeline.end()) {
-                        std::for_each(cuts_itr, cuts.end(), [&](TimeType it) {
-                                new_timeline.push_back(CutPoint(it, current_spin));
-                            });
+                    if(timeline_itr == last) {
+                        for(;cut_first != cut_last;cut_first++) {
+                            new_timeline.push_back(CutPoint(*cut_first, current_spin));
+                        }
                         break;
                     }
 
                     /* add earlier of kink or cut to new timeline */
-                    if(*cuts_itr < timeline_itr->first) {
-                        new_timeline.push_back(CutPoint(*cuts_itr, current_spin));
-                        cuts_itr++;
+                    if(*cut_first < timeline_itr->first) {
+                        new_timeline.push_back(CutPoint(*cut_first, current_spin));
+                        cut_first++;
                     } else {
                         new_timeline.push_back(*timeline_itr);
                         current_spin = timeline_itr->second;
-                        timeline_itr++;
+                        timeline_itr = skip_redundant_cuts(timeline_itr + 1, last, current_spin);
                     }
                 }
-
-                return new_timeline;
             }
 
             /**
@@ -238,6 +239,19 @@ namespace openjij {
             template<typename RandomNumberEngine>
             static std::vector<TimeType> generate_poisson_points(const TimeType lambda, const TimeType beta,
                                                                  RandomNumberEngine& random_number_engine) {
+                std::vector<TimeType> poisson_points;
+                generate_poisson_points(lambda, beta, random_number_engine, poisson_points);
+                return poisson_points;
+            }
+
+            /**
+             * @brief generates Poisson points with density lambda in the range of [0:beta) into poisson_points (memory is reused)
+             *
+             */
+            template<typename RandomNumberEngine>
+            static void generate_poisson_points(const TimeType lambda, const TimeType beta,
+                                                RandomNumberEngine& random_number_engine,
+                                                std::vector<TimeType>& poisson_points) {
                 std::uniform_real_distribution<> rand(0.0, 1.0);
                 std::uniform_real_distribution<> rand_beta(0.0, beta);
 
@@ -253,13 +267,26 @@ namespace openjij {
                     p += d;
                 }
 
-                std::vector<TimeType> poisson_points(n);
+                poisson_points.resize(n);
                 for(int k = 0;k < n;k++) {
                     poisson_points[k] = rand_beta(random_number_engine);
                 }
                 std::sort(poisson_points.begin(), poisson_points.end());
+            }
 
-                return poisson_points;
+        private:
+
+            /**
+             * @brief skip time points which do not change the spin state
+             *
+             * @return first time point in [first, last) whose spin differs from current_spin
+             */
+            template<typename CutPointIterator>
+            static CutPointIterator skip_redundant_cuts(CutPointIterator first, CutPointIterator last, graph::Spin current_spin) {
+                while(first != last && first->second == current_spin) {
+                    first++;
+                }
+                return first;
             }
         };
     } // namespace updater
@@ -14,10 +14,19 @@
 #ifndef OPENJIJ_UPDATER_SINGLE_SPIN_FLIP_HPP__
 #define OPENJIJ_UPDATER_SINGLE_SPIN_FLIP_HPP__
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <random>
+#include <type_traits>
+#include <vector>
 
 #include <system/classical_ising.hpp>
 #include <system/transverse_ising.hpp>
+#include <system/classical_ising_polynomial.hpp>
+#include <system/packed_ising.hpp>
+#include <system/multi_spin_classical_ising.hpp>
+#include <system/batched_classical_ising.hpp>
 #include <utility/schedule_list.hpp>
 
 namespace openjij {
@@ -49,6 +58,59 @@ namespace openjij {
              */
             using FloatType = typename GraphType::value_type;
 
+            /**
+             * @brief operate single spin flip in a classical ising system
+             *
+             * @param system object of a classical ising system
+             * @param random_number_engine random number gengine
+             * @param parameter parameter object including inverse temperature \f\beta:=(k_B T)^{-1}\f
+             *
+             * @return energy difference \f\Delta E\f
+             */
+          template<typename RandomNumberEngine>
+            inline static void update(ClIsing& system,
+                                 RandomNumberEngine& random_numder_engine,
+                                 const utility::ClassicalUpdaterParameter& parameter) {
+                // set probability distribution object
+                // to select candidate for flip at random
+                auto uid = std::uniform_int_distribution<std::size_t>(0, system.spin.size()-1);
+                // to do Metropolis
+                auto urd = std::uniform_real_distribution<>(0, 1.0);
+
+                if (!system.local_fields_valid) {
+                    system.refresh_local_fields();
+                }
+
+                for (std::size_t time = 0, num_spins = system.spin.size(); time < num_spins; ++time) {
+                    // index of spin selected at random
+                    const auto index = uid(random_numder_engine);
+                    assert(index < num_spins);
+
+                    // local energy difference (cached local field)
+                    const FloatType dE = system.energy_difference(index);
+
+                    // Flip the spin? (only accepted flips update the neighboring fields)
+                    if (dE < 0 || std::exp( -parameter.beta * dE) > urd(random_numder_engine)) {
+                        system.flip(index);
+                    }
+                }
+            }
+        };
+
+
+        /**
+         * @brief single spin flip for classical ising model on a CSRSparse graph
+         *
+         * @tparam FloatType floating-point type
+         */
+        template<typename FloatType>
+        struct SingleSpinFlip<system::ClassicalIsing<graph::CSRSparse<FloatType>, false>> {
+
+            /**
+             * @brief ClassicalIsing type
+             */
+            using ClIsing = system::ClassicalIsing<graph::CSRSparse<FloatType>, false>;
+
             /**
              * @brief operate single spin flip in a classical ising system
              *
@@ -73,22 +135,684 @@ namespace openjij {
                     const auto index = uid(random_numder_engine);
                     assert(index < num_spins);
 
-                    // local energy difference
-                    FloatType dE = 0;
-                    for (auto&& adj_index : system.interaction.adj_nodes(index)) {
-                        dE += -2.0 * system.spin[index] * (index != adj_index ? (system.interaction.J(index, adj_index) * system.spin[adj_index])
-                                                                              :  system.interaction.h(index));
+                    // local field (contiguous row, no hash lookup)
+                    FloatType local_field = system.interaction->h(index);
+                    for (auto&& edge : system.interaction->adj_edges(index)) {
+                        local_field += edge.value * system.spin[edge.index];
+                    }
+
+                    // local energy difference
+                    const FloatType dE = -2.0 * system.spin[index] * local_field;
+
+                    // Flip the spin?
+                    if (dE < 0 || std::exp( -parameter.beta * dE) > urd(random_numder_engine)) {
+                        system.spin[index] *= -1;
+                    }
+                }
+            }
+        };
+
+        /**
+         * @brief single spin flip for classical ising model with bit-packed spins on a CSRSparse graph
+         *
+         * @tparam FloatType floating-point type
+         */
+        template<typename FloatType>
+        struct SingleSpinFlip<system::ClassicalIsingPacked<graph::CSRSparse<FloatType>>> {
+
+            /**
+             * @brief ClassicalIsingPacked type
+             */
+            using ClIsing = system::ClassicalIsingPacked<graph::CSRSparse<FloatType>>;
+
+            /**
+             * @brief operate single spin flip in a classical ising system
+             *
+             * @param system object of a classical ising system
+             * @param random_number_engine random number gengine
+             * @param parameter parameter object including inverse temperature \f\beta:=(k_B T)^{-1}\f
+             *
+             * @return energy difference \f\Delta E\f
+             */
+          template<typename RandomNumberEngine>
+            inline static void update(ClIsing& system,
+                                 RandomNumberEngine& random_numder_engine,
+                                 const utility::ClassicalUpdaterParameter& parameter) {
+                // set probability distribution object
+                // to select candidate for flip at random
+                auto uid = std::uniform_int_distribution<std::size_t>(0, system.num_spins-1);
+                // to do Metropolis
+                auto urd = std::uniform_real_distribution<>(0, 1.0);
+
+                for (std::size_t time = 0; time < system.num_spins; ++time) {
+                    // index of spin selected at random
+                    const auto index = uid(random_numder_engine);
+                    assert(index < system.num_spins);
+
+                    // local field (spins are read bit by bit)
+                    FloatType local_field = system.interaction.h(index);
+                    for (auto&& edge : system.interaction.adj_edges(index)) {
+                        local_field += edge.value * system.spin.get(edge.index);
+                    }
+
+                    // local energy difference
+                    const FloatType dE = -2.0 * system.spin.get(index) * local_field;
+
+                    // Flip the spin?
+                    if (dE < 0 || std::exp( -parameter.beta * dE) > urd(random_numder_engine)) {
+                        system.spin.flip(index);
+                    }
+                }
+            }
+        };
+
+        /**
+         * @brief single spin flip for 64 replicas of a \f\pm J\f classical ising model (multi-spin coding)
+         *
+         * For each selected spin, the number of satisfied bonds k of every replica is counted in bit-sliced counters.
+         * Since \f\Delta E = 2 J_0 (2k - d)\f (d: number of bonds), a single random number shared by the replicas
+         * decides a threshold K, and the replicas with k <= K are flipped at once.
+         *
+         * @tparam GraphType graph type
+         */
+        template<typename GraphType>
+        struct SingleSpinFlip<system::MultiSpinClassicalIsing<GraphType>> {
+
+            /**
+             * @brief MultiSpinClassicalIsing type
+             */
+            using MSIsing = system::MultiSpinClassicalIsing<GraphType>;
+
+            using Word = typename MSIsing::Word;
+
+            /**
+             * @brief operate single spin flip in all the replicas
+             *
+             * @param system object of a multi-spin coded classical ising system
+             * @param random_number_engine random number gengine
+             * @param parameter parameter object including inverse temperature \f\beta:=(k_B T)^{-1}\f
+             */
+          template<typename RandomNumberEngine>
+            inline static void update(MSIsing& system,
+                                 RandomNumberEngine& random_numder_engine,
+                                 const utility::ClassicalUpdaterParameter& parameter) {
+                // set probability distribution object
+                // to select candidate for flip at random
+                auto uid = std::uniform_int_distribution<std::size_t>(0, system.num_spins-1);
+                // to do Metropolis (shared by the replicas)
+                auto urd = std::uniform_real_distribution<>(0, 1.0);
+
+                // bit-sliced counters (enough planes for the maximum degree)
+                std::size_t max_degree = 0;
+                for (std::size_t i = 0; i < system.num_spins; ++i) {
+                    max_degree = std::max(max_degree, system.bond_offsets[i+1] - system.bond_offsets[i]);
+                }
+                std::size_t num_planes = 1;
+                while ((std::size_t(1) << num_planes) <= max_degree) ++num_planes;
+                std::vector<Word> planes(num_planes);
+
+                const double scale = 2.0 * parameter.beta * system.magnitude;
+
+                for (std::size_t time = 0; time < system.num_spins; ++time) {
+                    // index of spin selected at random
+                    const auto index = uid(random_numder_engine);
+                    const std::size_t begin = system.bond_offsets[index];
+                    const std::size_t degree = system.bond_offsets[index+1] - begin;
+                    const Word s = system.spin[index];
+
+                    // count satisfied bonds of each replica
+                    std::fill(planes.begin(), planes.end(), Word(0));
+                    for (std::size_t b = begin; b < begin + degree; ++b) {
+                        Word carry = s ^ system.spin[system.bond_nodes[b]] ^ system.bond_signs[b];
+                        for (std::size_t p = 0; p < num_planes && carry; ++p) {
+                            const Word next = planes[p] & carry;
+                            planes[p] ^= carry;
+                            carry = next;
+                        }
+                    }
+
+                    // flip if dE < 0 or exp(-beta dE) > r, i.e. 2k - d < -log(r)/(2 beta J0)
+                    const double r = urd(random_numder_engine);
+                    const double t = (scale > 0 && r > 0) ? -std::log(r) / scale : std::numeric_limits<double>::infinity();
+                    const double bound = std::ceil((degree + t) / 2.0) - 1;
+                    if (bound < 0) continue;
+                    Word accept = ~Word(0);
+                    if (bound < degree) {
+                        // k <= K, compared from the most significant plane
+                        const std::size_t K = static_cast<std::size_t>(bound);
+                        Word less = 0;
+                        Word equal = ~Word(0);
+                        for (std::size_t p = num_planes; p-- > 0;) {
+                            if ((K >> p) & 1) {
+                                less |= equal & ~planes[p];
+                                equal &= planes[p];
+                            }
+                            else {
+                                equal &= ~planes[p];
+                            }
+                        }
+                        accept = less | equal;
+                    }
+                    system.spin[index] ^= accept;
+                }
+            }
+        };
+
+        /**
+         * @brief single spin flip for many replicas of a classical ising model (structure-of-arrays layout)
+         *
+         * The spins are visited in order, and the coupling row of each spin is read once for all the replicas.
+         *
+         * @tparam GraphType graph type
+         */
+        template<typename GraphType>
+        struct SingleSpinFlip<system::BatchedClassicalIsing<GraphType>> {
+
+            /**
+             * @brief BatchedClassicalIsing type
+             */
+            using BIsing = system::BatchedClassicalIsing<GraphType>;
+
+            /**
+             * @brief float type of graph
+             */
+            using FloatType = typename GraphType::value_type;
+
+            /**
+             * @brief operate a sweep of single spin flips in all the replicas
+             *
+             * @param system object of a batched classical ising system
+             * @param random_number_engine random number gengine
+             * @param parameter parameter object including inverse temperature \f\beta:=(k_B T)^{-1}\f
+             */
+          template<typename RandomNumberEngine>
+            inline static void update(BIsing& system,
+                                 RandomNumberEngine& random_numder_engine,
+                                 const utility::ClassicalUpdaterParameter& parameter) {
+                // to do Metropolis
+                auto urd = std::uniform_real_distribution<>(0, 1.0);
+
+                const std::size_t num_replicas = system.num_replicas;
+                std::vector<FloatType> local_field(num_replicas);
+
+                for (std::size_t index = 0; index < system.num_spins; ++index) {
+                    // local fields of all the replicas (one pass over the coupling row)
+                    std::fill(local_field.begin(), local_field.end(), system.fields[index]);
+                    for (std::size_t k = system.row_offsets[index]; k < system.row_offsets[index+1]; ++k) {
+                        const FloatType value = system.adj_values[k];
+                        const FloatType* adj_spin = &system.spin[system.adj_indices[k]*num_replicas];
+                        for (std::size_t r = 0; r < num_replicas; ++r) {
+                            local_field[r] += value * adj_spin[r];
+                        }
+                    }
+
+                    // Flip the spins?
+                    FloatType* spin = &system.spin[index*num_replicas];
+                    for (std::size_t r = 0; r < num_replicas; ++r) {
+                        const FloatType dE = -2 * spin[r] * local_field[r];
+                        if (dE < 0 || std::exp( -parameter.beta * dE) > urd(random_numder_engine)) {
+                            spin[r] *= -1;
+                        }
+                    }
+                }
+            }
+        };
+
+        /**
+         * @brief single spin flip for classical ising model on a DenseMatrix graph
+         *
+         * @tparam FloatType floating-point type
+         */
+        template<typename FloatType>
+        struct SingleSpinFlip<system::ClassicalIsing<graph::DenseMatrix<FloatType>, false>> {
+
+            /**
+             * @brief ClassicalIsing type
+             */
+            using ClIsing = system::ClassicalIsing<graph::DenseMatrix<FloatType>, false>;
+
+            /**
+             * @brief operate single spin flip in a classical ising system
+             *
+             * @param system object of a classical ising system
+             * @param random_number_engine random number gengine
+             * @param parameter parameter object including inverse temperature \f\beta:=(k_B T)^{-1}\f
+             *
+             * @return energy difference \f\Delta E\f
+             */
+          template<typename RandomNumberEngine>
+            inline static void update(ClIsing& system,
+                                 RandomNumberEngine& random_numder_engine,
+                                 const utility::ClassicalUpdaterParameter& parameter) {
+                // set probability distribution object
+                // to select candidate for flip at random
+                auto uid = std::uniform_int_distribution<std::size_t>(0, system.spin.size()-1);
+                // to do Metropolis
+                auto urd = std::uniform_real_distribution<>(0, 1.0);
+
+                for (std::size_t time = 0, num_spins = system.spin.size(); time < num_spins; ++time) {
+                    // index of spin selected at random
+                    const auto index = uid(random_numder_engine);
+                    assert(index < num_spins);
+
+                    // local energy difference (contiguous row dot product)
+                    const FloatType dE = -2.0 * system.spin[index] * system.interaction->local_field(index, system.spin);
+
+                    // Flip the spin?
+                    if (dE < 0 || std::exp( -parameter.beta * dE) > urd(random_numder_engine)) {
+                        system.spin[index] *= -1;
+                    }
+                }
+            }
+        };
+        
+        /**
+         * @brief single spin flip for classical ising model on a Chimera graph
+         *
+         * @tparam FloatType floating-point type
+         */
+        template<typename FloatType>
+        struct SingleSpinFlip<system::ClassicalIsing<graph::Chimera<FloatType>, false>> {
+
+            /**
+             * @brief ClassicalIsing type
+             */
+            using ClIsing = system::ClassicalIsing<graph::Chimera<FloatType>, false>;
+
+            /**
+             * @brief operate single spin flip in a classical ising system
+             *
+             * @param system object of a classical ising system
+             * @param random_number_engine random number gengine
+             * @param parameter parameter object including inverse temperature \f\beta:=(k_B T)^{-1}\f
+             *
+             * @return energy difference \f\Delta E\f
+             */
+          template<typename RandomNumberEngine>
+            inline static void update(ClIsing& system,
+                                 RandomNumberEngine& random_numder_engine,
+                                 const utility::ClassicalUpdaterParameter& parameter) {
+                // set probability distribution object
+                // to select candidate for flip at random
+                auto uid = std::uniform_int_distribution<std::size_t>(0, system.spin.size()-1);
+                // to do Metropolis
+                auto urd = std::uniform_real_distribution<>(0, 1.0);
+
+                for (std::size_t time = 0, num_spins = system.spin.size(); time < num_spins; ++time) {
+                    // index of spin selected at random
+                    const auto index = uid(random_numder_engine);
+                    assert(index < num_spins);
+
+                    // local energy difference (six neighbors at fixed offsets)
+                    const FloatType dE = -2.0 * system.spin[index] * system.couplings.local_field(index, system.spin);
+
+                    // Flip the spin?
+                    if (dE < 0 || std::exp( -parameter.beta * dE) > urd(random_numder_engine)) {
+                        system.spin[index] *= -1;
+                    }
+                }
+            }
+        };
+
+        /**
+         * @brief single spin flip for classical ising model on a Square graph
+         *
+         * Spins are visited in sequential order, row by row within column tiles,
+         * so that the three rows touched by the stencil stay in cache on large lattices.
+         *
+         * @tparam FloatType floating-point type
+         */
+        template<typename FloatType>
+        struct SingleSpinFlip<system::ClassicalIsing<graph::Square<FloatType>, false>> {
+
+            /**
+             * @brief ClassicalIsing type
+             */
+            using ClIsing = system::ClassicalIsing<graph::Square<FloatType>, false>;
+
+            /**
+             * @brief number of columns in a tile
+             */
+            static constexpr std::size_t tile_width = 256;
+
+            /**
+             * @brief operate single spin flip in a classical ising system
+             *
+             * @param system object of a classical ising system
+             * @param random_number_engine random number gengine
+             * @param parameter parameter object including inverse temperature \f\beta:=(k_B T)^{-1}\f
+             *
+             * @return energy difference \f\Delta E\f
+             */
+          template<typename RandomNumberEngine>
+            inline static void update(ClIsing& system,
+                                 RandomNumberEngine& random_numder_engine,
+                                 const utility::ClassicalUpdaterParameter& parameter) {
+                // to do Metropolis
+                auto urd = std::uniform_real_distribution<>(0, 1.0);
+
+                const auto& couplings = system.couplings;
+                const std::size_t num_row = couplings.num_row;
+                const std::size_t num_column = couplings.num_column;
+
+                for (std::size_t c_begin = 0; c_begin < num_column; c_begin += tile_width) {
+                    const std::size_t c_end = std::min(c_begin + tile_width, num_column);
+                    for (std::size_t r = 0; r < num_row; ++r) {
+                        for (std::size_t c = c_begin; c < c_end; ++c) {
+                            const std::size_t index = r*num_column + c;
+
+                            // local energy difference (five-point stencil)
+                            const FloatType dE = -2.0 * system.spin[index] * couplings.local_field(r, c, system.spin);
+
+                            // Flip the spin?
+                            if (dE < 0 || std::exp( -parameter.beta * dE) > urd(random_numder_engine)) {
+                                system.spin[index] *= -1;
+                            }
+                        }
+                    }
+                }
+            }
+        };
+
+        /**
+         * @brief single spin flip for classical ising model on a King's graph
+         *
+         * The lattice is 4-colored by the parities of (r, c); sites of the same color are never adjacent,
+         * so the local fields of a whole color class in a row are computed as a block before the Metropolis tests.
+         * Spins are visited in the order color 0, 1, 2, 3, row by row.
+         *
+         * @tparam FloatType floating-point type
+         */
+        template<typename FloatType>
+        struct SingleSpinFlip<system::ClassicalIsing<graph::KingGraph<FloatType>, false>> {
+
+            /**
+             * @brief ClassicalIsing type
+             */
+            using ClIsing = system::ClassicalIsing<graph::KingGraph<FloatType>, false>;
+
+            /**
+             * @brief operate single spin flip in a classical ising system
+             *
+             * @param system object of a classical ising system
+             * @param random_number_engine random number gengine
+             * @param parameter parameter object including inverse temperature \f\beta:=(k_B T)^{-1}\f
+             *
+             * @return energy difference \f\Delta E\f
+             */
+          template<typename RandomNumberEngine>
+            inline static void update(ClIsing& system,
+                                 RandomNumberEngine& random_numder_engine,
+                                 const utility::ClassicalUpdaterParameter& parameter) {
+                // to do Metropolis
+                auto urd = std::uniform_real_distribution<>(0, 1.0);
+
+                const auto& couplings = system.couplings;
+                const std::size_t num_row = couplings.num_row;
+                const std::size_t num_column = couplings.num_column;
+
+                // local fields of one color class in a row
+                std::vector<FloatType> fields((num_column+1)/2);
+
+                for (std::size_t color = 0; color < 4; ++color) {
+                    const std::size_t r_begin = color/2;
+                    const std::size_t c_begin = color%2;
+                    for (std::size_t r = r_begin; r < num_row; r += 2) {
+                        couplings.row_local_fields(r, c_begin, system.spin, fields.data());
+                        graph::Spin* row = system.spin.data() + r*num_column;
+                        for (std::size_t c = c_begin, k = 0; c < num_column; c += 2, ++k) {
+                            // local energy difference (nine-point stencil)
+                            const FloatType dE = -2.0 * row[c] * fields[k];
+
+                            // Flip the spin?
+                            if (dE < 0 || std::exp( -parameter.beta * dE) > urd(random_numder_engine)) {
+                                row[c] *= -1;
+                            }
+                        }
+                    }
+                }
+            }
+        };
+
+        /**
+         * @brief single spin flip for classical ising model on a periodic lattice with a compile-time stencil
+         *
+         * Spins are visited in sequential (row-major) order. Sites away from the boundary use the
+         * unrolled, non-wrapping stencil; only the sites within the margin wrap around.
+         *
+         * @tparam FloatType floating-point type
+         * @tparam Dims number of dimensions
+         * @tparam Offsets forward neighbor offsets
+         */
+        template<typename FloatType, std::size_t Dims, typename... Offsets>
+        struct SingleSpinFlip<system::ClassicalIsing<graph::Lattice<FloatType, Dims, Offsets...>, false>> {
+
+            /**
+             * @brief ClassicalIsing type
+             */
+            using ClIsing = system::ClassicalIsing<graph::Lattice<FloatType, Dims, Offsets...>, false>;
+
+            /**
+             * @brief operate single spin flip in a classical ising system
+             *
+             * @param system object of a classical ising system
+             * @param random_number_engine random number gengine
+             * @param parameter parameter object including inverse temperature \f\beta:=(k_B T)^{-1}\f
+             *
+             * @return energy difference \f\Delta E\f
+             */
+          template<typename RandomNumberEngine>
+            inline static void update(ClIsing& system,
+                                 RandomNumberEngine& random_numder_engine,
+                                 const utility::ClassicalUpdaterParameter& parameter) {
+                // to do Metropolis
+                auto urd = std::uniform_real_distribution<>(0, 1.0);
+
+                const auto& lattice = *system.interaction;
+                const auto& shape = lattice.get_shape();
+                const auto& margin = lattice.get_margin();
+                const std::size_t length = shape[Dims-1];
+                const std::size_t inner_begin = margin[Dims-1];
+                const std::size_t inner_end = length - margin[Dims-1];
+
+                auto flip = [&](std::size_t index, FloatType local_field){
+                    // local energy difference
+                    const FloatType dE = -2.0 * system.spin[index] * local_field;
+
+                    // Flip the spin?
+                    if (dE < 0 || std::exp( -parameter.beta * dE) > urd(random_numder_engine)) {
+                        system.spin[index] *= -1;
+                    }
+                };
+
+                // coordinate of the current site
+                typename graph::Lattice<FloatType, Dims, Offsets...>::Coordinate x = {};
+                for (std::size_t line = 0, num_spins = system.spin.size(); line < num_spins; line += length) {
+                    // is the line (all dimensions but the last) away from the boundary?
+                    bool interior = true;
+                    for (std::size_t d = 0; d+1 < Dims; ++d) {
+                        interior = interior && margin[d] <= x[d] && x[d] < shape[d] - margin[d];
+                    }
+
+                    std::size_t c = 0;
+                    if (interior) {
+                        for (; c < inner_begin; ++c) {
+                            x[Dims-1] = c;
+                            flip(line + c, lattice.local_field(x, system.spin));
+                        }
+                        for (; c < inner_end; ++c) {
+                            flip(line + c, lattice.interior_local_field(line + c, system.spin));
+                        }
+                    }
+                    for (; c < length; ++c) {
+                        x[Dims-1] = c;
+                        flip(line + c, lattice.local_field(x, system.spin));
+                    }
+
+                    // next line
+                    x[Dims-1] = 0;
+                    for (std::size_t d = Dims-1; d-- > 0;) {
+                        if (++x[d] < shape[d]) break;
+                        x[d] = 0;
+                    }
+                }
+            }
+        };
+
+        /**
+         * @brief single spin flip for classical system with polynomial interactions
+         *
+         * Variables are visited in sequential order; each proposal and each accepted flip touch only the terms containing the variable.
+         *
+         * @tparam GraphType graph type
+         */
+        template<typename GraphType>
+        struct SingleSpinFlip<system::ClassicalIsingPolynomial<GraphType>> {
+
+            /**
+             * @brief ClassicalIsingPolynomial type
+             */
+            using ClIsing = system::ClassicalIsingPolynomial<GraphType>;
+
+            /**
+             * @brief operate single spin flip in a classical system
+             *
+             * @param system object of a classical system with polynomial interactions
+             * @param random_number_engine random number gengine
+             * @param parameter parameter object including inverse temperature \f\beta:=(k_B T)^{-1}\f
+             *
+             * @return energy difference \f\Delta E\f
+             */
+          template<typename RandomNumberEngine>
+            inline static void update(ClIsing& system,
+                                 RandomNumberEngine& random_numder_engine,
+                                 const utility::ClassicalUpdaterParameter& parameter) {
+                // to do Metropolis
+                auto urd = std::uniform_real_distribution<>(0, 1.0);
+
+                for (std::size_t index = 0; index < system.num_spins; ++index) {
+                    // local energy difference
+                    const auto dE = system.energy_difference(index);
+
+                    // Flip the spin?
+                    if (dE < 0 || std::exp( -parameter.beta * dE) > urd(random_numder_engine)) {
+                        system.flip(index);
+                    }
+                }
+            }
+        };
+
+        namespace quantized_ssf_impl{
+
+            /**
+             * @brief number of tabulated acceptance probabilities
+             */
+            constexpr std::size_t table_size = 64;
+
+            /**
+             * @brief single spin flip on a quantized graph (QuantizedDense or QuantizedSparse)
+             *
+             * Local fields are accumulated in integers and the acceptance probabilities of small energy differences are tabulated.
+             *
+             * @param system object of a classical ising system
+             * @param random_number_engine random number gengine
+             * @param parameter parameter object including inverse temperature \f\beta:=(k_B T)^{-1}\f
+             */
+            template<typename ClIsing, typename RandomNumberEngine>
+                inline void update(ClIsing& system,
+                        RandomNumberEngine& random_numder_engine,
+                        const utility::ClassicalUpdaterParameter& parameter) {
+                    using GraphType = typename std::decay<decltype(*system.interaction)>::type;
+                    using FloatType = typename GraphType::value_type;
+                    using Field = typename GraphType::field_type;
+
+                    // set probability distribution object
+                    // to select candidate for flip at random
+                    auto uid = std::uniform_int_distribution<std::size_t>(0, system.spin.size()-1);
+                    // to do Metropolis
+                    auto urd = std::uniform_real_distribution<>(0, 1.0);
+
+                    // exp(-beta dE) for dE = 2k * scale (k < table_size)
+                    const FloatType unit = parameter.beta * system.interaction->get_scale();
+                    FloatType table[table_size];
+                    for (std::size_t k = 0; k < table_size; ++k) {
+                        table[k] = std::exp(-unit * 2 * static_cast<FloatType>(k));
                     }
 
-                    // Flip the spin?
-                    if (dE < 0 || std::exp( -parameter.beta * dE) > urd(random_numder_engine)) {
-                        system.spin[index] *= -1;
+                    for (std::size_t time = 0, num_spins = system.spin.size(); time < num_spins; ++time) {
+                        // index of spin selected at random
+                        const auto index = uid(random_numder_engine);
+                        assert(index < num_spins);
+
+                        // local energy difference in units of 2 * scale (exact integer)
+                        const Field half_dE = -system.spin[index] * system.interaction->local_field(index, system.spin);
+
+                        // Flip the spin?
+                        if (half_dE < 0 || (static_cast<std::size_t>(half_dE) < table_size ? table[half_dE] : std::exp(-unit * 2 * static_cast<FloatType>(half_dE))) > urd(random_numder_engine)) {
+                            system.spin[index] *= -1;
+                        }
                     }
                 }
+        } // namespace quantized_ssf_impl
+
+        /**
+         * @brief single spin flip for classical ising model on a QuantizedDense graph (see quantized_ssf_impl::update)
+         *
+         * @tparam IntType integer type of couplings
+         * @tparam FloatType floating-point type
+         */
+        template<typename IntType, typename FloatType>
+        struct SingleSpinFlip<system::ClassicalIsing<graph::QuantizedDense<IntType, FloatType>, false>> {
+
+            /**
+             * @brief ClassicalIsing type
+             */
+            using ClIsing = system::ClassicalIsing<graph::QuantizedDense<IntType, FloatType>, false>;
+
+            /**
+             * @brief operate single spin flip in a classical ising system
+             *
+             * @param system object of a classical ising system
+             * @param random_number_engine random number gengine
+             * @param parameter parameter object including inverse temperature \f\beta:=(k_B T)^{-1}\f
+             */
+          template<typename RandomNumberEngine>
+            inline static void update(ClIsing& system,
+                                 RandomNumberEngine& random_numder_engine,
+                                 const utility::ClassicalUpdaterParameter& parameter) {
+                quantized_ssf_impl::update(system, random_numder_engine, parameter);
+            }
+        };
+
+        /**
+         * @brief single spin flip for classical ising model on a QuantizedSparse graph (see quantized_ssf_impl::update)
+         *
+         * @tparam IntType integer type of couplings
+         * @tparam FloatType floating-point type
+         */
+        template<typename IntType, typename FloatType>
+        struct SingleSpinFlip<system::ClassicalIsing<graph::QuantizedSparse<IntType, FloatType>, false>> {
+
+            /**
+             * @brief ClassicalIsing type
+             */
+            using ClIsing = system::ClassicalIsing<graph::QuantizedSparse<IntType, FloatType>, false>;
+
+            /**
+             * @brief operate single spin flip in a classical ising system
+             *
+             * @param system object of a classical ising system
+             * @param random_number_engine random number gengine
+             * @param parameter parameter object including inverse temperature \f\beta:=(k_B T)^{-1}\f
+             */
+          template<typename RandomNumberEngine>
+            inline static void update(ClIsing& system,
+                                 RandomNumberEngine& random_numder_engine,
+                                 const utility::ClassicalUpdaterParameter& parameter) {
+                quantized_ssf_impl::update(system, random_numder_engine, parameter);
             }
         };
 
-        
         /**
          * @brief single spin flip for classical ising model (with Eigen implementation)
          *
@@ -126,18 +850,22 @@ namespace openjij {
                 // to do Metroopolis
                 auto urd = std::uniform_real_distribution<>(0, 1.0);
 
+                if (!system.local_fields_valid) {
+                    system.refresh_local_fields();
+                }
+
                 for (std::size_t time = 0; time < system.num_spins; ++time) {
 
                     // index of spin selected at random
                     const auto index = uid(random_numder_engine);
 
-                    // local energy difference (matrix multiplication)
+                    // local energy difference (cached local field)
                     assert(index < system.num_spins);
-                    FloatType dE = -2*system.spin(index)*(system.interaction.row(index).dot(system.spin));
+                    const FloatType dE = system.energy_difference(index);
 
-                    // Flip the spin?
+                    // Flip the spin? (only accepted flips update the local fields)
                     if (dE < 0 || std::exp( -parameter.beta * dE) > urd(random_numder_engine)) {
-                        system.spin(index) *= -1;
+                        system.flip(index);
                     }
 
                     //assure that the dummy spin is not changed.
@@ -164,6 +892,91 @@ namespace openjij {
              */
             using FloatType = typename GraphType::value_type;
 
+            /**
+             * @brief operate single spin flip in a transverse ising system
+             *
+             * @param system object of a transverse ising system
+             * @param random_number_engine random number engine
+             * @param parameter parameter object including inverse temperature \f\beta:=(k_B T)^{-1}\f and transverse magnetic field \f\s\f
+             *
+             * @return energy difference \f\Delta E\f
+             */
+            template<typename RandomNumberEngine>
+                inline static void update(QIsing& system,
+                        RandomNumberEngine& random_numder_engine,
+                        const utility::TransverseFieldUpdaterParameter& parameter) {
+
+                    //get number of classical spins
+                    std::size_t num_classical_spins = system.trotter_spins[0].size();
+                    //get number of trotter slices
+                    std::size_t num_trotter_slices = system.trotter_spins.size();
+
+                    auto uid = std::uniform_int_distribution<std::size_t>{0, num_classical_spins-1};
+                    auto uid_trotter = std::uniform_int_distribution<std::size_t>{0, num_trotter_slices-1};
+
+                    //do metropolis
+                    auto urd = std::uniform_real_distribution<>(0, 1.0);
+
+                    //aliases
+                    const std::int8_t* spins = system.trotter_spins.data();
+                    auto& gamma = system.gamma;
+                    auto& beta = parameter.beta;
+                    auto& s = parameter.s;
+
+                    if(!system.local_fields_valid){
+                        system.refresh_local_fields();
+                    }
+
+                    //couplings of the classical and the trotter directions (constant during the sweep)
+                    const FloatType classical_coupling = -2 * s * (beta/num_trotter_slices);
+                    const FloatType trotter_coupling = -2 * (1/2.) * log(tanh(beta* gamma * (1.0-s) /num_trotter_slices));
+
+                    for(std::size_t i=0; i<num_classical_spins*num_trotter_slices; i++){
+                        //select random trotter slice
+                        std::size_t index_trot = uid_trotter(random_numder_engine);
+                        //select random classical spin index
+                        std::size_t index = uid(random_numder_engine);
+                        assert(index < num_classical_spins);
+                        assert(index_trot < num_trotter_slices);
+
+                        //do metropolis (cached local field)
+                        const std::size_t pos = index_trot*num_classical_spins + index;
+                        FloatType dE = classical_coupling * spins[pos] * system.local_field[pos];
+
+                        //trotter direction
+                        dE += trotter_coupling * spins[pos]*
+                            (  spins[mod_t((int64_t)index_trot+1, num_trotter_slices)*num_classical_spins + index]
+                             + spins[mod_t((int64_t)index_trot-1, num_trotter_slices)*num_classical_spins + index]);
+
+                        //metropolis (only accepted flips update the neighboring fields)
+                        if(dE < 0 || exp(-dE) > urd(random_numder_engine)){
+                            system.flip(index_trot, index);
+                        }
+
+                    }
+                }
+
+            private: 
+            inline static std::size_t mod_t(std::int64_t a, std::size_t num_trotter_slices){
+                //a -> [-1:num_trotter_slices]
+                //return a%num_trotter_slices (a>0), num_trotter_slices-1 (a==-1)
+                return (a+num_trotter_slices)%num_trotter_slices;
+            }
+        };
+
+        /**
+         * @brief single spin flip for transverse field ising model on a CSRSparse graph
+         *
+         * @tparam FloatType floating-point type
+         */
+        template<typename FloatType>
+        struct SingleSpinFlip<system::TransverseIsing<graph::CSRSparse<FloatType>, false>> {
+            
+            /**
+             * @brief transverse field ising system
+             */
+            using QIsing = system::TransverseIsing<graph::CSRSparse<FloatType>, false>;
+
             /**
              * @brief operate single spin flip in a transverse ising system
              *
@@ -200,15 +1013,174 @@ namespace openjij {
                         std::size_t index_trot = uid_trotter(random_numder_engine);
                         //select random classical spin index
                         std::size_t index = uid(random_numder_engine);
+                        assert(index < num_classical_spins);
+                        assert(index_trot < num_trotter_slices);
+
+                        //local field in the trotter slice
+                        const auto& slice = spins[index_trot];
+                        FloatType local_field = system.interaction->h(index);
+                        for(auto&& edge : system.interaction->adj_edges(index)){
+                            local_field += edge.value * slice[edge.index];
+                        }
+
                         //do metropolis
-                        FloatType dE = 0;
-                        //calculate adjacent nodes
+                        FloatType dE = -2 * s * (beta/num_trotter_slices) * slice[index] * local_field;
+
+                        //trotter direction
+                        dE += -2 * (1/2.) * log(tanh(beta* gamma * (1.0-s) /num_trotter_slices)) * spins[index_trot][index]*
+                            (  spins[mod_t((int64_t)index_trot+1, num_trotter_slices)][index] 
+                             + spins[mod_t((int64_t)index_trot-1, num_trotter_slices)][index]);
+
+                        //metropolis 
+                        if(dE < 0 || exp(-dE) > urd(random_numder_engine)){
+                            spins[index_trot][index] *= -1;
+                        }
+
+                    }
+                }
+
+            private: 
+            inline static std::size_t mod_t(std::int64_t a, std::size_t num_trotter_slices){
+                //a -> [-1:num_trotter_slices]
+                //return a%num_trotter_slices (a>0), num_trotter_slices-1 (a==-1)
+                return (a+num_trotter_slices)%num_trotter_slices;
+            }
+        };
+
+        /**
+         * @brief single spin flip for transverse field ising model with bit-packed trotter spins on a CSRSparse graph
+         *
+         * @tparam FloatType floating-point type
+         */
+        template<typename FloatType>
+        struct SingleSpinFlip<system::TransverseIsingPacked<graph::CSRSparse<FloatType>>> {
+
+            /**
+             * @brief transverse field ising system
+             */
+            using QIsing = system::TransverseIsingPacked<graph::CSRSparse<FloatType>>;
+
+            /**
+             * @brief operate single spin flip in a transverse ising system
+             *
+             * @param system object of a transverse ising system
+             * @param random_number_engine random number engine
+             * @param parameter parameter object including inverse temperature \f\beta:=(k_B T)^{-1}\f and transverse magnetic field \f\s\f
+             *
+             * @return energy difference \f\Delta E\f
+             */
+            template<typename RandomNumberEngine>
+                inline static void update(QIsing& system,
+                        RandomNumberEngine& random_numder_engine,
+                        const utility::TransverseFieldUpdaterParameter& parameter) {
+
+                    //get number of classical spins
+                    std::size_t num_classical_spins = system.num_classical_spins;
+                    //get number of trotter slices
+                    std::size_t num_trotter_slices = system.trotter_spins.size();
+
+                    auto uid = std::uniform_int_distribution<std::size_t>{0, num_classical_spins-1};
+                    auto uid_trotter = std::uniform_int_distribution<std::size_t>{0, num_trotter_slices-1};
+
+                    //do metropolis
+                    auto urd = std::uniform_real_distribution<>(0, 1.0);
+
+                    //aliases
+                    auto& spins = system.trotter_spins;
+                    const auto beta = parameter.beta;
+                    const auto s = parameter.s;
+
+                    //coupling between neighboring trotter slices (constant during the sweep)
+                    const FloatType trotter_coupling = -(1/2.) * std::log(std::tanh(beta * system.gamma * (1.0-s) / num_trotter_slices));
+
+                    for(std::size_t i=0; i<num_classical_spins*num_trotter_slices; i++){
+                        //select random trotter slice
+                        std::size_t index_trot = uid_trotter(random_numder_engine);
+                        //select random classical spin index
+                        std::size_t index = uid(random_numder_engine);
                         assert(index < num_classical_spins);
                         assert(index_trot < num_trotter_slices);
-                        for(auto&& adj_index : system.interaction.adj_nodes(index)){
-                            dE += -2 * s * (beta/num_trotter_slices) * spins[index_trot][index] * (index != adj_index ? (system.interaction.J(index, adj_index) * spins[index_trot][adj_index]) : system.interaction.h(index));
+
+                        //local field in the trotter slice (spins are read bit by bit)
+                        const auto& slice = spins[index_trot];
+                        FloatType local_field = system.interaction.h(index);
+                        for(auto&& edge : system.interaction.adj_edges(index)){
+                            local_field += edge.value * slice.get(edge.index);
                         }
 
+                        //do metropolis
+                        const auto spin = slice.get(index);
+                        FloatType dE = -2 * s * (beta/num_trotter_slices) * spin * local_field;
+
+                        //trotter direction
+                        dE += 2 * trotter_coupling * spin *
+                            (  spins[(index_trot+1)%num_trotter_slices].get(index)
+                             + spins[(index_trot+num_trotter_slices-1)%num_trotter_slices].get(index));
+
+                        //metropolis
+                        if(dE < 0 || std::exp(-dE) > urd(random_numder_engine)){
+                            spins[index_trot].flip(index);
+                        }
+
+                    }
+                }
+        };
+
+        /**
+         * @brief single spin flip for transverse field ising model on a DenseMatrix graph
+         *
+         * @tparam FloatType floating-point type
+         */
+        template<typename FloatType>
+        struct SingleSpinFlip<system::TransverseIsing<graph::DenseMatrix<FloatType>, false>> {
+            
+            /**
+             * @brief transverse field ising system
+             */
+            using QIsing = system::TransverseIsing<graph::DenseMatrix<FloatType>, false>;
+
+            /**
+             * @brief operate single spin flip in a transverse ising system
+             *
+             * @param system object of a transverse ising system
+             * @param random_number_engine random number engine
+             * @param parameter parameter object including inverse temperature \f\beta:=(k_B T)^{-1}\f and transverse magnetic field \f\s\f
+             *
+             * @return energy difference \f\Delta E\f
+             */
+            template<typename RandomNumberEngine>
+                inline static void update(QIsing& system,
+                        RandomNumberEngine& random_numder_engine,
+                        const utility::TransverseFieldUpdaterParameter& parameter) {
+
+                    //get number of classical spins
+                    std::size_t num_classical_spins = system.trotter_spins[0].size();
+                    //get number of trotter slices
+                    std::size_t num_trotter_slices = system.trotter_spins.size();
+
+                    auto uid = std::uniform_int_distribution<std::size_t>{0, num_classical_spins-1};
+                    auto uid_trotter = std::uniform_int_distribution<std::size_t>{0, num_trotter_slices-1};
+
+                    //do metropolis
+                    auto urd = std::uniform_real_distribution<>(0, 1.0);
+
+                    //aliases
+                    auto& spins = system.trotter_spins;
+                    auto& gamma = system.gamma;
+                    auto& beta = parameter.beta;
+                    auto& s = parameter.s;
+
+                    for(std::size_t i=0; i<num_classical_spins*num_trotter_slices; i++){
+                        //select random trotter slice
+                        std::size_t index_trot = uid_trotter(random_numder_engine);
+                        //select random classical spin index
+                        std::size_t index = uid(random_numder_engine);
+                        assert(index < num_classical_spins);
+                        assert(index_trot < num_trotter_slices);
+
+                        //do metropolis (contiguous row dot product)
+                        FloatType dE = -2 * s * (beta/num_trotter_slices) * spins[index_trot][index] * system.interaction->local_field(index, spins[index_trot]);
+
                         //trotter direction
                         dE += -2 * (1/2.) * log(tanh(beta* gamma * (1.0-s) /num_trotter_slices)) * spins[index_trot][index]*
                             (  spins[mod_t((int64_t)index_trot+1, num_trotter_slices)][index] 
@@ -279,26 +1251,33 @@ namespace openjij {
                     auto& beta = parameter.beta;
                     auto& s = parameter.s;
 
+                    if(!system.local_fields_valid){
+                        system.refresh_local_fields();
+                    }
+
+                    //couplings of the classical and the trotter directions (constant during the sweep)
+                    const FloatType classical_coupling = -2 * s * (beta/num_trotter_slices);
+                    const FloatType trotter_coupling = -2 * (1/2.) * log(tanh(beta* gamma * (1.0-s) /num_trotter_slices));
+
                     for(std::size_t i=0; i<num_classical_spins*num_trotter_slices; i++){
                         //select random trotter slice
                         std::size_t index_trot = uid_trotter(random_numder_engine);
                         //select random classical spin index
                         std::size_t index = uid(random_numder_engine);
-                        //do metropolis
-                        FloatType dE = 0;
                         assert(index < num_classical_spins);
                         assert(index_trot < num_trotter_slices);
-                        //calculate matrix dot product
-                        dE += -2 * s * (beta/num_trotter_slices) * spins(index, index_trot)*(system.interaction.row(index).dot(spins.col(index_trot)));
+
+                        //do metropolis (cached local field)
+                        FloatType dE = classical_coupling * spins(index, index_trot) * system.local_field(index, index_trot);
 
                         //trotter direction
-                        dE += -2 * (1/2.) * log(tanh(beta* gamma * (1.0-s) /num_trotter_slices)) * spins(index, index_trot)*
+                        dE += trotter_coupling * spins(index, index_trot)*
                             (  spins(index, mod_t((int64_t)index_trot+1, num_trotter_slices)) 
                              + spins(index, mod_t((int64_t)index_trot-1, num_trotter_slices)));
 
-                        //metropolis 
+                        //metropolis (only accepted flips update the local fields)
                         if(dE < 0 || exp(-dE) > urd(random_numder_engine)){
-                            spins(index, index_trot) *= -1;
+                            system.flip(index_trot, index);
                         }
 
                     }
@@ -0,0 +1,140 @@
+//    Copyright 2019 Jij Inc.
+
+//    Licensed under the Apache License, Version 2.0 (the "License");
+//    you may not use this file except in compliance with the License.
+//    You may obtain a copy of the License at
+
+//        http://www.apache.org/licenses/LICENSE-2.0
+
+//    Unless required by applicable law or agreed to in writing, software
+//    distributed under the License is distributed on an "AS IS" BASIS,
+//    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//    See the License for the specific language governing permissions and
+//    limitations under the License.
+
+#ifndef OPENJIJ_UTILITY_MAPPED_FILE_HPP__
+#define OPENJIJ_UTILITY_MAPPED_FILE_HPP__
+
+#include <cstddef>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define OPENJIJ_USE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <utility/memory.hpp>
+
+namespace openjij {
+    namespace utility {
+
+        /**
+         * @brief read-only view of a whole file
+         *
+         * The file is memory-mapped (shared, read-only) on POSIX systems, so that several processes share the page cache.
+         * On other platforms the file is read into an aligned buffer.
+         */
+        class MappedFile{
+            private:
+
+                /**
+                 * @brief pointer to the first byte
+                 */
+                const char* _data;
+
+                /**
+                 * @brief file size in bytes
+                 */
+                std::size_t _size;
+
+                /**
+                 * @brief fallback buffer (used if mmap is not available)
+                 */
+                std::vector<char, AlignedAllocator<char, 64>> _buffer;
+
+            public:
+
+                /**
+                 * @brief open and map a file
+                 *
+                 * @param path path to the file
+                 */
+                explicit MappedFile(const std::string& path) : _data(nullptr), _size(0){
+#ifdef OPENJIJ_USE_MMAP
+                    const int fd = ::open(path.c_str(), O_RDONLY);
+                    if(fd < 0){
+                        throw std::runtime_error("MappedFile: cannot open " + path);
+                    }
+                    struct stat st;
+                    if(::fstat(fd, &st) != 0){
+                        ::close(fd);
+                        throw std::runtime_error("MappedFile: cannot stat " + path);
+                    }
+                    _size = static_cast<std::size_t>(st.st_size);
+                    if(_size > 0){
+                        void* addr = ::mmap(nullptr, _size, PROT_READ, MAP_SHARED, fd, 0);
+                        if(addr == MAP_FAILED){
+                            ::close(fd);
+                            throw std::runtime_error("MappedFile: cannot map " + path);
+                        }
+                        _data = static_cast<const char*>(addr);
+                    }
+                    //the mapping stays valid after the descriptor is closed
+                    ::close(fd);
+#else
+                    std::ifstream ifs(path, std::ios::binary | std::ios::ate);
+                    if(!ifs){
+                        throw std::runtime_error("MappedFile: cannot open " + path);
+                    }
+                    _size = static_cast<std::size_t>(ifs.tellg());
+                    _buffer.resize(_size);
+                    ifs.seekg(0);
+                    if(!ifs.read(_buffer.data(), static_cast<std::streamsize>(_size))){
+                        throw std::runtime_error("MappedFile: cannot read " + path);
+                    }
+                    _data = _buffer.data();
+#endif
+                }
+
+                MappedFile(const MappedFile&) = delete;
+                MappedFile& operator=(const MappedFile&) = delete;
+
+                /**
+                 * @brief unmap the file
+                 */
+                ~MappedFile(){
+#ifdef OPENJIJ_USE_MMAP
+                    if(_data != nullptr){
+                        ::munmap(const_cast<char*>(_data), _size);
+                    }
+#endif
+                }
+
+                /**
+                 * @brief pointer to the first byte of the file
+                 *
+                 * @return pointer (page-aligned if memory-mapped)
+                 */
+                const char* data() const{
+                    return _data;
+                }
+
+                /**
+                 * @brief file size
+                 *
+                 * @return size in bytes
+                 */
+                std::size_t size() const{
+                    return _size;
+                }
+        };
+    } // namespace utility
+} // namespace openjij
+
+#endif
@@ -15,7 +15,12 @@
 #ifndef OPENJIJ_UTILITY_MEMORY_HPP__
 #define OPENJIJ_UTILITY_MEMORY_HPP__
 
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
 #include <memory>
+#include <new>
 #include <utility>
 
 namespace openjij {
@@ -35,6 +40,74 @@ namespace openjij {
             {
                 return std::unique_ptr<T>( new T( std::forward<Args>(args)... ) );
             }
+
+        /**
+         * @brief allocator returning memory aligned to the specified boundary (e.g. cache line / SIMD width)
+         *
+         * @tparam T value type
+         * @tparam Alignment alignment in bytes (power of two)
+         */
+        template<typename T, std::size_t Alignment = 64>
+            struct AlignedAllocator{
+                static_assert((Alignment & (Alignment-1)) == 0, "Alignment must be a power of two.");
+                static_assert(Alignment >= alignof(void*), "Alignment is too small.");
+
+                using value_type = T;
+
+                /**
+                 * @brief rebind allocator to another type
+                 *
+                 * @tparam U another type
+                 */
+                template<typename U>
+                    struct rebind{
+                        using other = AlignedAllocator<U, Alignment>;
+                    };
+
+                AlignedAllocator() noexcept = default;
+
+                template<typename U>
+                    AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+                /**
+                 * @brief allocate aligned memory (the original pointer is stored just before the returned address)
+                 *
+                 * @param n number of elements
+                 *
+                 * @return aligned pointer
+                 */
+                T* allocate(std::size_t n){
+                    if(n > (std::numeric_limits<std::size_t>::max() - Alignment - sizeof(void*)) / sizeof(T)){
+                        throw std::bad_alloc();
+                    }
+                    void* raw = std::malloc(n*sizeof(T) + Alignment + sizeof(void*));
+                    if(raw == nullptr){
+                        throw std::bad_alloc();
+                    }
+                    const std::uintptr_t base = reinterpret_cast<std::uintptr_t>(raw) + sizeof(void*);
+                    const std::uintptr_t aligned = (base + Alignment - 1) & ~static_cast<std::uintptr_t>(Alignment - 1);
+                    reinterpret_cast<void**>(aligned)[-1] = raw;
+                    return reinterpret_cast<T*>(aligned);
+                }
+
+                /**
+                 * @brief deallocate memory allocated by allocate()
+                 *
+                 * @param p aligned pointer
+                 */
+                void deallocate(T* p, std::size_t) noexcept{
+                    if(p != nullptr){
+                        std::free(reinterpret_cast<void**>(p)[-1]);
+                    }
+                }
+            };
+
+        template<typename T, typename U, std::size_t Alignment>
+            bool operator==(const AlignedAllocator<T, Alignment>&, const AlignedAllocator<U, Alignment>&) noexcept{ return true; }
+
+        template<typename T, typename U, std::size_t Alignment>
+            bool operator!=(const AlignedAllocator<T, Alignment>&, const AlignedAllocator<U, Alignment>&) noexcept{ return false; }
+
     } // namespace utility
 } // namespace openjij
 
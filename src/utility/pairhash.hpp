@@ -37,9 +37,10 @@ namespace openjij {
              * @return generated hash
              */
             inline size_t operator()(const std::pair<graph::Index, graph::Index> & p) const{
-                const auto h1 = std::hash<graph::Index>()(p.first);
-                const auto h2 = std::hash<graph::Index>()(p.second);
-                return h1 ^ (h2 << 1);
+                //hash_combine (as in boost): h1 ^ (h2 << 1) collides heavily on lattice indices
+                std::size_t seed = std::hash<graph::Index>()(p.first);
+                seed ^= std::hash<graph::Index>()(p.second) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+                return seed;
             }
         };
     } // namespace utility
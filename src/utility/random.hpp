@@ -17,6 +17,8 @@
 
 #include <random>
 #include <climits>
+#include <istream>
+#include <ostream>
 
 #ifdef USE_CUDA
 #include <cuda_runtime.h>
@@ -83,7 +85,42 @@ namespace openjij {
                  */
                 Xorshift(unsigned s){
                     w=s;
-                } 
+                }
+
+                /**
+                 * @brief compare the internal states
+                 */
+                friend bool operator==(const Xorshift& lhs, const Xorshift& rhs){
+                    return lhs.x == rhs.x && lhs.y == rhs.y && lhs.z == rhs.z && lhs.w == rhs.w;
+                }
+
+                friend bool operator!=(const Xorshift& lhs, const Xorshift& rhs){
+                    return !(lhs == rhs);
+                }
+
+                /**
+                 * @brief write the internal state in text (same convention as the engines in <random>)
+                 */
+                template<typename CharT, typename Traits>
+                friend std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits>& os, const Xorshift& rng){
+                    const CharT space = os.widen(' ');
+                    return os << rng.x << space << rng.y << space << rng.z << space << rng.w;
+                }
+
+                /**
+                 * @brief restore the internal state written by operator<<
+                 */
+                template<typename CharT, typename Traits>
+                friend std::basic_istream<CharT, Traits>& operator>>(std::basic_istream<CharT, Traits>& is, Xorshift& rng){
+                    unsigned x, y, z, w;
+                    if(is >> x >> y >> z >> w){
+                        rng.x = x;
+                        rng.y = y;
+                        rng.z = z;
+                        rng.w = w;
+                    }
+                    return is;
+                }
             private:
                 unsigned x=123456789u,y=362436069u,z=521288629u,w;
         };
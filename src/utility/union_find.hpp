@@ -33,6 +33,17 @@ namespace openjij {
                     std::iota(_parent.begin(), _parent.end(), 0);
                 }
 
+            /**
+             * @brief make n singleton sets again (allocated memory is reused)
+             *
+             * @param n number of nodes
+             */
+            void reset(size_type n) {
+                _parent.resize(n);
+                std::iota(_parent.begin(), _parent.end(), 0);
+                _rank.assign(n, 0);
+            }
+
             void unite_sets(Node x, Node y) {
                 auto root_x = find_set(x);
                 auto root_y = find_set(y);
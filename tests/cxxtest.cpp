@@ -10,6 +10,14 @@
 #include <type_traits>
 #include <vector>
 #include <algorithm>
+#include <cstdio>
+#include <limits>
+#include <sstream>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <cstring>
+#include <string>
 
 // include OpenJij
 #include <graph/all.hpp>
@@ -86,6 +94,48 @@ TEST(Graph, DenseGraphCheck){
     }
 }
 
+TEST(Graph, DenseGraphFromMatrix){
+    using namespace openjij::graph;
+    using namespace openjij;
+
+    std::size_t N = 300;
+    Dense<double> a(N);
+    std::vector<double> matrix(N*N, 0.0);
+    auto r = utility::Xorshift(1234);
+    auto urd = std::uniform_real_distribution<>{-10, 10};
+    for(std::size_t i=0; i<N; i++){
+        for(std::size_t j=i; j<N; j++){
+            //leave some elements empty
+            if((i+j)%5 == 0) continue;
+            const double val = urd(r);
+            a.J(i, j) = val;
+            matrix[i*N+j] = val;
+            //lower triangle is ignored
+            if(i != j) matrix[j*N+i] = 100.0;
+        }
+    }
+
+    Dense<double> b(N, matrix.data());
+    std::vector<float> matrix_f(matrix.begin(), matrix.end());
+    Dense<float> c(N, matrix_f.data());
+
+    for(std::size_t i=0; i<N; i++){
+        for(std::size_t j=0; j<N; j++){
+            EXPECT_EQ(a.J(i, j), b.J(i, j));
+            EXPECT_EQ(static_cast<float>(a.J(i, j)), c.J(i, j));
+        }
+        auto adj_a = a.adj_nodes(i);
+        auto adj_b = b.adj_nodes(i);
+        std::sort(adj_a.begin(), adj_a.end());
+        std::sort(adj_b.begin(), adj_b.end());
+        EXPECT_EQ(adj_a, adj_b);
+    }
+
+    auto random_engine = std::mt19937(1);
+    const Spins spins = a.gen_spin(random_engine);
+    EXPECT_NEAR(a.calc_energy(spins), b.calc_energy(spins), 1e-8);
+}
+
 TEST(Graph, SparseGraphCheck){
     using namespace openjij::graph;
     using namespace openjij;
@@ -161,6 +211,661 @@ TEST(Graph, SparseGraphCheck){
     EXPECT_EQ(c.get_num_edges(), N);
 }
 
+TEST(Graph, SparseGraphFromCOO){
+    using namespace openjij::graph;
+    using namespace openjij;
+
+    std::size_t N = 500;
+    Sparse<double> a(N, 6);
+    std::vector<std::int64_t> rows, cols;
+    std::vector<double> values;
+    auto r = utility::Xorshift(1234);
+    auto urd = std::uniform_real_distribution<>{-10, 10};
+    for(std::size_t i=0; i<N; i++){
+        const std::size_t j = (i+3)%N;
+        const double val = urd(r);
+        a.J(i, j) = val;
+        //split the value into two entries in both orientations (duplicates are summed up)
+        rows.push_back(i); cols.push_back(j); values.push_back(val/2);
+        rows.push_back(j); cols.push_back(i); values.push_back(val/2);
+        if(i%2 == 0){
+            const double h = urd(r);
+            a.h(i) = h;
+            rows.push_back(i); cols.push_back(i); values.push_back(h);
+        }
+    }
+
+    Sparse<double> b(N, rows.data(), cols.data(), values.data(), values.size());
+
+    EXPECT_EQ(b.get_num_edges(), 3u);
+    for(std::size_t i=0; i<N; i++){
+        auto adj_a = a.adj_nodes(i);
+        auto adj_b = b.adj_nodes(i);
+        std::sort(adj_a.begin(), adj_a.end());
+        std::sort(adj_b.begin(), adj_b.end());
+        EXPECT_EQ(adj_a, adj_b);
+        for(auto&& j : adj_a){
+            EXPECT_NEAR(a.J(i, j), b.J(i, j), 1e-12);
+        }
+    }
+
+    auto random_engine = std::mt19937(1);
+    const Spins spins = a.gen_spin(random_engine);
+    EXPECT_NEAR(a.calc_energy(spins), b.calc_energy(spins), 1e-8);
+
+    //index out of range
+    std::vector<std::int64_t> bad_rows = {0, -1};
+    std::vector<std::int64_t> bad_cols = {1, 2};
+    std::vector<double> bad_values = {1.0, 1.0};
+    EXPECT_THROW((Sparse<double>(N, bad_rows.data(), bad_cols.data(), bad_values.data(), 2)), std::invalid_argument);
+}
+
+TEST(Graph, CSRSparseGraphCheck){
+    using namespace openjij::graph;
+    using namespace openjij;
+
+    std::size_t N = 500;
+    Sparse<double> b(N, 10);
+    auto r = utility::Xorshift(1234);
+    auto urd = std::uniform_real_distribution<>{-10, 10};
+    for(std::size_t i=0; i<N; i++){
+        b.J(i, (i+1)%N) = urd(r);
+        b.J(i, (i+7)%N) = urd(r);
+        if(i%3 == 0) b.h(i) = urd(r);
+    }
+
+    CSRSparse<double> c(b);
+
+    // check if graph holds the same variables
+    for(std::size_t i=0; i<N; i++){
+        EXPECT_EQ(c.degree(i), 4u);
+        Index prev = 0;
+        bool first = true;
+        for(auto&& edge : c.adj_edges(i)){
+            //sorted by index
+            if(!first){
+                EXPECT_LT(prev, edge.index);
+            }
+            prev = edge.index;
+            first = false;
+            EXPECT_EQ(edge.value, b.J(i, edge.index));
+            EXPECT_EQ(c.J(i, edge.index), b.J(i, edge.index));
+            EXPECT_EQ(c.J(edge.index, i), b.J(i, edge.index));
+        }
+        EXPECT_EQ(c.h(i), (i%3 == 0) ? b.h(i) : 0.0);
+    }
+    EXPECT_EQ(c.get_num_stored_edges(), 4*N);
+    EXPECT_THROW(c.J(0, 2), std::out_of_range);
+
+    auto random_engine = std::mt19937(1);
+    const Spins spins = b.gen_spin(random_engine);
+    EXPECT_DOUBLE_EQ(c.calc_energy(spins), b.calc_energy(spins));
+
+    //from Dense
+    Dense<double> d(N);
+    for(std::size_t i=0; i<N; i++){
+        for(std::size_t j=i; j<N; j++){
+            d.J(i, j) = urd(r);
+        }
+    }
+    CSRSparse<double> e(d);
+    for(std::size_t i=0; i<N; i++){
+        EXPECT_EQ(e.degree(i), N-1);
+        EXPECT_EQ(e.h(i), d.h(i));
+    }
+    EXPECT_NEAR(e.calc_energy(spins), d.calc_energy(spins), 1e-8);
+}
+
+TEST(Graph, DenseMatrixGraphCheck){
+    using namespace openjij::graph;
+    using namespace openjij;
+
+    std::size_t N = 101;
+    Dense<double> a(N);
+    auto r = utility::Xorshift(1234);
+    auto urd = std::uniform_real_distribution<>{-10, 10};
+    for(std::size_t i=0; i<N; i++){
+        for(std::size_t j=i; j<N; j++){
+            a.J(i, j) = urd(r);
+        }
+    }
+
+    DenseMatrix<double> b(a);
+    EXPECT_EQ(b.get_stride()%8, 0u);
+    EXPECT_GE(b.get_stride(), N);
+    for(std::size_t i=0; i<N; i++){
+        //rows are aligned
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(b.row(i))%DenseMatrix<double>::alignment, 0u);
+        EXPECT_EQ(b.row(i)[i], 0.0);
+        for(std::size_t j=0; j<N; j++){
+            EXPECT_EQ(a.J(i, j), b.J(i, j));
+        }
+    }
+
+    auto random_engine = std::mt19937(1);
+    const Spins spins = a.gen_spin(random_engine);
+    EXPECT_NEAR(a.calc_energy(spins), b.calc_energy(spins), 1e-8);
+}
+
+TEST(Graph, QuantizedGraphCheck){
+    using namespace openjij::graph;
+    using namespace openjij;
+
+    std::size_t N = 101;
+    Sparse<double> a(N);
+    auto r = utility::Xorshift(1234);
+    auto uid = std::uniform_int_distribution<>{-100, 100};
+    for(std::size_t i=0; i<N; i++){
+        for(std::size_t j=i; j<N; j+=3){
+            a.J(i, j) = 0.25*uid(r);
+        }
+    }
+
+    const QuantizedDense<std::int8_t, double> b(a, 0.25);
+    const QuantizedSparse<std::int16_t, double> c(a, 0.25);
+    EXPECT_EQ(b.get_stride()%64, 0u);
+    for(std::size_t i=0; i<N; i++){
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(b.row(i))%64, 0u);
+        EXPECT_EQ(c.degree(i), a.adj_nodes(i).size() - 1);
+        for(auto&& j : a.adj_nodes(i)){
+            EXPECT_EQ(a.J(i, j), b.J(i, j));
+            EXPECT_EQ(a.J(i, j), c.J(i, j));
+        }
+    }
+
+    auto random_engine = std::mt19937(1);
+    const Spins spins = a.gen_spin(random_engine);
+    EXPECT_NEAR(a.calc_energy(spins), b.calc_energy(spins), 1e-8);
+    EXPECT_NEAR(a.calc_energy(spins), c.calc_energy(spins), 1e-8);
+
+    //not representable
+    EXPECT_THROW((QuantizedDense<std::int8_t, double>(a, 0.5)), std::invalid_argument);
+    EXPECT_THROW((QuantizedSparse<std::int8_t, double>(a, 0.125)), std::out_of_range);
+}
+
+TEST(Graph, QuantizedGraphWithLargeFieldsCheck){
+    using namespace openjij::graph;
+    using namespace openjij;
+
+    //fields beyond the range of the int32 accumulator of int8 couplings
+    std::size_t N = 8;
+    Sparse<double> a(N);
+    for(std::size_t i=0; i<N; i++){
+        a.h(i) = 3e9 + i;
+        for(std::size_t j=i+1; j<N; j++){
+            a.J(i, j) = (i+j)%2 ? 127 : -128;
+        }
+    }
+
+    const QuantizedDense<std::int8_t, double> b(a);
+    const QuantizedSparse<std::int8_t, double> c(a);
+    const Spins spins(N, 1);
+    EXPECT_EQ(a.calc_energy(spins), b.calc_energy(spins));
+    EXPECT_EQ(a.calc_energy(spins), c.calc_energy(spins));
+    EXPECT_EQ(static_cast<QuantizedField>(3e9) + 127*4 - 128*3, b.local_field(0, spins));
+    EXPECT_EQ(b.local_field(0, spins), c.local_field(0, spins));
+}
+
+TEST(Graph, ReorderedSparseGraphCheck){
+    using namespace openjij::graph;
+    using namespace openjij;
+
+    //square lattice with shuffled labels
+    const std::size_t L = 20;
+    const std::size_t N = L*L;
+    std::vector<Index> label(N);
+    std::iota(label.begin(), label.end(), 0);
+    auto r = utility::Xorshift(1234);
+    std::shuffle(label.begin(), label.end(), r);
+
+    Sparse<double> a(N, 5);
+    auto urd = std::uniform_real_distribution<>{-10, 10};
+    for(std::size_t x=0; x<L; x++){
+        for(std::size_t y=0; y<L; y++){
+            const Index i = label[x*L+y];
+            a.J(i, i) = urd(r);
+            if(x+1 < L) a.J(i, label[(x+1)*L+y]) = urd(r);
+            if(y+1 < L) a.J(i, label[x*L+y+1]) = urd(r);
+        }
+    }
+
+    auto bandwidth = [N](const Sparse<double>& g){
+        std::size_t ret = 0;
+        for(std::size_t i=0; i<N; i++){
+            for(auto&& j : g.adj_nodes(i)){
+                ret = std::max(ret, (i > j) ? i-j : j-i);
+            }
+        }
+        return ret;
+    };
+
+    const ReorderedSparse<double> b(a);
+    EXPECT_LE(bandwidth(b), 2*L);
+    EXPECT_LT(bandwidth(b), bandwidth(a));
+
+    const auto& order = b.get_order();
+    for(std::size_t k=0; k<N; k++){
+        for(auto&& l : b.adj_nodes(k)){
+            EXPECT_EQ(b.J(k, l), a.J(order[k], order[l]));
+        }
+    }
+
+    auto random_engine = std::mt19937(1);
+    const Spins spins = a.gen_spin(random_engine);
+    EXPECT_EQ(b.to_original(b.to_reordered(spins)), spins);
+    EXPECT_NEAR(a.calc_energy(spins), b.calc_energy(b.to_reordered(spins)), 1e-8);
+
+    EXPECT_THROW((ReorderedSparse<double>(a, std::vector<Index>(N, 0))), std::invalid_argument);
+}
+
+TEST(Graph, ChimeraCouplingsCheck){
+    using namespace openjij::graph;
+    using namespace openjij;
+
+    auto r = utility::Xorshift(1234);
+    auto urd = std::uniform_real_distribution<>{-10, 10};
+    auto random_engine = std::mt19937(1);
+
+    //small lattices include coinciding and self neighbors
+    for(auto&& shape : std::vector<std::pair<std::size_t, std::size_t>>{{1, 1}, {2, 1}, {2, 2}, {3, 4}}){
+        Chimera<double> a(shape.first, shape.second);
+        for(std::size_t i=0; i<a.get_num_spins(); i++){
+            for(auto&& j : a.adj_nodes(i)){
+                if(i <= j) a.Sparse<double>::J(i, j) = urd(r);
+            }
+        }
+
+        const ChimeraCouplings<double> b(a);
+        const Spins spins = a.gen_spin(random_engine);
+        for(std::size_t i=0; i<a.get_num_spins(); i++){
+            double local_field = 0;
+            for(auto&& j : a.adj_nodes(i)){
+                local_field += (i == j) ? a.Sparse<double>::h(i) : a.Sparse<double>::J(i, j) * spins[j];
+            }
+            EXPECT_NEAR(b.local_field(i, spins), local_field, 1e-10);
+        }
+    }
+}
+
+TEST(Graph, SquareCouplingsCheck){
+    using namespace openjij::graph;
+    using namespace openjij;
+
+    auto r = utility::Xorshift(1234);
+    auto urd = std::uniform_real_distribution<>{-10, 10};
+    auto random_engine = std::mt19937(1);
+
+    //small lattices include coinciding and self neighbors
+    for(auto&& shape : std::vector<std::pair<std::size_t, std::size_t>>{{1, 1}, {2, 1}, {2, 3}, {5, 7}}){
+        Square<double> a(shape.first, shape.second);
+        for(std::size_t i=0; i<a.get_num_spins(); i++){
+            for(auto&& j : a.adj_nodes(i)){
+                if(i <= j) a.J(i, j) = urd(r);
+            }
+        }
+        //periodic bonds
+        for(std::size_t c=0; c<a.get_num_column(); c++){
+            if(a.get_num_row() > 2) a.J(0, c, Dir::MINUS_R) = urd(r);
+        }
+
+        const SquareCouplings<double> b(a);
+        const Spins spins = a.gen_spin(random_engine);
+        for(std::size_t i=0; i<a.get_num_spins(); i++){
+            double local_field = 0;
+            for(auto&& j : a.adj_nodes(i)){
+                local_field += (i == j) ? a.h(i) : a.J(i, j) * spins[j];
+            }
+            EXPECT_NEAR(b.local_field(a.to_rc(i).first, a.to_rc(i).second, spins), local_field, 1e-10);
+        }
+    }
+}
+
+TEST(Graph, KingGraphCouplingsCheck){
+    using namespace openjij::graph;
+    using namespace openjij;
+
+    auto r = utility::Xorshift(1234);
+    auto urd = std::uniform_real_distribution<>{-10, 10};
+    auto random_engine = std::mt19937(1);
+
+    for(auto&& shape : std::vector<std::pair<std::size_t, std::size_t>>{{1, 1}, {1, 4}, {3, 2}, {5, 7}, {6, 8}}){
+        KingGraph<double> a(shape.first, shape.second);
+        for(std::size_t i=0; i<a.get_num_spins(); i++){
+            for(auto&& j : a.adj_nodes(i)){
+                if(i <= j) a.J(i, j) = urd(r);
+            }
+        }
+        //bonds are shared by both ends
+        if(a.get_num_row() > 1 && a.get_num_column() > 1){
+            EXPECT_EQ(a.J(0, 0, KingDir::PLUS_R_PLUS_C), a.J(1, 1, KingDir::MINUS_R_MINUS_C));
+            EXPECT_EQ(a.J(0, 1, KingDir::PLUS_R_MINUS_C), a.J(1, 0, KingDir::MINUS_R_PLUS_C));
+        }
+
+        const KingCouplings<double> b(a);
+        const Spins spins = a.gen_spin(random_engine);
+        std::vector<double> fields(a.get_num_column());
+        for(std::size_t row=0; row<a.get_num_row(); row++){
+            for(std::size_t c_begin=0; c_begin<2; c_begin++){
+                b.row_local_fields(row, c_begin, spins, fields.data());
+                for(std::size_t c=c_begin, k=0; c<a.get_num_column(); c+=2, k++){
+                    const Index i = a.to_ind(row, c);
+                    double local_field = 0;
+                    for(auto&& j : a.adj_nodes(i)){
+                        local_field += (i == j) ? a.h(i) : a.J(i, j) * spins[j];
+                    }
+                    EXPECT_NEAR(b.local_field(row, c, spins), local_field, 1e-10);
+                    EXPECT_NEAR(fields[k], local_field, 1e-10);
+                }
+            }
+        }
+    }
+}
+
+TEST(Graph, LatticeCheck){
+    using namespace openjij::graph;
+    using namespace openjij;
+
+    auto r = utility::Xorshift(1234);
+    auto urd = std::uniform_real_distribution<>{-10, 10};
+    auto random_engine = std::mt19937(1);
+
+    //periodic King's graph with next-nearest neighbors along the columns (margin 2 in the last dimension)
+    using Stencil = Lattice<double, 2, Offset<1, 0>, Offset<0, 1>, Offset<1, 1>, Offset<1, -1>, Offset<0, 2>>;
+    Stencil a(Stencil::Coordinate{{4, 7}});
+    EXPECT_EQ(a.get_num_spins(), 28);
+    EXPECT_EQ(a.get_margin()[1], 2);
+    for(std::size_t i=0; i<a.get_num_spins(); i++){
+        EXPECT_EQ(a.to_ind(a.to_coord(i)), i);
+        EXPECT_EQ(a.backward(a.forward(i, 4), 4), i);
+        a.h(i) = urd(r);
+        for(std::size_t k=0; k<Stencil::num_offsets; k++){
+            a.J(a.to_coord(i), k) = urd(r);
+        }
+    }
+    EXPECT_EQ(a.forward(a.to_ind({{3, 6}}), 2), a.to_ind({{0, 0}}));
+    EXPECT_EQ(a.forward(a.to_ind({{0, 6}}), 4), a.to_ind({{0, 1}}));
+    EXPECT_THROW((Lattice<double, 1, Offset<2>>(Lattice<double, 1, Offset<2>>::Coordinate{{4}})), std::invalid_argument);
+
+    const Spins spins = a.gen_spin(random_engine);
+    double energy = 0;
+    for(std::size_t i=0; i<a.get_num_spins(); i++){
+        double local_field = 0;
+        for(auto&& j : a.adj_nodes(i)){
+            local_field += (i == j) ? a.h(i) : a.J(i, j) * spins[j];
+            if(i < j) energy += a.J(i, j) * spins[i] * spins[j];
+        }
+        energy += a.h(i) * spins[i];
+        EXPECT_NEAR(a.local_field(a.to_coord(i), spins), local_field, 1e-10);
+    }
+    EXPECT_NEAR(a.calc_energy(spins), energy, 1e-10);
+
+    //no wrapping away from the boundary
+    const Index center = a.to_ind({{2, 3}});
+    EXPECT_NEAR(a.interior_local_field(center, spins), a.local_field(a.to_coord(center), spins), 1e-10);
+}
+
+TEST(Graph, ReduceToQuadratic){
+    using namespace openjij;
+
+    //the pair (0, 1) is shared by the three cubic terms and is substituted once
+    {
+        const auto reduced = graph::reduce_to_quadratic(graph::Polynomial<double>(5, {{0, 1, 2}, {0, 1, 3}, {1, 0, 4}}, {1.0, -1.0, 0.5}), graph::Vartype::BINARY);
+        ASSERT_EQ(reduced.aux_pairs.size(), 1);
+        EXPECT_EQ(reduced.aux_pairs[0], std::make_pair(graph::Index(0), graph::Index(1)));
+    }
+
+    //cubic and quartic terms
+    const std::size_t N = 6;
+    auto r = utility::Xorshift(1234);
+    auto urd = std::uniform_real_distribution<>{-1, 1};
+    std::vector<std::vector<graph::Index>> terms;
+    std::vector<double> coeffs;
+    for(std::size_t i=0; i<N; i++){
+        terms.push_back({i});
+        terms.push_back({i, (i+1)%N});
+        terms.push_back({i, (i+1)%N, (i+2)%N});
+        terms.push_back({i, (i+2)%N, (i+3)%N, (i+4)%N});
+        for(std::size_t k=0; k<4; k++) coeffs.push_back(urd(r));
+    }
+    const graph::Polynomial<double> polynomial(N, terms, coeffs);
+
+    //the same polynomial from flat arrays
+    {
+        std::vector<std::int64_t> term_vars, term_offsets(1, 0);
+        for(auto&& term : terms){
+            term_vars.insert(term_vars.end(), term.begin(), term.end());
+            term_offsets.push_back(term_vars.size());
+        }
+        const graph::Polynomial<double> flat(N, term_vars.data(), term_offsets.data(), coeffs.data(), coeffs.size());
+        EXPECT_EQ(flat.term_offsets(), polynomial.term_offsets());
+        EXPECT_EQ(flat.term_vars(), polynomial.term_vars());
+        EXPECT_EQ(flat.incidence(), polynomial.incidence());
+        EXPECT_EQ(flat.coeffs(), polynomial.coeffs());
+
+        std::swap(term_offsets[1], term_offsets[2]);
+        EXPECT_THROW(graph::Polynomial<double>(N, term_vars.data(), term_offsets.data(), coeffs.data(), coeffs.size()), std::invalid_argument);
+        std::swap(term_offsets[1], term_offsets[2]);
+        term_vars[0] = -1;
+        EXPECT_THROW(graph::Polynomial<double>(N, term_vars.data(), term_offsets.data(), coeffs.data(), coeffs.size()), std::invalid_argument);
+    }
+
+    for(auto&& vartype : {graph::Vartype::SPIN, graph::Vartype::BINARY}){
+        const auto reduced = graph::reduce_to_quadratic(polynomial, vartype);
+        const std::size_t M = reduced.interaction.get_num_spins();
+        ASSERT_EQ(M, N + reduced.aux_pairs.size());
+        ASSERT_LE(M, 20);
+
+        //exhaustive search of the original and the reduced model
+        double min_energy = std::numeric_limits<double>::max();
+        for(std::size_t bits=0; bits < (std::size_t(1) << N); bits++){
+            graph::Spins x(N);
+            for(std::size_t i=0; i<N; i++){
+                const bool up = (bits >> i) & 1;
+                x[i] = up ? 1 : (vartype == graph::Vartype::SPIN ? -1 : 0);
+            }
+            min_energy = std::min(min_energy, polynomial.calc_energy(x));
+        }
+
+        double min_reduced = std::numeric_limits<double>::max();
+        graph::Spins argmin;
+        for(std::size_t bits=0; bits < (std::size_t(1) << M); bits++){
+            graph::Spins spins(M);
+            for(std::size_t i=0; i<M; i++) spins[i] = ((bits >> i) & 1) ? 1 : -1;
+            const double energy = reduced.interaction.calc_energy(spins) + reduced.offset;
+            if(energy < min_reduced){
+                min_reduced = energy;
+                argmin = spins;
+            }
+        }
+
+        EXPECT_NEAR(min_energy, min_reduced, 1e-10);
+        EXPECT_NEAR(min_energy, polynomial.calc_energy(reduced.decode(argmin)), 1e-10);
+    }
+}
+
+TEST(Graph, PackedSpinsCheck){
+    using namespace openjij;
+    auto engine_for_spin = std::mt19937(1);
+    const auto spins = graph::Dense<double>(130).gen_spin(engine_for_spin);
+    auto packed = graph::PackedSpins(spins);
+    EXPECT_EQ(packed.size(), 130);
+    EXPECT_EQ(packed.words().size(), 3);
+    EXPECT_EQ(packed.to_spins(), spins);
+    for(std::size_t i=0; i<spins.size(); i++){
+        EXPECT_EQ(packed.get(i), spins[i]);
+    }
+
+    packed.flip(0);
+    packed.flip(129);
+    EXPECT_EQ(packed.get(0), -spins[0]);
+    EXPECT_EQ(packed.get(129), -spins[129]);
+    packed.set(64, 1);
+    packed.set(65, -1);
+    EXPECT_EQ(packed.get(64), 1);
+    EXPECT_EQ(packed.get(65), -1);
+    //unused bits of the last word are kept cleared
+    EXPECT_EQ(packed.words()[2] >> 2, 0);
+    EXPECT_NE(packed, graph::PackedSpins(spins));
+}
+
+TEST(Graph, BinaryFormatRoundTrip){
+    using namespace openjij::graph;
+    using namespace openjij;
+
+    std::size_t N = 37;
+    Sparse<double> a(N);
+    Dense<double> d(N);
+    auto r = utility::Xorshift(1234);
+    auto urd = std::uniform_real_distribution<>{-10, 10};
+    for(std::size_t i=0; i<N; i++){
+        a.J(i, (i+1)%N) = d.J(i, (i+1)%N) = urd(r);
+        a.J(i, (i+5)%N) = d.J(i, (i+5)%N) = urd(r);
+        a.h(i) = d.h(i) = urd(r);
+    }
+    auto random_engine = std::mt19937(1);
+    const Spins spins = a.gen_spin(random_engine);
+
+    //CSR
+    const std::string csr_path = testing::TempDir() + "openjij_csr_graph.bin";
+    const CSRSparse<double> csr(a);
+    save_binary(csr, csr_path);
+    {
+        const auto loaded = load_csr_sparse<double>(csr_path);
+        //copies share the mapped arrays
+        const auto copied = loaded;
+        EXPECT_EQ(loaded.get_num_spins(), N);
+        EXPECT_EQ(copied.edges(), loaded.edges());
+        for(std::size_t i=0; i<N; i++){
+            EXPECT_EQ(loaded.h(i), csr.h(i));
+            EXPECT_EQ(loaded.degree(i), csr.degree(i));
+            for(auto&& edge : csr.adj_edges(i)){
+                EXPECT_EQ(loaded.J(i, edge.index), edge.value);
+            }
+        }
+        EXPECT_EQ(loaded.calc_energy(spins), csr.calc_energy(spins));
+
+        //systems can use the mapped graph directly
+        auto classical_ising = system::make_classical_ising(spins, loaded);
+        EXPECT_EQ(classical_ising.interaction->edges(), loaded.edges());
+    }
+    //type mismatch
+    EXPECT_THROW(load_csr_sparse<float>(csr_path), std::runtime_error);
+    EXPECT_THROW(load_dense_matrix<double>(csr_path), std::runtime_error);
+
+    //corrupted files: the contents are patched and the loader must reject them
+    const auto corrupt = [](const std::string& src, const std::string& dst, const std::function<void(BinaryHeader&, char*)>& patch){
+        std::ifstream ifs(src, std::ios::binary);
+        std::string bytes((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+        BinaryHeader header;
+        std::memcpy(&header, &bytes[0], sizeof(header));
+        patch(header, &bytes[0]);
+        std::memcpy(&bytes[0], &header, sizeof(header));
+        std::ofstream ofs(dst, std::ios::binary | std::ios::trunc);
+        ofs.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    };
+    using Edge = CSRSparse<double>::Edge;
+    const std::string corrupted_path = testing::TempDir() + "openjij_corrupted_graph.bin";
+    //non-monotonic row offsets
+    corrupt(csr_path, corrupted_path, [](BinaryHeader& header, char* data){
+            auto row_offsets = reinterpret_cast<std::size_t*>(data + header.section_offsets[0]);
+            std::swap(row_offsets[1], row_offsets[2]);
+            row_offsets[1] += 3;
+            });
+    EXPECT_THROW(load_csr_sparse<double>(corrupted_path), std::runtime_error);
+    //edge index out of range
+    corrupt(csr_path, corrupted_path, [N](BinaryHeader& header, char* data){
+            reinterpret_cast<Edge*>(data + header.section_offsets[1])[5].index = N;
+            });
+    EXPECT_THROW(load_csr_sparse<double>(corrupted_path), std::runtime_error);
+    //(num_spins+1)*sizeof(size_t) overflows
+    corrupt(csr_path, corrupted_path, [](BinaryHeader& header, char*){
+            header.num_spins = std::numeric_limits<std::uint64_t>::max()/sizeof(std::size_t) + 1;
+            });
+    EXPECT_THROW(load_csr_sparse<double>(corrupted_path), std::runtime_error);
+    std::remove(csr_path.c_str());
+
+    //Dense
+    const std::string dense_path = testing::TempDir() + "openjij_dense_graph.bin";
+    const DenseMatrix<double> dense(d);
+    save_binary(dense, dense_path);
+    {
+        const auto loaded = load_dense_matrix<double>(dense_path);
+        EXPECT_EQ(loaded.get_stride(), dense.get_stride());
+        for(std::size_t i=0; i<N; i++){
+            EXPECT_EQ(reinterpret_cast<std::uintptr_t>(loaded.row(i))%DenseMatrix<double>::alignment, 0u);
+            for(std::size_t j=0; j<N; j++){
+                EXPECT_EQ(loaded.J(i, j), d.J(i, j));
+            }
+        }
+        EXPECT_EQ(loaded.calc_energy(spins), dense.calc_energy(spins));
+    }
+    //stride smaller than num_spins
+    corrupt(dense_path, corrupted_path, [N](BinaryHeader& header, char*){
+            header.num_elements = N-1;
+            });
+    EXPECT_THROW(load_dense_matrix<double>(corrupted_path), std::runtime_error);
+    //num_spins*stride*sizeof(double) overflows
+    corrupt(dense_path, corrupted_path, [](BinaryHeader& header, char*){
+            header.num_elements = (std::uint64_t(1) << 61) + 8;
+            });
+    EXPECT_THROW(load_dense_matrix<double>(corrupted_path), std::runtime_error);
+    std::remove(corrupted_path.c_str());
+    std::remove(dense_path.c_str());
+
+    EXPECT_THROW(load_dense_matrix<double>(dense_path), std::runtime_error);
+}
+
+TEST(Graph, ParseTextFormats){
+    using namespace openjij::graph;
+
+    //edge list (duplicates are summed up, small blocks and many threads exercise the chunk boundaries)
+    std::ostringstream oss;
+    oss << "# comment\n\n";
+    const std::size_t N = 50;
+    for(std::size_t i=0; i<N; i++){
+        oss << i << " " << i << " " << 0.5*i << "\n";
+        oss << i << " " << (i+1)%N << "\t" << -1.25 << "\r\n";
+    }
+    oss << "3 4 1.0";
+    for(std::size_t num_threads : {1u, 4u}){
+        std::istringstream iss(oss.str());
+        const auto g = parse_sparse<double>(iss, TextFormat::EdgeList, num_threads, 37);
+        EXPECT_EQ(g.get_num_spins(), N);
+        for(std::size_t i=0; i<N; i++){
+            EXPECT_EQ(g.h(i), 0.5*i);
+            EXPECT_EQ(g.J(i, (i+1)%N), (i == 3) ? -0.25 : -1.25);
+        }
+    }
+
+    //Gset (1-origin)
+    {
+        std::istringstream iss("3 2\n1 2 1\n2 3 -1\n");
+        const auto g = parse_sparse<double>(iss, TextFormat::Gset, 2);
+        EXPECT_EQ(g.get_num_spins(), 3u);
+        EXPECT_EQ(g.J(0, 1), 1);
+        EXPECT_EQ(g.J(1, 2), -1);
+    }
+
+    //errors report the position
+    try{
+        std::istringstream iss("0 1 1.0\n1 2 1.0\n\n2 3 x\n3 4 1.0\n");
+        parse_sparse<double>(iss, TextFormat::EdgeList, 3, 8);
+        FAIL();
+    }
+    catch(const ParseError& e){
+        EXPECT_EQ(e.line(), 4u);
+        EXPECT_EQ(e.column(), 5u);
+    }
+    try{
+        std::istringstream iss("3 1\n0 2 1.0\n");
+        parse_sparse<double>(iss, TextFormat::Gset);
+        FAIL();
+    }
+    catch(const ParseError& e){
+        EXPECT_EQ(e.line(), 2u);
+    }
+}
+
 TEST(Graph, EnergyCheck){
     using namespace openjij::graph;
     std::size_t N = 500;
@@ -224,23 +929,667 @@ TEST(ClassicalIsing, GenerateTheSameEigenObject){
     d.J(1,1) = s.J(1,1) = 5;
     d.J(2,2) = s.J(2,2) = 10;
 
-    auto engine_for_spin = std::mt19937(1);
-    auto cl_dense = system::make_classical_ising<true>(d.gen_spin(engine_for_spin), d);
-    auto cl_sparse = system::make_classical_ising<true>(s.gen_spin(engine_for_spin), s);
-    Eigen::MatrixXd m1 = cl_dense.interaction;
-    //convert from sparse to dense
-    Eigen::MatrixXd m2 = cl_sparse.interaction;
-    EXPECT_EQ(m1, m2);
-}
+    auto engine_for_spin = std::mt19937(1);
+    auto cl_dense = system::make_classical_ising<true>(d.gen_spin(engine_for_spin), d);
+    auto cl_sparse = system::make_classical_ising<true>(s.gen_spin(engine_for_spin), s);
+    Eigen::MatrixXd m1 = *cl_dense.interaction;
+    //convert from sparse to dense
+    Eigen::MatrixXd m2 = *cl_sparse.interaction;
+    EXPECT_EQ(m1, m2);
+}
+
+TEST(ClassicalIsing, UpdateInteractionInPlace){
+    using namespace openjij;
+    graph::Dense<double> d(4);
+    graph::Sparse<double> s(4);
+    d.J(2,3) = s.J(2,3) = 4;
+    d.J(1,0) = s.J(1,0) = -2;
+    d.J(1,1) = s.J(1,1) = 5;
+
+    auto engine_for_spin = std::mt19937(1);
+    const auto spin = d.gen_spin(engine_for_spin);
+    auto cl_naive = system::make_classical_ising(spin, s);
+    auto cl_dense = system::make_classical_ising<true>(spin, d);
+    auto cl_sparse = system::make_classical_ising<true>(spin, s);
+    auto tr_sparse = system::make_transverse_ising<true>(spin, s, 1.0, 3);
+
+    graph::Delta<double> delta;
+    delta.set_J(3, 2, -1);   //overwrite
+    delta.set_J(0, 3, 7);    //new bond
+    delta.set_h(2, 3);       //new local field
+    delta.set_h(1, 0.5);
+    delta.set_h(1, -6);      //the last assignment wins
+    EXPECT_EQ(delta.size(), 5);
+
+    delta.apply(d);
+    delta.apply(s);
+    system::update_interaction(cl_naive, delta);
+    system::update_interaction(cl_dense, delta);
+    system::update_interaction(cl_sparse, delta);
+    system::update_interaction(tr_sparse, delta);
+
+    //the same objects as the ones built from the modified graphs
+    const Eigen::MatrixXd expected = *system::make_classical_ising<true>(spin, d).interaction;
+    EXPECT_EQ(Eigen::MatrixXd(*cl_dense.interaction), expected);
+    EXPECT_EQ(Eigen::MatrixXd(*cl_sparse.interaction), expected);
+    EXPECT_EQ(Eigen::MatrixXd(*tr_sparse.interaction), expected);
+    EXPECT_EQ(cl_naive.interaction->calc_energy(spin), d.calc_energy(spin));
+    EXPECT_EQ(cl_naive.interaction->h(1), -6);
+
+    //spins are kept
+    EXPECT_EQ(cl_naive.spin, spin);
+    EXPECT_EQ(result::get_solution(cl_dense), spin);
+
+    delta.clear();
+    EXPECT_TRUE(delta.empty());
+}
+
+TEST(ClassicalIsing, SharedInteraction){
+    using namespace openjij;
+    const auto interaction = generate_interaction<graph::Dense<double>>();
+    const auto shared = system::make_shared_interaction(interaction);
+
+    auto engine_for_spin = std::mt19937(1);
+    auto cl_first = system::make_classical_ising(interaction.gen_spin(engine_for_spin), shared);
+    auto cl_second = system::make_classical_ising(interaction.gen_spin(engine_for_spin), shared);
+    auto tr = system::make_transverse_ising(interaction.gen_spin(engine_for_spin), shared, 1.0, 4);
+    EXPECT_EQ(cl_first.interaction.get(), shared.get());
+    EXPECT_EQ(cl_second.interaction.get(), shared.get());
+    EXPECT_EQ(tr.interaction.get(), shared.get());
+
+    //copies of a system share the interaction
+    auto cl_eigen = system::make_classical_ising<true>(cl_first.spin, interaction);
+    const auto cl_eigen_copy = cl_eigen;
+    EXPECT_EQ(cl_eigen.interaction.get(), cl_eigen_copy.interaction.get());
+    auto ct = system::make_continuous_time_ising(cl_first.spin, interaction, 1.0);
+    const auto ct_copy = ct;
+    EXPECT_EQ(ct.interaction.get(), ct_copy.interaction.get());
+
+    //copy-on-write
+    graph::Delta<double> delta;
+    delta.set_J(0, 1, 10);
+    system::update_interaction(cl_first, delta);
+    system::update_interaction(cl_eigen, delta);
+    EXPECT_NE(cl_first.interaction.get(), shared.get());
+    EXPECT_EQ(cl_first.interaction->J(0, 1), 10);
+    EXPECT_EQ(shared->J(0, 1), interaction.J(0, 1));
+    EXPECT_EQ(cl_second.interaction.get(), shared.get());
+    EXPECT_EQ(cl_eigen.interaction->coeff(0, 1), 10);
+    EXPECT_EQ(cl_eigen_copy.interaction->coeff(0, 1), interaction.J(0, 1));
+
+    //sole owner is updated in place
+    const auto* owned = cl_first.interaction.get();
+    system::update_interaction(cl_first, delta);
+    EXPECT_EQ(cl_first.interaction.get(), owned);
+
+    //interactions not built by make_shared_interaction are never written
+    const auto const_interaction = std::make_shared<const graph::Dense<double>>(interaction);
+    auto cl_const = system::make_classical_ising(cl_first.spin, system::SharedInteraction<graph::Dense<double>>(const_interaction));
+    system::update_interaction(cl_const, delta);
+    EXPECT_NE(cl_const.interaction.get(), const_interaction.get());
+    EXPECT_EQ(const_interaction->J(0, 1), interaction.J(0, 1));
+
+    graph::Dense<double> callers_interaction = interaction;
+    auto cl_borrowed = system::make_classical_ising(cl_first.spin,
+            system::SharedInteraction<graph::Dense<double>>(&callers_interaction, [](const graph::Dense<double>*){}));
+    system::update_interaction(cl_borrowed, delta);
+    EXPECT_NE(cl_borrowed.interaction.get(), &callers_interaction);
+    EXPECT_EQ(cl_borrowed.interaction->J(0, 1), 10);
+    EXPECT_EQ(callers_interaction.J(0, 1), interaction.J(0, 1));
+
+    //the copy is owned and updated in place from then on
+    const auto* detached = cl_borrowed.interaction.get();
+    system::update_interaction(cl_borrowed, delta);
+    EXPECT_EQ(cl_borrowed.interaction.get(), detached);
+}
+
+TEST(ClassicalIsing, PreparedProblem){
+    using namespace openjij;
+    graph::Sparse<double> sparse(4);
+    sparse.J(0, 1) = -2;
+    sparse.J(1, 2) = 0.5;
+    sparse.J(2, 0) = 1;
+    sparse.J(2, 3) = -1;
+    sparse.h(3) = 4;
+
+    const system::PreparedProblem<graph::Sparse<double>> problem(sparse);
+    EXPECT_EQ(problem.get_num_spins(), 4);
+
+    //derived forms are built once and shared by the systems
+    auto engine_for_spin = std::mt19937(1);
+    const auto spin = sparse.gen_spin(engine_for_spin);
+    const auto cl_eigen = system::make_classical_ising<true>(spin, problem);
+    const auto cl_eigen_other = system::make_classical_ising<true>(spin, problem);
+    EXPECT_EQ(cl_eigen.interaction.get(), problem.get_eigen_matrix().get());
+    EXPECT_EQ(cl_eigen_other.interaction.get(), problem.get_eigen_matrix().get());
+    EXPECT_EQ(Eigen::MatrixXd(*cl_eigen.interaction), Eigen::MatrixXd(*system::make_classical_ising<true>(spin, sparse).interaction));
+    EXPECT_EQ(system::make_classical_ising(spin, problem).interaction.get(), problem.get_graph().get());
+    const auto cl_csr = system::make_classical_ising_csr(spin, problem);
+    EXPECT_EQ(cl_csr.interaction.get(), problem.get_csr().get());
+    EXPECT_EQ(cl_csr.interaction->calc_energy(spin), sparse.calc_energy(spin));
+
+    //coloring
+    const auto& coloring = problem.get_coloring();
+    EXPECT_EQ(problem.get_num_colors(), 3);
+    for(std::size_t i = 0; i < 4; i++){
+        for(auto&& j : sparse.adj_nodes(i)){
+            if(i != j){
+                EXPECT_NE(coloring[i], coloring[j]);
+            }
+        }
+    }
+
+    //beta range and degree statistics
+    const auto beta_range = problem.get_beta_range();
+    EXPECT_DOUBLE_EQ(beta_range.first, std::log(2.0) / 5.0);
+    EXPECT_DOUBLE_EQ(beta_range.second, std::log(100.0) / 0.5);
+    const auto& statistics = problem.get_degree_statistics();
+    EXPECT_EQ(statistics.min_degree, 1);
+    EXPECT_EQ(statistics.max_degree, 3);
+    EXPECT_DOUBLE_EQ(statistics.mean_degree, 2.0);
+
+    EXPECT_THROW(system::PreparedProblem<graph::Dense<double>>(graph::Dense<double>(3)).get_beta_range(), std::invalid_argument);
+}
+
+//random cubic polynomial (with linear and quadratic terms)
+openjij::graph::Polynomial<double> generate_polynomial_interaction(std::size_t N){
+    using namespace openjij;
+    auto r = utility::Xorshift(1234);
+    auto urd = std::uniform_real_distribution<>{-1, 1};
+    std::vector<std::vector<graph::Index>> terms;
+    std::vector<double> coeffs;
+    for(std::size_t i=0; i<N; i++){
+        terms.push_back({i});
+        coeffs.push_back(urd(r));
+        terms.push_back({i, (i+1)%N});
+        coeffs.push_back(urd(r));
+        terms.push_back({(i+3)%N, i, (i+1)%N});
+        coeffs.push_back(urd(r));
+    }
+    return graph::Polynomial<double>(N, terms, coeffs);
+}
+
+TEST(ClassicalIsing, PolynomialIncrementalTerms){
+    using namespace openjij;
+    const std::size_t N = 10;
+    const auto interaction = generate_polynomial_interaction(N);
+    EXPECT_EQ(interaction.get_num_terms(), 3*N);
+    //each variable is in 1 linear, 2 quadratic and 3 cubic terms
+    for(std::size_t i=0; i<N; i++){
+        EXPECT_EQ(interaction.incidence_offsets()[i+1] - interaction.incidence_offsets()[i], 6);
+    }
+    EXPECT_THROW((graph::Polynomial<double>(3, {{0, 1, 0}}, {1.0})), std::invalid_argument);
+
+    auto r = utility::Xorshift(5678);
+    auto uid = std::uniform_int_distribution<std::size_t>{0, N-1};
+    for(auto&& vartype : {graph::Vartype::SPIN, graph::Vartype::BINARY}){
+        auto spin = interaction.gen_spin(r);
+        if(vartype == graph::Vartype::BINARY){
+            for(auto&& x : spin) x = (x+1)/2;
+        }
+        auto system = system::make_classical_ising_polynomial(spin, interaction, vartype);
+        for(std::size_t step=0; step<200; step++){
+            const std::size_t i = uid(r);
+            const double before = interaction.calc_energy(system.spin);
+            const double dE = system.energy_difference(i);
+            system.flip(i);
+            EXPECT_NEAR(interaction.calc_energy(system.spin) - before, dE, 1e-10);
+        }
+    }
+}
+
+TEST(ClassicalIsing, CachedLocalFields){
+    using namespace openjij;
+    const std::size_t N = 30;
+    auto r = utility::Xorshift(4321);
+    auto urd = std::uniform_real_distribution<>{-1, 1};
+    graph::Dense<double> d(N);
+    graph::Sparse<double> s(N);
+    for(std::size_t i=0; i<N; i++){
+        d.h(i) = s.h(i) = urd(r);
+        for(std::size_t k=1; k<=2; k++){
+            d.J(i, (i+k)%N) = s.J(i, (i+k)%N) = urd(r);
+        }
+    }
+
+    const auto spin = d.gen_spin(r);
+    auto cl_dense = system::make_classical_ising(spin, d);
+    auto cl_sparse = system::make_classical_ising(spin, s);
+    auto cl_eigen_dense = system::make_classical_ising<true>(spin, d);
+    auto cl_eigen_sparse = system::make_classical_ising<true>(spin, s);
+    EXPECT_FALSE(cl_dense.local_fields_valid);
+
+    //the cached fields and energy follow the flips of the updater
+    auto check = [&](){
+        EXPECT_NEAR(cl_dense.energy, d.calc_energy(cl_dense.spin), 1e-10);
+        EXPECT_NEAR(cl_sparse.energy, s.calc_energy(cl_sparse.spin), 1e-10);
+        EXPECT_NEAR(cl_eigen_dense.energy, d.calc_energy(result::get_solution(cl_eigen_dense)), 1e-10);
+        EXPECT_NEAR(cl_eigen_sparse.energy, s.calc_energy(result::get_solution(cl_eigen_sparse)), 1e-10);
+        for(std::size_t i=0; i<N; i++){
+            double field = d.h(i);
+            for(std::size_t j=0; j<N; j++){
+                if(i != j) field += d.J(i, j) * cl_dense.spin[j];
+            }
+            EXPECT_NEAR(cl_dense.local_field[i], field, 1e-10);
+        }
+    };
+    auto parameter = utility::ClassicalUpdaterParameter(0.5);
+    for(std::size_t step=0; step<20; step++){
+        updater::SingleSpinFlip<decltype(cl_dense)>::update(cl_dense, r, parameter);
+        updater::SingleSpinFlip<decltype(cl_sparse)>::update(cl_sparse, r, parameter);
+        updater::SingleSpinFlip<decltype(cl_eigen_dense)>::update(cl_eigen_dense, r, parameter);
+        updater::SingleSpinFlip<decltype(cl_eigen_sparse)>::update(cl_eigen_sparse, r, parameter);
+        check();
+    }
+
+    //other updaters and in-place updates invalidate the cache
+    updater::SwendsenWang<decltype(cl_dense)>::update(cl_dense, r, parameter);
+    EXPECT_FALSE(cl_dense.local_fields_valid);
+    graph::Delta<double> delta;
+    delta.set_J(0, N/2, 3);
+    delta.set_h(1, -2);
+    delta.apply(d);
+    delta.apply(s);
+    system::update_interaction(cl_dense, delta);
+    system::update_interaction(cl_sparse, delta);
+    system::update_interaction(cl_eigen_dense, delta);
+    system::update_interaction(cl_eigen_sparse, delta);
+    EXPECT_FALSE(cl_sparse.local_fields_valid);
+    EXPECT_FALSE(cl_eigen_sparse.local_fields_valid);
+    for(std::size_t step=0; step<5; step++){
+        updater::SingleSpinFlip<decltype(cl_dense)>::update(cl_dense, r, parameter);
+        updater::SingleSpinFlip<decltype(cl_sparse)>::update(cl_sparse, r, parameter);
+        updater::SingleSpinFlip<decltype(cl_eigen_dense)>::update(cl_eigen_dense, r, parameter);
+        updater::SingleSpinFlip<decltype(cl_eigen_sparse)>::update(cl_eigen_sparse, r, parameter);
+        check();
+    }
+}
+
+TEST(TransverseIsing, ContiguousTrotterSpinsAndCachedLocalFields){
+    using namespace openjij;
+    const auto interaction = generate_interaction<graph::Dense<double>>();
+    const std::size_t N = interaction.get_num_spins();
+    const std::size_t num_trotter_slices = 6;
+    auto r = utility::Xorshift(9753);
+
+    system::TrotterSpins init_trotter_spins(num_trotter_slices);
+    for(auto& spins : init_trotter_spins){
+        spins = interaction.gen_spin(r);
+    }
+
+    //slice-major contiguous storage
+    auto q_naive = system::make_transverse_ising(init_trotter_spins, interaction, 1.0);
+    auto q_eigen = system::make_transverse_ising<true>(init_trotter_spins, interaction, 1.0);
+    EXPECT_EQ(q_naive.trotter_spins.size(), num_trotter_slices);
+    EXPECT_EQ(q_naive.trotter_spins[2].size(), N);
+    EXPECT_EQ(q_naive.trotter_spins.to_trotter_spins(), init_trotter_spins);
+    EXPECT_EQ(q_naive.trotter_spins.data()[3*N + 1], init_trotter_spins[3][1]);
+    EXPECT_THROW(system::make_transverse_ising(system::TrotterSpins{{1, 1}, {1}}, graph::Dense<double>(2), 1.0), std::invalid_argument);
+
+    //the cached local fields follow the flips of the updater
+    auto parameter = utility::TransverseFieldUpdaterParameter(1.0, 0.5);
+    for(std::size_t step=0; step<10; step++){
+        updater::SingleSpinFlip<decltype(q_naive)>::update(q_naive, r, parameter);
+        updater::SingleSpinFlip<decltype(q_eigen)>::update(q_eigen, r, parameter);
+        for(std::size_t t=0; t<num_trotter_slices; t++){
+            for(std::size_t i=0; i<N; i++){
+                double field_naive = interaction.h(i);
+                double field_eigen = interaction.h(i);
+                for(std::size_t j=0; j<N; j++){
+                    if(i == j) continue;
+                    field_naive += interaction.J(i, j) * q_naive.trotter_spins[t][j];
+                    field_eigen += interaction.J(i, j) * q_eigen.trotter_spins(j, t);
+                }
+                EXPECT_NEAR(q_naive.local_field[t*N + i], field_naive, 1e-10);
+                EXPECT_NEAR(q_eigen.local_field(i, t), field_eigen, 1e-10);
+            }
+        }
+    }
+
+    q_naive.reset_spins(init_trotter_spins[0]);
+    EXPECT_FALSE(q_naive.local_fields_valid);
+    EXPECT_EQ(graph::Spins(q_naive.trotter_spins[4]), init_trotter_spins[0]);
+}
+
+//TODO: macro?
+//SingleSpinFlip tests
+
+TEST(SingleSpinFlip, FindTrueGroundState_ClassicalIsing_Dense_NoEigenImpl) {
+    using namespace openjij;
+
+    //generate classical dense system
+    const auto interaction = generate_interaction<graph::Dense<double>>();
+    auto engine_for_spin = std::mt19937(1);
+    const auto spin = interaction.gen_spin(engine_for_spin);
+    auto classical_ising = system::make_classical_ising(spin, interaction); //default: no eigen implementation
+
+    auto random_numder_engine = std::mt19937(1);
+    const auto schedule_list = generate_schedule_list();
+
+    algorithm::Algorithm<updater::SingleSpinFlip>::run(classical_ising, random_numder_engine, schedule_list);
+
+    EXPECT_EQ(get_true_groundstate(), result::get_solution(classical_ising));
+}
+
+TEST(SingleSpinFlip, FindTrueGroundState_ClassicalIsing_Sparse_NoEigenImpl) {
+    using namespace openjij;
+
+    //generate classical dense system
+    const auto interaction = generate_interaction<graph::Sparse<double>>();
+    auto engine_for_spin = std::mt19937(1);
+    const auto spin = interaction.gen_spin(engine_for_spin);
+    auto classical_ising = system::make_classical_ising(spin, interaction); //default: no eigen implementation
+
+    auto random_numder_engine = std::mt19937(1);
+    const auto schedule_list = generate_schedule_list();
+
+    algorithm::Algorithm<updater::SingleSpinFlip>::run(classical_ising, random_numder_engine, schedule_list);
+
+    EXPECT_EQ(get_true_groundstate(), result::get_solution(classical_ising));
+}
+
+TEST(SingleSpinFlip, FindTrueGroundState_ClassicalIsing_CSRSparse_NoEigenImpl) {
+    using namespace openjij;
+
+    //generate classical sparse system and freeze it into CSR layout
+    const auto interaction = graph::CSRSparse<double>(generate_interaction<graph::Sparse<double>>());
+    auto engine_for_spin = std::mt19937(1);
+    const auto spin = interaction.gen_spin(engine_for_spin);
+    auto classical_ising = system::make_classical_ising(spin, interaction); //default: no eigen implementation
+
+    auto random_numder_engine = std::mt19937(1);
+    const auto schedule_list = generate_schedule_list();
+
+    algorithm::Algorithm<updater::SingleSpinFlip>::run(classical_ising, random_numder_engine, schedule_list);
+
+    EXPECT_EQ(get_true_groundstate(), result::get_solution(classical_ising));
+}
+
+TEST(SingleSpinFlip, FindTrueGroundState_ClassicalIsingPacked_CSRSparse) {
+    using namespace openjij;
+
+    //generate classical sparse system with bit-packed spins
+    const auto interaction = graph::CSRSparse<double>(generate_interaction<graph::Sparse<double>>());
+    auto engine_for_spin = std::mt19937(1);
+    const auto spin = interaction.gen_spin(engine_for_spin);
+    auto classical_ising = system::make_classical_ising_packed(spin, interaction);
+
+    auto random_numder_engine = std::mt19937(1);
+    const auto schedule_list = generate_schedule_list();
+
+    algorithm::Algorithm<updater::SingleSpinFlip>::run(classical_ising, random_numder_engine, schedule_list);
+
+    EXPECT_EQ(get_true_groundstate(), result::get_solution(classical_ising));
+}
+
+TEST(SingleSpinFlip, FindTrueGroundState_MultiSpinClassicalIsing_Sparse) {
+    using namespace openjij;
+
+    //random +-J model (with +-J local fields)
+    const std::size_t N = 12;
+    auto r = utility::Xorshift(2468);
+    auto sign = std::uniform_int_distribution<int>{0, 1};
+    graph::Sparse<double> interaction(N);
+    for(std::size_t i=0; i<N; i++){
+        interaction.h(i) = (i%3 == 0) ? 2*sign(r)-1 : 0;
+        for(std::size_t k : {1, 2, 5}){
+            interaction.J(i, (i+k)%N) = 2*sign(r)-1;
+        }
+    }
+
+    //exhaustive search
+    double ground_energy = std::numeric_limits<double>::max();
+    for(std::size_t b=0; b<(std::size_t(1) << N); b++){
+        graph::Spins spins(N);
+        for(std::size_t i=0; i<N; i++) spins[i] = ((b >> i) & 1) ? 1 : -1;
+        ground_energy = std::min(ground_energy, interaction.calc_energy(spins));
+    }
+
+    std::vector<graph::Spins> init_spins;
+    for(std::size_t rep=0; rep<64; rep++){
+        init_spins.push_back(interaction.gen_spin(r));
+    }
+    auto system = system::make_multi_spin_classical_ising(init_spins, interaction);
+    EXPECT_EQ(result::get_solution(system), init_spins);
+
+    auto random_numder_engine = std::mt19937(1);
+    algorithm::Algorithm<updater::SingleSpinFlip>::run(system, random_numder_engine, utility::make_classical_schedule_list(0.1, 100.0, 100, 100));
+
+    //almost all the replicas reach the ground state
+    const auto solutions = result::get_solution(system);
+    EXPECT_EQ(solutions.size(), 64);
+    std::size_t num_ground = 0;
+    for(auto&& spins : solutions){
+        EXPECT_GE(interaction.calc_energy(spins), ground_energy - 1e-10);
+        if(interaction.calc_energy(spins) < ground_energy + 1e-10) num_ground++;
+    }
+    EXPECT_GE(num_ground, 60);
+
+    //interactions with different magnitudes are rejected
+    interaction.J(0, 1) = 0.5;
+    EXPECT_THROW(system::make_multi_spin_classical_ising(init_spins, interaction), std::invalid_argument);
+}
+
+TEST(SingleSpinFlip, FindTrueGroundState_BatchedClassicalIsing_Dense) {
+    using namespace openjij;
+
+    const auto interaction = generate_interaction<graph::Dense<double>>();
+    auto engine_for_spin = std::mt19937(1);
+    std::vector<graph::Spins> init_spins;
+    for(std::size_t r=0; r<10; r++){
+        init_spins.push_back(interaction.gen_spin(engine_for_spin));
+    }
+    auto batched_ising = system::make_batched_classical_ising(init_spins, interaction);
+    EXPECT_EQ(result::get_solution(batched_ising), init_spins);
+
+    auto random_numder_engine = std::mt19937(1);
+    const auto schedule_list = generate_schedule_list();
+
+    algorithm::Algorithm<updater::SingleSpinFlip>::run(batched_ising, random_numder_engine, schedule_list);
+
+    for(auto&& spins : result::get_solution(batched_ising)){
+        EXPECT_EQ(get_true_groundstate(), spins);
+    }
+}
+
+TEST(SingleSpinFlip, FindTrueGroundState_BatchedClassicalIsing_Sparse) {
+    using namespace openjij;
+
+    const auto interaction = generate_interaction<graph::Sparse<double>>();
+    auto engine_for_spin = std::mt19937(1);
+    std::vector<graph::Spins> init_spins;
+    for(std::size_t r=0; r<10; r++){
+        init_spins.push_back(interaction.gen_spin(engine_for_spin));
+    }
+    auto batched_ising = system::make_batched_classical_ising(init_spins, interaction);
+
+    auto random_numder_engine = std::mt19937(1);
+    const auto schedule_list = generate_schedule_list();
+
+    algorithm::Algorithm<updater::SingleSpinFlip>::run(batched_ising, random_numder_engine, schedule_list);
+
+    for(auto&& spins : result::get_solution(batched_ising)){
+        EXPECT_EQ(get_true_groundstate(), spins);
+    }
+}
+
+TEST(SingleSpinFlip, FindTrueGroundState_ClassicalIsing_DenseMatrix_NoEigenImpl) {
+    using namespace openjij;
+
+    //generate classical dense system with implicit adjacency
+    const auto interaction = graph::DenseMatrix<double>(generate_interaction<graph::Dense<double>>());
+    auto engine_for_spin = std::mt19937(1);
+    const auto spin = interaction.gen_spin(engine_for_spin);
+    auto classical_ising = system::make_classical_ising(spin, interaction); //default: no eigen implementation
+
+    auto random_numder_engine = std::mt19937(1);
+    const auto schedule_list = generate_schedule_list();
+
+    algorithm::Algorithm<updater::SingleSpinFlip>::run(classical_ising, random_numder_engine, schedule_list);
+
+    EXPECT_EQ(get_true_groundstate(), result::get_solution(classical_ising));
+}
+
+TEST(SingleSpinFlip, FindTrueGroundState_ClassicalIsing_QuantizedDense_NoEigenImpl) {
+    using namespace openjij;
+
+    //generate classical dense system with int8 couplings (multiples of 0.1)
+    const auto interaction = graph::QuantizedDense<std::int8_t, double>(generate_interaction<graph::Dense<double>>(), 0.1);
+    auto engine_for_spin = std::mt19937(1);
+    const auto spin = interaction.gen_spin(engine_for_spin);
+    auto classical_ising = system::make_classical_ising(spin, interaction); //default: no eigen implementation
+
+    auto random_numder_engine = std::mt19937(1);
+    const auto schedule_list = generate_schedule_list();
+
+    algorithm::Algorithm<updater::SingleSpinFlip>::run(classical_ising, random_numder_engine, schedule_list);
+
+    EXPECT_EQ(get_true_groundstate(), result::get_solution(classical_ising));
+}
+
+TEST(SingleSpinFlip, FindTrueGroundState_ClassicalIsing_QuantizedSparse_NoEigenImpl) {
+    using namespace openjij;
+
+    //generate classical sparse system with int16 couplings (multiples of 0.1)
+    const auto interaction = graph::QuantizedSparse<std::int16_t, double>(generate_interaction<graph::Sparse<double>>(), 0.1);
+    auto engine_for_spin = std::mt19937(1);
+    const auto spin = interaction.gen_spin(engine_for_spin);
+    auto classical_ising = system::make_classical_ising(spin, interaction); //default: no eigen implementation
+
+    auto random_numder_engine = std::mt19937(1);
+    const auto schedule_list = generate_schedule_list();
+
+    algorithm::Algorithm<updater::SingleSpinFlip>::run(classical_ising, random_numder_engine, schedule_list);
+
+    EXPECT_EQ(get_true_groundstate(), result::get_solution(classical_ising));
+}
+
+TEST(SingleSpinFlip, FindTrueGroundState_ClassicalIsing_ReorderedSparse_NoEigenImpl) {
+    using namespace openjij;
+
+    //generate classical sparse system relabeled by reverse Cuthill-McKee ordering
+    const auto interaction = graph::ReorderedSparse<double>(generate_interaction<graph::Sparse<double>>());
+    auto engine_for_spin = std::mt19937(1);
+    const auto spin = interaction.gen_spin(engine_for_spin);
+    auto classical_ising = system::make_classical_ising(spin, interaction); //default: no eigen implementation
+
+    auto random_numder_engine = std::mt19937(1);
+    const auto schedule_list = generate_schedule_list();
+
+    algorithm::Algorithm<updater::SingleSpinFlip>::run(classical_ising, random_numder_engine, schedule_list);
+
+    //the solution is returned in the original labels
+    EXPECT_EQ(get_true_groundstate(), result::get_solution(classical_ising));
+}
+
+TEST(SingleSpinFlip, FindTrueGroundState_ClassicalIsing_Chimera_NoEigenImpl) {
+    using namespace openjij;
+
+    //generate classical chimera system (per-direction coupling arrays)
+    const auto interaction = generate_chimera_interaction<double>();
+    auto engine_for_spin = std::mt19937(1);
+    const auto spin = interaction.gen_spin(engine_for_spin);
+    auto classical_ising = system::make_classical_ising(spin, interaction); //default: no eigen implementation
+
+    auto random_numder_engine = std::mt19937(1);
+    const auto schedule_list = generate_schedule_list();
+
+    algorithm::Algorithm<updater::SingleSpinFlip>::run(classical_ising, random_numder_engine, schedule_list);
+
+    EXPECT_EQ(get_true_chimera_groundstate(interaction), result::get_solution(classical_ising));
+}
+
+TEST(SingleSpinFlip, FindTrueGroundState_ClassicalIsing_Square_NoEigenImpl) {
+    using namespace openjij;
+
+    //4x4 +-J square lattice (the ground state energy is found by exhaustive search)
+    auto interaction = graph::Square<double>(4, 4);
+    auto r = utility::Xorshift(1234);
+    auto uid = std::uniform_int_distribution<>{0, 1};
+    for(std::size_t i=0; i<interaction.get_num_spins(); i++){
+        for(auto&& j : interaction.adj_nodes(i)){
+            if(i < j) interaction.J(i, j) = 2*uid(r)-1;
+        }
+    }
+
+    double min_energy = std::numeric_limits<double>::max();
+    graph::Spins spins(interaction.get_num_spins());
+    for(std::size_t bits=0; bits < (std::size_t(1) << spins.size()); bits++){
+        for(std::size_t i=0; i<spins.size(); i++){
+            spins[i] = ((bits >> i) & 1) ? 1 : -1;
+        }
+        min_energy = std::min(min_energy, interaction.calc_energy(spins));
+    }
+
+    auto engine_for_spin = std::mt19937(1);
+    const auto spin = interaction.gen_spin(engine_for_spin);
+    auto classical_ising = system::make_classical_ising(spin, interaction); //default: no eigen implementation
+
+    auto random_numder_engine = std::mt19937(1);
+    const auto schedule_list = generate_schedule_list();
+
+    algorithm::Algorithm<updater::SingleSpinFlip>::run(classical_ising, random_numder_engine, schedule_list);
+
+    EXPECT_EQ(min_energy, interaction.calc_energy(result::get_solution(classical_ising)));
+}
+
+TEST(SingleSpinFlip, FindTrueGroundState_ClassicalIsing_KingGraph_NoEigenImpl) {
+    using namespace openjij;
+
+    //4x5 +-J King's graph (the ground state energy is found by exhaustive search)
+    auto interaction = graph::KingGraph<double>(4, 5);
+    auto r = utility::Xorshift(1234);
+    auto uid = std::uniform_int_distribution<>{0, 1};
+    for(std::size_t i=0; i<interaction.get_num_spins(); i++){
+        for(auto&& j : interaction.adj_nodes(i)){
+            if(i < j) interaction.J(i, j) = 2*uid(r)-1;
+        }
+    }
+
+    double min_energy = std::numeric_limits<double>::max();
+    graph::Spins spins(interaction.get_num_spins());
+    for(std::size_t bits=0; bits < (std::size_t(1) << spins.size()); bits++){
+        for(std::size_t i=0; i<spins.size(); i++){
+            spins[i] = ((bits >> i) & 1) ? 1 : -1;
+        }
+        min_energy = std::min(min_energy, interaction.calc_energy(spins));
+    }
+
+    auto engine_for_spin = std::mt19937(1);
+    const auto spin = interaction.gen_spin(engine_for_spin);
+    auto classical_ising = system::make_classical_ising(spin, interaction); //default: no eigen implementation
+
+    auto random_numder_engine = std::mt19937(1);
+    const auto schedule_list = generate_schedule_list();
 
-//TODO: macro?
-//SingleSpinFlip tests
+    algorithm::Algorithm<updater::SingleSpinFlip>::run(classical_ising, random_numder_engine, schedule_list);
 
-TEST(SingleSpinFlip, FindTrueGroundState_ClassicalIsing_Dense_NoEigenImpl) {
+    EXPECT_EQ(min_energy, interaction.calc_energy(result::get_solution(classical_ising)));
+}
+
+TEST(SingleSpinFlip, FindTrueGroundState_ClassicalIsing_SquareLattice_NoEigenImpl) {
     using namespace openjij;
 
-    //generate classical dense system
-    const auto interaction = generate_interaction<graph::Dense<double>>();
+    //4x4 +-J periodic square lattice (the ground state energy is found by exhaustive search)
+    using Lattice = graph::SquareLattice<double>;
+    auto interaction = Lattice(Lattice::Coordinate{{4, 4}});
+    auto r = utility::Xorshift(1234);
+    auto uid = std::uniform_int_distribution<>{0, 1};
+    for(std::size_t i=0; i<interaction.get_num_spins(); i++){
+        for(std::size_t k=0; k<Lattice::num_offsets; k++){
+            interaction.J(interaction.to_coord(i), k) = 2*uid(r)-1;
+        }
+    }
+
+    double min_energy = std::numeric_limits<double>::max();
+    graph::Spins spins(interaction.get_num_spins());
+    for(std::size_t bits=0; bits < (std::size_t(1) << spins.size()); bits++){
+        for(std::size_t i=0; i<spins.size(); i++){
+            spins[i] = ((bits >> i) & 1) ? 1 : -1;
+        }
+        min_energy = std::min(min_energy, interaction.calc_energy(spins));
+    }
+
     auto engine_for_spin = std::mt19937(1);
     const auto spin = interaction.gen_spin(engine_for_spin);
     auto classical_ising = system::make_classical_ising(spin, interaction); //default: no eigen implementation
@@ -250,14 +1599,18 @@ TEST(SingleSpinFlip, FindTrueGroundState_ClassicalIsing_Dense_NoEigenImpl) {
 
     algorithm::Algorithm<updater::SingleSpinFlip>::run(classical_ising, random_numder_engine, schedule_list);
 
-    EXPECT_EQ(get_true_groundstate(), result::get_solution(classical_ising));
+    EXPECT_EQ(min_energy, interaction.calc_energy(result::get_solution(classical_ising)));
 }
 
-TEST(SingleSpinFlip, FindTrueGroundState_ClassicalIsing_Sparse_NoEigenImpl) {
+TEST(SingleSpinFlip, FindTrueGroundState_ClassicalIsing_CubicLattice_NoEigenImpl) {
     using namespace openjij;
 
-    //generate classical dense system
-    const auto interaction = generate_interaction<graph::Sparse<double>>();
+    //5x4x6 ferromagnet in a positive field (the ground state is all down)
+    auto interaction = graph::CubicLattice<double>({{5, 4, 6}}, -1.0);
+    for(std::size_t i=0; i<interaction.get_num_spins(); i++){
+        interaction.h(i) = 0.5;
+    }
+
     auto engine_for_spin = std::mt19937(1);
     const auto spin = interaction.gen_spin(engine_for_spin);
     auto classical_ising = system::make_classical_ising(spin, interaction); //default: no eigen implementation
@@ -267,7 +1620,41 @@ TEST(SingleSpinFlip, FindTrueGroundState_ClassicalIsing_Sparse_NoEigenImpl) {
 
     algorithm::Algorithm<updater::SingleSpinFlip>::run(classical_ising, random_numder_engine, schedule_list);
 
-    EXPECT_EQ(get_true_groundstate(), result::get_solution(classical_ising));
+    EXPECT_EQ(graph::Spins(interaction.get_num_spins(), -1), result::get_solution(classical_ising));
+}
+
+TEST(SingleSpinFlip, FindTrueGroundState_ClassicalIsingPolynomial) {
+    using namespace openjij;
+
+    const std::size_t N = 10;
+    const auto interaction = generate_polynomial_interaction(N);
+
+    for(auto&& vartype : {graph::Vartype::SPIN, graph::Vartype::BINARY}){
+        //exhaustive search
+        double min_energy = std::numeric_limits<double>::max();
+        graph::Spins spins(N);
+        for(std::size_t bits=0; bits < (std::size_t(1) << N); bits++){
+            for(std::size_t i=0; i<N; i++){
+                const bool up = (bits >> i) & 1;
+                spins[i] = up ? 1 : (vartype == graph::Vartype::SPIN ? -1 : 0);
+            }
+            min_energy = std::min(min_energy, interaction.calc_energy(spins));
+        }
+
+        auto engine_for_spin = std::mt19937(1);
+        auto spin = interaction.gen_spin(engine_for_spin);
+        if(vartype == graph::Vartype::BINARY){
+            for(auto&& x : spin) x = (x+1)/2;
+        }
+        auto system = system::make_classical_ising_polynomial(spin, interaction, vartype);
+
+        auto random_numder_engine = std::mt19937(1);
+        const auto schedule_list = generate_schedule_list();
+
+        algorithm::Algorithm<updater::SingleSpinFlip>::run(system, random_numder_engine, schedule_list);
+
+        EXPECT_NEAR(min_energy, interaction.calc_energy(result::get_solution(system)), 1e-10);
+    }
 }
 
 TEST(SingleSpinFlip, FindTrueGroundState_ClassicalIsing_Dense_WithEigenImpl) {
@@ -352,6 +1739,103 @@ TEST(SingleSpinFlip, FindTrueGroundState_TransverseIsing_Sparse_NoEigenImpl) {
     EXPECT_EQ(get_true_groundstate(), result::get_solution(transverse_ising));
 }
 
+TEST(SingleSpinFlip, FindTrueGroundState_TransverseIsing_ReorderedSparse_NoEigenImpl) {
+    using namespace openjij;
+
+    //generate classical sparse system relabeled by reverse Cuthill-McKee ordering
+    const auto interaction = graph::ReorderedSparse<double>(generate_interaction<graph::Sparse<double>>());
+    auto engine_for_spin = std::mt19937(1);
+    std::size_t num_trotter_slices = 10;
+
+    //generate random trotter spins
+    system::TrotterSpins init_trotter_spins(num_trotter_slices);
+    for(auto& spins : init_trotter_spins){
+        spins = interaction.gen_spin(engine_for_spin);
+    }
+
+    auto transverse_ising = system::make_transverse_ising(init_trotter_spins, interaction, 1.0); //gamma = 1.0
+    
+    auto random_numder_engine = std::mt19937(1);
+    const auto schedule_list = generate_tfm_schedule_list();
+
+    algorithm::Algorithm<updater::SingleSpinFlip>::run(transverse_ising, random_numder_engine, schedule_list);
+
+    EXPECT_EQ(get_true_groundstate(), result::get_solution(transverse_ising));
+}
+
+TEST(SingleSpinFlip, FindTrueGroundState_TransverseIsing_CSRSparse_NoEigenImpl) {
+    using namespace openjij;
+
+    //generate classical sparse system and freeze it into CSR layout
+    const auto interaction = graph::CSRSparse<double>(generate_interaction<graph::Sparse<double>>());
+    auto engine_for_spin = std::mt19937(1);
+    std::size_t num_trotter_slices = 10;
+
+    //generate random trotter spins
+    system::TrotterSpins init_trotter_spins(num_trotter_slices);
+    for(auto& spins : init_trotter_spins){
+        spins = interaction.gen_spin(engine_for_spin);
+    }
+
+    auto transverse_ising = system::make_transverse_ising(init_trotter_spins, interaction, 1.0);
+    
+    auto random_numder_engine = std::mt19937(1);
+    const auto schedule_list = generate_tfm_schedule_list();
+
+    algorithm::Algorithm<updater::SingleSpinFlip>::run(transverse_ising, random_numder_engine, schedule_list);
+
+    EXPECT_EQ(get_true_groundstate(), result::get_solution(transverse_ising));
+}
+
+TEST(SingleSpinFlip, FindTrueGroundState_TransverseIsingPacked_CSRSparse) {
+    using namespace openjij;
+
+    //generate transverse sparse system with bit-packed trotter spins
+    const auto interaction = graph::CSRSparse<double>(generate_interaction<graph::Sparse<double>>());
+    auto engine_for_spin = std::mt19937(1);
+    std::size_t num_trotter_slices = 10;
+
+    //generate random trotter spins
+    system::TrotterSpins init_trotter_spins(num_trotter_slices);
+    for(auto& spins : init_trotter_spins){
+        spins = interaction.gen_spin(engine_for_spin);
+    }
+
+    auto transverse_ising = system::TransverseIsingPacked<graph::CSRSparse<double>>(init_trotter_spins, interaction, 1.0);
+    EXPECT_EQ(transverse_ising.trotter_spins[3].to_spins(), init_trotter_spins[3]);
+
+    auto random_numder_engine = std::mt19937(1);
+    const auto schedule_list = generate_tfm_schedule_list();
+
+    algorithm::Algorithm<updater::SingleSpinFlip>::run(transverse_ising, random_numder_engine, schedule_list);
+
+    EXPECT_EQ(get_true_groundstate(), result::get_solution(transverse_ising));
+}
+
+TEST(SingleSpinFlip, FindTrueGroundState_TransverseIsing_DenseMatrix_NoEigenImpl) {
+    using namespace openjij;
+
+    //generate classical dense system with implicit adjacency
+    const auto interaction = graph::DenseMatrix<double>(generate_interaction<graph::Dense<double>>());
+    auto engine_for_spin = std::mt19937(1);
+    std::size_t num_trotter_slices = 10;
+
+    //generate random trotter spins
+    system::TrotterSpins init_trotter_spins(num_trotter_slices);
+    for(auto& spins : init_trotter_spins){
+        spins = interaction.gen_spin(engine_for_spin);
+    }
+
+    auto transverse_ising = system::make_transverse_ising(init_trotter_spins, interaction, 1.0);
+    
+    auto random_numder_engine = std::mt19937(1);
+    const auto schedule_list = generate_tfm_schedule_list();
+
+    algorithm::Algorithm<updater::SingleSpinFlip>::run(transverse_ising, random_numder_engine, schedule_list);
+
+    EXPECT_EQ(get_true_groundstate(), result::get_solution(transverse_ising));
+}
+
 TEST(SingleSpinFlip, FindTrueGroundState_TransverseIsing_Dense_WithEigenImpl) {
     using namespace openjij;
 
@@ -450,6 +1934,25 @@ TEST(SwendsenWang, FindTrueGroundState_ClassicalIsing_Dense_NoEigenImpl) {
     EXPECT_EQ(get_true_groundstate(), result::get_solution(classical_ising));
 }
 
+TEST(SwendsenWang, FindTrueGroundState_ClassicalIsing_CSRSparse_NoEigenImpl) {
+    using namespace openjij;
+
+    //generate classical sparse system and freeze it into CSR layout
+    const auto interaction = graph::CSRSparse<double>(generate_interaction<graph::Sparse<double>>());
+    auto engine_for_spin = std::mt19937(1);
+    const auto spin = interaction.gen_spin(engine_for_spin);
+    auto classical_ising = system::make_classical_ising(spin, interaction); //default: no eigen implementation
+
+    auto random_numder_engine = std::mt19937(1);
+
+    //in general swendsen wang is not efficient in simulating frustrated systems. We need more annealing time.
+    const auto schedule_list = openjij::utility::make_classical_schedule_list(0.01, 100.0, 100, 3000);
+
+    algorithm::Algorithm<updater::SwendsenWang>::run(classical_ising, random_numder_engine, schedule_list);
+
+    EXPECT_EQ(get_true_groundstate(), result::get_solution(classical_ising));
+}
+
 TEST(SwendsenWang, FindTrueGroundState_ClassicalIsing_Sparse_WithEigenImpl) {
     using namespace openjij;
 
@@ -518,6 +2021,36 @@ TEST(ContinuousTimeSwendsenWang, Place_Cuts_Special_Case) {
     EXPECT_EQ(timeline, correct_timeline);
 }
 
+TEST(ContinuousTimeSwendsenWang, SpinTimelinesArena) {
+    using namespace openjij;
+    using System = system::ContinuousTimeIsing<graph::Dense<double>, false>;
+    using CutPoint = typename System::CutPoint;
+
+    const System::SpinConfiguration spin_config { { {0.0, 1}, {2.0, -1} }, { {1.0, -1} }, { {0.5, 1}, {1.5, -1}, {2.5, 1} } };
+    const auto timelines = System::Timelines(spin_config);
+    EXPECT_EQ(timelines.size(), 3);
+    EXPECT_EQ(timelines.num_points(), 6);
+    EXPECT_EQ(timelines.offsets(), std::vector<std::size_t>({0, 2, 3, 6}));
+    EXPECT_EQ(timelines[2][1], CutPoint(1.5, -1));
+    EXPECT_EQ(timelines.to_spin_configuration(), spin_config);
+
+    //the arena of the timelines is reused over the sweeps
+    const auto interaction = generate_interaction<graph::Dense<double>>();
+    auto engine_for_spin = std::mt19937(1);
+    auto ising = system::make_continuous_time_ising(interaction.gen_spin(engine_for_spin), interaction, 1.0);
+    auto random_numder_engine = std::mt19937(1);
+    const auto parameter = utility::TransverseFieldUpdaterParameter(1.0, 0.5);
+    for(std::size_t sweep = 0; sweep < 20; sweep++){
+        updater::ContinuousTimeSwendsenWang<System>::update(ising, random_numder_engine, parameter);
+        EXPECT_EQ(ising.spin_config.size(), ising.num_spins);
+        for(std::size_t i = 0; i < ising.spin_config.size(); i++){
+            const auto timeline = ising.spin_config[i];
+            EXPECT_GT(timeline.size(), 0);
+            EXPECT_TRUE(std::is_sorted(timeline.begin(), timeline.end()));
+        }
+    }
+}
+
 TEST(ContinuousTimeSwendsenWang, FindTrueGroundState_ContinuousTimeIsing_Dense_OneDimensionalIsing) {
     using namespace openjij;
 
@@ -565,6 +2098,286 @@ TEST(ContinuousTimeSwendsenWang, FindTrueGroundState_ContinuousTimeIsing_Dense_N
     EXPECT_EQ(get_true_groundstate(), result::get_solution(ising));
 }
 
+//checkpoint tests
+
+/**
+ * @brief run the schedule list with checkpoints, abort it in the middle of a schedule and resume it from the checkpoint
+ * (the resumed run starts with the given system and engine in their initial states, as a restarted process would)
+ */
+template<template<typename> class Updater, typename System, typename RandomNumberEngine>
+static void run_interrupted_and_resume(System& system, RandomNumberEngine& random_number_engine,
+        const openjij::utility::ScheduleList<typename openjij::system::get_system_type<System>::type>& schedule_list,
+        std::size_t num_updates_before_interruption){
+    using namespace openjij;
+    using UpdaterParameter = utility::UpdaterParameter<typename system::get_system_type<System>::type>;
+    struct Interruption{};
+
+    const std::string path = testing::TempDir() + "openjij_checkpoint_test.bin";
+    std::remove(path.c_str());
+
+    System interrupted_system = system;
+    RandomNumberEngine interrupted_engine = random_number_engine;
+    std::size_t num_updates = 0;
+    const std::function<void(const System&, const UpdaterParameter&)> interrupt = [&](const System&, const UpdaterParameter&){
+        if(++num_updates == num_updates_before_interruption) throw Interruption();
+    };
+    EXPECT_THROW(algorithm::Algorithm<Updater>::run_with_checkpoint(interrupted_system, interrupted_engine, schedule_list, path, 7, interrupt), Interruption);
+
+    //the resumed run skips the schedules finished before the interruption
+    std::size_t num_resumed_updates = 0;
+    const std::function<void(const System&, const UpdaterParameter&)> count = [&](const System&, const UpdaterParameter&){
+        num_resumed_updates++;
+    };
+    algorithm::Algorithm<Updater>::run_with_checkpoint(system, random_number_engine, schedule_list, path, 7, count);
+    std::size_t num_total_updates = 0;
+    for(auto&& schedule : schedule_list) num_total_updates += schedule.one_mc_step;
+    EXPECT_GT(num_updates_before_interruption + num_resumed_updates, num_total_updates);
+    EXPECT_LT(num_resumed_updates, num_total_updates);
+    std::remove(path.c_str());
+}
+
+TEST(Checkpoint, XorshiftStateRoundTrip) {
+    auto rng = openjij::utility::Xorshift(1234);
+    for(int i=0; i<10; i++) rng();
+
+    std::stringstream ss;
+    ss << rng;
+    auto restored = openjij::utility::Xorshift(1);
+    ss >> restored;
+
+    EXPECT_TRUE(restored == rng);
+    for(int i=0; i<10; i++){
+        EXPECT_EQ(rng(), restored());
+    }
+}
+
+TEST(Checkpoint, ResumeIsBitExact_ClassicalIsing_Sparse_NoEigenImpl) {
+    using namespace openjij;
+
+    const auto interaction = generate_interaction<graph::Sparse<double>>();
+    auto engine_for_spin = std::mt19937(1);
+    const auto spins = interaction.gen_spin(engine_for_spin);
+    const auto schedule_list = generate_schedule_list();
+
+    auto expected = system::make_classical_ising(spins, interaction);
+    auto expected_engine = utility::Xorshift(1);
+    algorithm::Algorithm<updater::SingleSpinFlip>::run(expected, expected_engine, schedule_list);
+
+    auto resumed = system::make_classical_ising(spins, interaction);
+    auto resumed_engine = utility::Xorshift(1);
+    run_interrupted_and_resume<updater::SingleSpinFlip>(resumed, resumed_engine, schedule_list, 3050);
+
+    EXPECT_EQ(expected.spin, resumed.spin);
+    EXPECT_EQ(expected.local_field, resumed.local_field);
+    EXPECT_EQ(expected.energy, resumed.energy);
+    EXPECT_TRUE(expected_engine == resumed_engine);
+}
+
+TEST(Checkpoint, ResumeIsBitExact_ClassicalIsing_Dense_WithEigenImpl) {
+    using namespace openjij;
+
+    const auto interaction = generate_interaction<graph::Dense<double>>();
+    auto engine_for_spin = std::mt19937(1);
+    const auto spins = interaction.gen_spin(engine_for_spin);
+    const auto schedule_list = generate_schedule_list();
+
+    auto expected = system::make_classical_ising<true>(spins, interaction);
+    auto expected_engine = std::mt19937(1);
+    algorithm::Algorithm<updater::SingleSpinFlip>::run(expected, expected_engine, schedule_list);
+
+    auto resumed = system::make_classical_ising<true>(spins, interaction);
+    auto resumed_engine = std::mt19937(1);
+    run_interrupted_and_resume<updater::SingleSpinFlip>(resumed, resumed_engine, schedule_list, 3050);
+
+    EXPECT_EQ(expected.spin, resumed.spin);
+    EXPECT_EQ(expected.local_field, resumed.local_field);
+    EXPECT_TRUE(expected_engine == resumed_engine);
+}
+
+TEST(Checkpoint, ResumeIsBitExact_TransverseIsing_Sparse_NoEigenImpl) {
+    using namespace openjij;
+
+    const auto interaction = generate_interaction<graph::Sparse<double>>();
+    auto engine_for_spin = std::mt19937(1);
+    system::TrotterSpins init_trotter_spins(10);
+    for(auto& spins : init_trotter_spins){
+        spins = interaction.gen_spin(engine_for_spin);
+    }
+    const auto schedule_list = generate_tfm_schedule_list();
+
+    auto expected = system::make_transverse_ising(init_trotter_spins, interaction, 1.0);
+    auto expected_engine = std::mt19937(1);
+    algorithm::Algorithm<updater::SingleSpinFlip>::run(expected, expected_engine, schedule_list);
+
+    auto resumed = system::make_transverse_ising(init_trotter_spins, interaction, 1.0);
+    auto resumed_engine = std::mt19937(1);
+    run_interrupted_and_resume<updater::SingleSpinFlip>(resumed, resumed_engine, schedule_list, 3050);
+
+    EXPECT_EQ(expected.trotter_spins.to_trotter_spins(), resumed.trotter_spins.to_trotter_spins());
+    EXPECT_EQ(expected.local_field, resumed.local_field);
+    EXPECT_TRUE(expected_engine == resumed_engine);
+}
+
+TEST(Checkpoint, ResumeIsBitExact_ContinuousTimeIsing_Dense) {
+    using namespace openjij;
+
+    const auto interaction = generate_interaction<graph::Dense<double>>();
+    auto engine_for_spin = std::mt19937(1);
+    const auto spins = interaction.gen_spin(engine_for_spin);
+    const auto schedule_list = utility::make_transverse_field_schedule_list(10, 1, 50);
+
+    auto expected = system::make_continuous_time_ising(spins, interaction, 1.0);
+    auto expected_engine = std::mt19937(1);
+    algorithm::Algorithm<updater::ContinuousTimeSwendsenWang>::run(expected, expected_engine, schedule_list);
+
+    auto resumed = system::make_continuous_time_ising(spins, interaction, 1.0);
+    auto resumed_engine = std::mt19937(1);
+    run_interrupted_and_resume<updater::ContinuousTimeSwendsenWang>(resumed, resumed_engine, schedule_list, 23);
+
+    EXPECT_EQ(expected.spin_config.to_spin_configuration(), resumed.spin_config.to_spin_configuration());
+    EXPECT_TRUE(expected_engine == resumed_engine);
+}
+
+TEST(Checkpoint, RejectCheckpointOfAnotherRun) {
+    using namespace openjij;
+
+    const auto interaction = generate_interaction<graph::Sparse<double>>();
+    auto engine_for_spin = std::mt19937(1);
+    const auto spins = interaction.gen_spin(engine_for_spin);
+    const auto schedule_list = generate_schedule_list();
+    const std::string path = testing::TempDir() + "openjij_checkpoint_test.bin";
+
+    auto ising = system::make_classical_ising(spins, interaction);
+    const auto fingerprint = algorithm::make_run_fingerprint(ising, std::mt19937(1), schedule_list);
+    auto rng = std::mt19937(1);
+    algorithm::save_checkpoint(path, ising, rng, fingerprint, schedule_list.size(), 3);
+
+    //another seed
+    auto another_rng = std::mt19937(2);
+    EXPECT_NE(fingerprint, algorithm::make_run_fingerprint(ising, another_rng, schedule_list));
+    EXPECT_THROW(algorithm::Algorithm<updater::SingleSpinFlip>::run_with_checkpoint(ising, another_rng, schedule_list, path, 1), std::runtime_error);
+
+    //another schedule list of the same size
+    auto another_schedule_list = schedule_list;
+    another_schedule_list[5].updater_parameter.beta *= 2;
+    EXPECT_NE(fingerprint, algorithm::make_run_fingerprint(ising, std::mt19937(1), another_schedule_list));
+    auto fresh_rng = std::mt19937(1);
+    EXPECT_THROW(algorithm::Algorithm<updater::SingleSpinFlip>::run_with_checkpoint(ising, fresh_rng, another_schedule_list, path, 1), std::runtime_error);
+
+    //another interaction with the same number of spins
+    auto another_interaction = interaction;
+    another_interaction.J(0, 1) += 1.0;
+    auto another_ising = system::make_classical_ising(spins, another_interaction);
+    EXPECT_NE(fingerprint, algorithm::make_run_fingerprint(another_ising, std::mt19937(1), schedule_list));
+    fresh_rng = std::mt19937(1);
+    EXPECT_THROW(algorithm::Algorithm<updater::SingleSpinFlip>::run_with_checkpoint(another_ising, fresh_rng, schedule_list, path, 1), std::runtime_error);
+
+    //another kind of system
+    auto transverse_ising = system::make_transverse_ising(spins, interaction, 1.0, 4);
+    EXPECT_THROW(algorithm::load_checkpoint(path, transverse_ising, rng, fingerprint, schedule_list.size()), std::runtime_error);
+
+    //another number of spins
+    auto small_interaction = graph::Sparse<double>(spins.size()-1);
+    auto small_ising = system::make_classical_ising(graph::Spins(spins.size()-1, 1), small_interaction);
+    EXPECT_THROW(algorithm::load_checkpoint(path, small_ising, rng, fingerprint, schedule_list.size()), std::runtime_error);
+
+    EXPECT_EQ(3u, algorithm::load_checkpoint(path, ising, rng, fingerprint, schedule_list.size()));
+    std::remove(path.c_str());
+}
+
+TEST(Checkpoint, FingerprintOfEigenInteraction) {
+    using namespace openjij;
+
+    const auto interaction = generate_interaction<graph::Dense<double>>();
+    auto engine_for_spin = std::mt19937(1);
+    const auto spins = interaction.gen_spin(engine_for_spin);
+    const auto schedule_list = generate_schedule_list();
+
+    const auto ising = system::make_classical_ising<true>(spins, interaction);
+    const auto fingerprint = algorithm::make_run_fingerprint(ising, std::mt19937(1), schedule_list);
+    EXPECT_EQ(fingerprint, algorithm::make_run_fingerprint(system::make_classical_ising<true>(spins, interaction), std::mt19937(1), schedule_list));
+
+    auto another_interaction = interaction;
+    another_interaction.h(0) += 1.0;
+    const auto another_ising = system::make_classical_ising<true>(spins, another_interaction);
+    EXPECT_NE(fingerprint, algorithm::make_run_fingerprint(another_ising, std::mt19937(1), schedule_list));
+}
+
+TEST(Checkpoint, RejectLocalFieldsOfAnotherShape) {
+    using namespace openjij;
+
+    const auto interaction = generate_interaction<graph::Sparse<double>>();
+    auto engine_for_spin = std::mt19937(1);
+    const auto spins = interaction.gen_spin(engine_for_spin);
+
+    //naive implementation
+    auto corrupted = system::make_classical_ising(spins, interaction);
+    corrupted.refresh_local_fields();
+    corrupted.local_field.resize(spins.size()-1);
+    std::stringstream naive_state;
+    system::save_state(naive_state, corrupted);
+
+    auto ising = system::make_classical_ising(spins, interaction);
+    ising.refresh_local_fields();
+    EXPECT_THROW(system::load_state(naive_state, ising), std::runtime_error);
+    EXPECT_FALSE(ising.local_fields_valid);
+
+    //Eigen implementation
+    auto corrupted_eigen = system::make_classical_ising<true>(spins, interaction);
+    corrupted_eigen.refresh_local_fields();
+    corrupted_eigen.local_field.resize(spins.size());
+    std::stringstream eigen_state;
+    system::save_state(eigen_state, corrupted_eigen);
+
+    auto eigen_ising = system::make_classical_ising<true>(spins, interaction);
+    eigen_ising.refresh_local_fields();
+    EXPECT_THROW(system::load_state(eigen_state, eigen_ising), std::runtime_error);
+    EXPECT_FALSE(eigen_ising.local_fields_valid);
+}
+
+TEST(Checkpoint, RejectCorruptedTimelinesWithoutModifyingTheSystem) {
+    using namespace openjij;
+
+    const auto interaction = generate_interaction<graph::Dense<double>>();
+    auto engine_for_spin = std::mt19937(1);
+    const auto spins = interaction.gen_spin(engine_for_spin);
+
+    auto saved = system::make_continuous_time_ising(spins, interaction, 1.0);
+    auto engine = std::mt19937(1);
+    algorithm::Algorithm<updater::ContinuousTimeSwendsenWang>::run(saved, engine, utility::make_transverse_field_schedule_list(10, 1, 5));
+    std::stringstream state;
+    system::save_state(state, saved);
+    const std::string bytes = state.str();
+
+    auto ct = system::make_continuous_time_ising(spins, interaction, 1.0);
+    const auto expected = ct.spin_config.to_spin_configuration();
+    const auto load = [&](const std::string& corrupted){
+        std::stringstream ss(corrupted);
+        EXPECT_THROW(system::load_state(ss, ct), std::runtime_error);
+        EXPECT_EQ(expected, ct.spin_config.to_spin_configuration());
+    };
+
+    //truncated in the cut points
+    load(bytes.substr(0, bytes.size()-1));
+
+    //huge number of cut points (last offset) without the data
+    const std::size_t offsets_begin = sizeof(system::StateKind) + sizeof(std::uint32_t) + sizeof(std::uint64_t);
+    const std::size_t last_offset = offsets_begin + saved.num_spins*sizeof(std::uint64_t);
+    std::string huge = bytes;
+    const std::uint64_t num_points = std::uint64_t(1) << 60;
+    std::memcpy(&huge[last_offset], &num_points, sizeof(num_points));
+    load(huge);
+
+    //empty timeline
+    std::string empty_timeline = bytes;
+    std::memcpy(&empty_timeline[offsets_begin + sizeof(std::uint64_t)], &empty_timeline[offsets_begin], sizeof(std::uint64_t));
+    load(empty_timeline);
+
+    std::stringstream ss(bytes);
+    system::load_state(ss, ct);
+    EXPECT_EQ(saved.spin_config.to_spin_configuration(), ct.spin_config.to_spin_configuration());
+}
+
 // result test
 TEST(RESULT, GetSolutionFromTrotter){
     auto graph = openjij::graph::Dense<float>(4);
@@ -634,6 +2447,46 @@ TEST(RESULT, GetSolutionFromChimera){
     EXPECT_EQ(solution, init_trotter_spins[0]);
 }
 
+TEST(RESULT, CalcEnergiesBatch){
+    using namespace openjij;
+    const std::size_t N = 50;
+    auto r = utility::Xorshift(1234);
+    auto urd = std::uniform_real_distribution<>{-10, 10};
+    auto dense = graph::Dense<double>(N);
+    for(std::size_t i=0; i<N; i++){
+        for(std::size_t j=i; j<N; j++){
+            dense.J(i, j) = urd(r);
+        }
+    }
+    auto sparse = graph::Sparse<double>(N);
+    for(std::size_t i=0; i<N; i++){
+        for(std::size_t j=i; j<N; j++){
+            if((i + j) % 3 == 0) sparse.J(i, j) = dense.J(i, j);
+        }
+    }
+    const auto csr = graph::CSRSparse<double>(sparse);
+
+    //more states than a block of the Dense kernel
+    for(auto&& num_states : {std::size_t(0), std::size_t(1), std::size_t(3), std::size_t(300)}){
+        std::vector<graph::Spins> states(num_states);
+        for(auto&& spins : states) spins = dense.gen_spin(r);
+
+        for(auto&& num_threads : {std::size_t(1), std::size_t(4), std::size_t(0)}){
+            const auto e_dense = result::calc_energies(dense, states, num_threads);
+            const auto e_sparse = result::calc_energies(sparse, states, num_threads);
+            const auto e_csr = result::calc_energies(csr, states, num_threads);
+            ASSERT_EQ(e_dense.size(), num_states);
+            ASSERT_EQ(e_sparse.size(), num_states);
+            ASSERT_EQ(e_csr.size(), num_states);
+            for(std::size_t s=0; s<num_states; s++){
+                EXPECT_NEAR(e_dense[s], dense.calc_energy(states[s]), 1e-10);
+                EXPECT_NEAR(e_sparse[s], sparse.calc_energy(states[s]), 1e-10);
+                EXPECT_NEAR(e_csr[s], sparse.calc_energy(states[s]), 1e-10);
+            }
+        }
+    }
+}
+
 
 //gpu test
 
@@ -188,6 +188,59 @@ class CXXTest(unittest.TestCase):
         return J
 
     
+    def test_Dense_from_numpy(self):
+
+        #dense graph built from a numpy matrix (upper triangle is read)
+        mat = np.zeros((self.size, self.size))
+        for i in range(self.size):
+            for j in range(i, self.size):
+                mat[i, j] = self.dense[i, j]
+
+        for dtype in (np.float64, np.float32):
+            dense = G.Dense(mat.astype(dtype))
+            for i in range(self.size):
+                for j in range(self.size):
+                    self.assertAlmostEqual(dense[i, j], self.dense[i, j], places=5)
+
+    def test_Sparse_from_coo(self):
+
+        #sparse graph built from COO arrays (duplicates are summed up)
+        row, col, value = [], [], []
+        for i in range(self.size):
+            for j in range(i, self.size):
+                row += [i, j]
+                col += [j, i]
+                value += [self.sparse[i, j]/2, self.sparse[i, j]/2]
+
+        sparse = G.Sparse(self.size, np.array(row), np.array(col), np.array(value))
+        for i in range(self.size):
+            for j in range(self.size):
+                self.assertAlmostEqual(sparse[i, j], self.sparse[i, j])
+
+    def test_parse_sparse(self):
+        import os
+        import tempfile
+
+        #edge list file parsed natively
+        fd, path = tempfile.mkstemp(suffix='.txt')
+        with os.fdopen(fd, 'w') as f:
+            f.write('# i j value\n')
+            for i in range(self.size):
+                for j in range(i, self.size):
+                    f.write('{} {} {!r}\n'.format(i, j, self.sparse[i, j]))
+        try:
+            sparse = G.parse_sparse(path, G.TextFormat.EdgeList, 2)
+            for i in range(self.size):
+                for j in range(self.size):
+                    self.assertAlmostEqual(sparse[i, j], self.sparse[i, j])
+
+            with open(path, 'a') as f:
+                f.write('0 1\n')
+            with self.assertRaises(G.ParseError):
+                G.parse_sparse(path)
+        finally:
+            os.remove(path)
+
     def test_SingleSpinFlip_ClassicalIsing_Dense_NoEigenImpl(self):
 
         #classial ising (dense)
@@ -256,6 +309,293 @@ class CXXTest(unittest.TestCase):
         #compare
         self.assertTrue(self.true_groundstate == result_spin)
 
+    def test_SingleSpinFlip_ClassicalIsing_CSRSparse_NoEigenImpl(self):
+
+        #classial ising (sparse graph frozen into CSR layout)
+        csr = G.CSRSparse(self.sparse)
+        system = S.make_classical_ising(csr.gen_spin(self.seed_for_spin), csr)
+
+        #schedulelist
+        schedule_list = U.make_classical_schedule_list(0.1, 100.0, 100, 100)
+
+        #anneal
+        A.Algorithm_SingleSpinFlip_run(system, self.seed_for_mc, schedule_list)
+
+        #result spin
+        result_spin = R.get_solution(system)
+
+        #compare
+        self.assertTrue(self.true_groundstate == result_spin)
+
+    def test_SingleSpinFlip_ClassicalIsingPacked_CSRSparse(self):
+
+        #classial ising with bit-packed spins
+        csr = G.CSRSparse(self.sparse)
+        system = S.make_classical_ising_packed(csr.gen_spin(self.seed_for_spin), csr)
+
+        #schedulelist
+        schedule_list = U.make_classical_schedule_list(0.1, 100.0, 100, 100)
+
+        #anneal
+        A.Algorithm_SingleSpinFlip_run(system, self.seed_for_mc, schedule_list)
+
+        #result spin
+        result_spin = R.get_solution(system)
+
+        #compare
+        self.assertTrue(self.true_groundstate == result_spin)
+        self.assertEqual(system.spin, result_spin)
+
+    def test_SingleSpinFlip_MultiSpinClassicalIsing_Sparse(self):
+
+        #+-J ring (ferromagnetic, ground states: all up or all down)
+        N = 10
+        sparse = G.Sparse(N)
+        for i in range(N):
+            sparse[i, (i+1)%N] = -1
+
+        #64 replicas
+        system = S.make_multi_spin_classical_ising([sparse.gen_spin(seed) for seed in range(64)], sparse)
+
+        #anneal
+        A.Algorithm_SingleSpinFlip_run(system, self.seed_for_mc, U.make_classical_schedule_list(0.1, 100.0, 100, 100))
+
+        #all the replicas are returned
+        solutions = R.get_solution(system)
+        self.assertEqual(len(solutions), 64)
+        self.assertEqual(solutions[0], system.get_replica(0))
+        self.assertTrue(sum(sparse.calc_energy(spins) == -N for spins in solutions) >= 60)
+
+    def test_SingleSpinFlip_BatchedClassicalIsing_Dense(self):
+
+        #5 replicas of the classical ising model
+        system = S.make_batched_classical_ising([self.dense.gen_spin(self.seed_for_spin + r) for r in range(5)], self.dense)
+
+        #anneal all the replicas at once
+        A.Algorithm_SingleSpinFlip_run(system, self.seed_for_mc, U.make_classical_schedule_list(0.1, 100.0, 100, 100))
+
+        #compare
+        for result_spin in R.get_solution(system):
+            self.assertTrue(self.true_groundstate == result_spin)
+
+    def test_SingleSpinFlip_ClassicalIsing_PreparedProblem_Sparse(self):
+
+        #graph and its derived forms are prepared once and shared by the systems
+        problem = S.make_prepared_problem(self.sparse)
+        system = S.make_classical_ising_Eigen(problem.graph.gen_spin(self.seed_for_spin), problem)
+
+        #schedulelist
+        schedule_list = U.make_classical_schedule_list(0.1, 100.0, 100, 100)
+
+        #anneal
+        A.Algorithm_SingleSpinFlip_run(system, self.seed_for_mc, schedule_list)
+
+        #result spin
+        result_spin = R.get_solution(system)
+
+        #compare
+        self.assertTrue(self.true_groundstate == result_spin)
+
+    def test_SingleSpinFlip_ClassicalIsing_QuantizedDense_NoEigenImpl(self):
+
+        #classial ising (int8 couplings in units of 0.1)
+        quantized = G.QuantizedDense8(self.dense, 0.1)
+        system = S.make_classical_ising(quantized.gen_spin(self.seed_for_spin), quantized)
+
+        #schedulelist
+        schedule_list = U.make_classical_schedule_list(0.1, 100.0, 100, 100)
+
+        #anneal
+        A.Algorithm_SingleSpinFlip_run(system, self.seed_for_mc, schedule_list)
+
+        #result spin
+        result_spin = R.get_solution(system)
+
+        #compare
+        self.assertTrue(self.true_groundstate == result_spin)
+
+    def test_SingleSpinFlip_ClassicalIsing_ReorderedSparse_NoEigenImpl(self):
+
+        #classial ising (sparse graph relabeled by reverse Cuthill-McKee ordering)
+        reordered = G.ReorderedSparse(self.sparse)
+        system = S.make_classical_ising(reordered.gen_spin(self.seed_for_spin), reordered)
+
+        #schedulelist
+        schedule_list = U.make_classical_schedule_list(0.1, 100.0, 100, 100)
+
+        #anneal
+        A.Algorithm_SingleSpinFlip_run(system, self.seed_for_mc, schedule_list)
+
+        #result spin (original labels)
+        result_spin = R.get_solution(system)
+
+        #compare
+        self.assertTrue(self.true_groundstate == result_spin)
+
+    def test_SingleSpinFlip_ClassicalIsing_KingGraph_NoEigenImpl(self):
+
+        #classial ising (2x4 ferromagnetic King's graph with positive fields)
+        king_graph = G.KingGraph(2, 4)
+        for c in range(4):
+            king_graph[0, c] = 0.5
+            king_graph[1, c] = 0.5
+            king_graph[0, c, G.KingDir.PLUS_R] = -1.0
+            if c < 3:
+                king_graph[0, c, G.KingDir.PLUS_C] = -1.0
+                king_graph[1, c, G.KingDir.PLUS_C] = -1.0
+                king_graph[0, c, G.KingDir.PLUS_R_PLUS_C] = -1.0
+                king_graph[1, c, G.KingDir.MINUS_R_PLUS_C] = -1.0
+        system = S.make_classical_ising(king_graph.gen_spin(self.seed_for_spin), king_graph)
+
+        #schedulelist
+        schedule_list = U.make_classical_schedule_list(0.1, 100.0, 100, 100)
+
+        #anneal
+        A.Algorithm_SingleSpinFlip_run(system, self.seed_for_mc, schedule_list)
+
+        #result spin
+        result_spin = R.get_solution(system)
+
+        #compare
+        self.assertTrue([-1]*8 == result_spin)
+
+    def test_SingleSpinFlip_ClassicalIsing_CubicLattice_NoEigenImpl(self):
+
+        #classial ising (3x4x5 periodic ferromagnet with positive fields)
+        lattice = G.CubicLattice([3, 4, 5], -1.0)
+        for i in range(lattice.size()):
+            lattice[lattice.to_coord(i)] = 0.5
+        system = S.make_classical_ising(lattice.gen_spin(self.seed_for_spin), lattice)
+
+        #schedulelist
+        schedule_list = U.make_classical_schedule_list(0.1, 100.0, 100, 100)
+
+        #anneal
+        A.Algorithm_SingleSpinFlip_run(system, self.seed_for_mc, schedule_list)
+
+        #result spin
+        result_spin = R.get_solution(system)
+
+        #compare
+        self.assertTrue([-1]*lattice.size() == result_spin)
+
+    def test_update_interaction(self):
+
+        #classial ising
+        system = S.make_classical_ising_Eigen(self.dense.gen_spin(self.seed_for_spin), self.dense)
+
+        #schedulelist
+        schedule_list = U.make_classical_schedule_list(0.1, 100.0, 100, 100)
+
+        #anneal
+        A.Algorithm_SingleSpinFlip_run(system, self.seed_for_mc, schedule_list)
+        self.assertTrue(self.true_groundstate == R.get_solution(system))
+
+        #strong fields along the flipped ground state, followed by a short anneal from the previous state
+        delta = G.Delta()
+        for i in range(self.size):
+            delta[i] = 100.0 * self.true_groundstate[i]
+        S.update_interaction(system, delta)
+        A.Algorithm_SingleSpinFlip_run(system, self.seed_for_mc, U.make_classical_schedule_list(1.0, 10.0, 10, 10))
+
+        #compare
+        self.assertTrue([-s for s in self.true_groundstate] == R.get_solution(system))
+
+    def test_interaction_after_update_interaction(self):
+
+        for make in [S.make_classical_ising, S.make_classical_ising_Eigen]:
+            system = make(self.dense.gen_spin(self.seed_for_spin), self.dense)
+            other = type(system)(system) #shares the interaction
+            interaction = system.interaction
+            J01 = np.array(interaction)[0, 1] if make is S.make_classical_ising_Eigen else interaction[0, 1]
+
+            #the interaction is returned by reference, not copied
+            if make is S.make_classical_ising_Eigen:
+                self.assertTrue(np.shares_memory(interaction, other.interaction))
+
+            #system gets a new interaction and other is the last owner of the old one
+            delta = G.Delta()
+            delta[0, 1] = J01 + 1.0
+            S.update_interaction(system, delta)
+            del other
+
+            #the held interaction still refers to the old one, kept alive by the reference
+            if make is S.make_classical_ising_Eigen:
+                self.assertEqual(np.array(interaction)[0, 1], J01)
+                self.assertEqual(np.array(system.interaction)[0, 1], J01 + 1.0)
+            else:
+                self.assertEqual(interaction[0, 1], J01)
+                self.assertEqual(system.interaction[0, 1], J01 + 1.0)
+
+    def test_SingleSpinFlip_ClassicalIsingPolynomial(self):
+
+        #E = -s0 s1 s2 - s1 s2 s3 + 0.5 s0 (ground energy: -2.5)
+        terms = [[0, 1, 2], [1, 2, 3], [0]]
+        coeffs = [-1.0, -1.0, 0.5]
+        polynomial = G.Polynomial(4, terms, coeffs)
+        self.assertEqual(polynomial.get_num_terms(), 3)
+
+        #exhaustive search
+        min_energy = min(polynomial.calc_energy([1 - 2*((b >> i) & 1) for i in range(4)]) for b in range(16))
+
+        #classical ising with polynomial interactions
+        system = S.make_classical_ising_polynomial([1, 1, 1, 1], polynomial, G.Vartype.SPIN)
+
+        #anneal
+        A.Algorithm_SingleSpinFlip_run(system, self.seed_for_mc, U.make_classical_schedule_list(0.1, 100.0, 100, 100))
+
+        #compare
+        self.assertAlmostEqual(min_energy, polynomial.calc_energy(R.get_solution(system)))
+
+    def test_reduce_to_quadratic(self):
+
+        #cubic terms sharing the pair (0, 1)
+        polynomial = G.Polynomial(4, [[0, 1, 2], [0, 1, 3], [2, 3]], [-1.0, -1.0, 0.5])
+        reduced = G.reduce_to_quadratic(polynomial, G.Vartype.BINARY)
+        self.assertEqual(reduced.aux_pairs, [(0, 1)])
+
+        #exhaustive search
+        min_energy = min(polynomial.calc_energy([(b >> i) & 1 for i in range(4)]) for b in range(16))
+
+        #anneal the reduced model
+        system = S.make_classical_ising(reduced.interaction.gen_spin(self.seed_for_spin), reduced.interaction)
+        A.Algorithm_SingleSpinFlip_run(system, self.seed_for_mc, U.make_classical_schedule_list(0.1, 100.0, 100, 100))
+
+        #compare
+        self.assertAlmostEqual(min_energy, polynomial.calc_energy(reduced.decode(R.get_solution(system))))
+
+    def test_Polynomial_from_flat_arrays(self):
+
+        #E = -s0 s1 s2 - s1 s2 s3 + 0.5 s0
+        polynomial = G.Polynomial(4, [[0, 1, 2], [1, 2, 3], [0]], [-1.0, -1.0, 0.5])
+        flat = G.Polynomial(4, np.array([0, 1, 2, 1, 2, 3, 0]), np.array([0, 3, 6, 7]), np.array([-1.0, -1.0, 0.5]))
+        cubic = G.Polynomial(4, np.array([[0, 1, 2], [1, 2, 3]]), np.array([-1.0, -1.0]))
+        self.assertEqual(flat.get_num_terms(), 3)
+        self.assertEqual(cubic.get_num_terms(), 2)
+
+        for b in range(16):
+            spins = [1 - 2*((b >> i) & 1) for i in range(4)]
+            self.assertAlmostEqual(polynomial.calc_energy(spins), flat.calc_energy(spins))
+            self.assertAlmostEqual(polynomial.calc_energy(spins) - 0.5*spins[0], cubic.calc_energy(spins))
+
+        #the last offset must match the number of variables
+        with self.assertRaises(ValueError):
+            G.Polynomial(4, np.array([0, 1, 2]), np.array([0, 3, 4]), np.array([-1.0, 1.0]))
+
+    def test_calc_energies(self):
+        import numpy as np
+
+        states = np.array([self.dense.gen_spin(seed) for seed in range(10)], dtype=np.int8)
+        energies = R.calc_energies(self.dense, states)
+        self.assertEqual(len(energies), 10)
+        for state, energy in zip(states, energies):
+            self.assertAlmostEqual(energy, self.dense.calc_energy(list(state)))
+
+        csr = G.CSRSparse(self.sparse)
+        energies = R.calc_energies(csr, states, num_threads=2)
+        for state, energy in zip(states, energies):
+            self.assertAlmostEqual(energy, self.sparse.calc_energy(list(state)))
+
     def test_SingleSpinFlip_TransverseIsing_Dense_NoEigenImpl(self):
 
         #transverse ising (dense)